@@ -0,0 +1,186 @@
+#include "bot/bot_client.hpp"
+
+#include <memory>
+#include <stdexcept>
+
+#include "shared/logging.hpp"
+#include "shared/messages.hpp"
+#include "shared/rng.hpp"
+
+// Constructor: connect and register for messages
+BotClient::BotClient(const std::string& serverAddress, int port,
+                     const std::string& playerName, Policy policy,
+                     size_t startPlayers)
+    : client_(serverAddress, port, playerName),
+      policy_(std::move(policy)),
+      startPlayers_(startPlayers),
+      view_(static_cast<size_t>(client_.getPlayerIndex())) {
+  client_.setUpdateCallback([this](std::shared_ptr<const Message> message) {
+    onMessage(std::move(message));
+  });
+}
+
+// Play until the game is over
+std::optional<std::array<std::optional<int>, 4>> BotClient::run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  doneCv_.wait(lock, [this] { return done_; });
+  lock.unlock();
+  client_.disconnect();
+
+  lock.lock();
+  return results_;
+}
+
+// Get number of accepted turns
+size_t BotClient::getTurnsPlayed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return turnsPlayed_;
+}
+
+// Handle a message from the listener thread
+void BotClient::onMessage(std::shared_ptr<const Message> message) {
+  if (!message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!done_) {
+      BD_LOG_WARN("Bot", "Connection to the server lost");
+    }
+    return finish();
+  }
+
+  // The client buffers game messages until the game view is ready
+  if (message->getMessageType() == MessageType::BRDC_GAME_START) {
+    client_.completeTransitionToGame();
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  switch (message->getMessageType()) {
+    case MessageType::BRDC_PLAYER_LIST: {
+      auto* list = static_cast<const PlayerListUpdateMessage*>(message.get());
+      // Like a user in the lobby, get ready once the server listed us
+      if (!readySent_) {
+        readySent_ = true;
+        client_.sendReady();
+        break;
+      }
+      if (startPlayers_ > 0 && !startSent_ && !view_.getState().has_value() &&
+          list->playersList.size() >= startPlayers_ &&
+          client_.areAllPlayersReady()) {
+        BD_LOG_INFO("Bot", "Requesting game start with "
+                               << list->playersList.size() << " players");
+        startSent_ = true;
+        client_.sendStartGame();
+      }
+      break;
+    }
+    case MessageType::BRDC_GAMESTATE_UPDATE: {
+      auto* update = static_cast<const GameStateUpdateMessage*>(message.get());
+      view_.applyGameState(update->gameState, update->sequence);
+      awaitingUpdate_ = false;
+      maybeAct();
+      break;
+    }
+    case MessageType::BRDC_GAMESTATE_DELTA: {
+      auto* delta = static_cast<const GameStateDeltaMessage*>(message.get());
+      // The client only forwards deltas that follow its own state
+      if (!view_.applyGameStateDelta(delta->delta, delta->sequence)) {
+        BD_LOG_WARN("Bot", "Game state delta " << delta->sequence
+                                               << " does not apply");
+        break;
+      }
+      awaitingUpdate_ = false;
+      maybeAct();
+      break;
+    }
+    case MessageType::PRIV_CARDS_DEALT: {
+      auto* dealt = static_cast<const CardsDealtMessage*>(message.get());
+      if (!view_.applyCardsDealt(dealt->cards)) {
+        BD_LOG_WARN("Bot", "Cards dealt before the first game state");
+        break;
+      }
+      maybeAct();
+      break;
+    }
+    case MessageType::RESP_PLAY_CARD:
+    case MessageType::RESP_SKIP_TURN: {
+      auto* response = static_cast<const ServerResponse*>(message.get());
+      if (response->getSuccess()) {
+        view_.turnAccepted(message->getMessageType() ==
+                           MessageType::RESP_SKIP_TURN);
+        rejections_ = 0;
+        ++turnsPlayed_;
+        break;  // Wait for the new game state
+      }
+      BD_LOG_WARN("Bot", "Turn rejected: " << response->getErrorMsg());
+      awaitingUpdate_ = false;
+      if (++rejections_ > 2) {
+        BD_LOG_ERROR("Bot", "Giving up after repeated rejections");
+        return finish();
+      }
+      maybeAct();
+      break;
+    }
+    case MessageType::BRDC_RESULTS: {
+      results_ =
+          static_cast<const GameResultsMessage*>(message.get())->rankings;
+      return finish();
+    }
+    default:
+      break;
+  }
+}
+
+// Play a turn if it is ours
+void BotClient::maybeAct() {
+  if (done_ || awaitingUpdate_ || !view_.isOwnTurn()) {
+    return;
+  }
+  size_t self = view_.getSelf();
+  const BraendiDog::GameState& state = view_.getState().value();
+
+  // After a rejection fall back to the engine's first legal move
+  BraendiDog::Move move;
+  if (rejections_ > 0) {
+    std::vector<BraendiDog::Move> moves = state.computeAllLegalMoves();
+    if (!moves.empty()) {
+      move = moves.front();
+    }
+  } else {
+    move = policy_(state, view_.getSeenCards());
+  }
+
+  awaitingUpdate_ = true;
+  view_.moveSent(move);
+  if (move.getMovements().empty()) {
+    BD_LOG_DEBUG("Bot", "Player " << self << " folds");
+    client_.sendSkipTurn();
+  } else {
+    BD_LOG_DEBUG("Bot", "Player " << self << " plays card "
+                                  << move.getCardID());
+    client_.sendPlayCard(move);
+  }
+}
+
+// Game over or connection lost
+void BotClient::finish() {
+  done_ = true;
+  doneCv_.notify_all();
+}
+
+// Random policy
+BotClient::Policy randomBotPolicy(uint64_t seed) {
+  auto rng = std::make_shared<BraendiDog::Xoshiro256>(seed);
+  return [rng](const BraendiDog::GameState& state, std::span<const size_t>) {
+    std::vector<BraendiDog::Move> moves = state.computeAllLegalMoves();
+    return moves.empty() ? BraendiDog::Move() : moves[rng->below(moves.size())];
+  };
+}
+
+// ISMCTS policy
+BotClient::Policy ismctsBotPolicy(const BraendiDog::IsmctsConfig& config) {
+  auto searcher = std::make_shared<BraendiDog::Ismcts>(config);
+  return [searcher](const BraendiDog::GameState& state,
+                    std::span<const size_t> seenCards) {
+    return searcher->search(state, seenCards).move;
+  };
+}
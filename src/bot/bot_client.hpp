@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "client/client.hpp"
+#include "shared/game.hpp"
+#include "shared/ismcts.hpp"
+#include "shared/player_view.hpp"
+
+/**
+ * @class BotClient
+ * @brief Headless player speaking the regular client protocol.
+ *
+ * Connects like the GUI client, keeps its own GameState from the game state
+ * broadcasts and dealt cards, and answers its turns with a move policy.
+ */
+class BotClient {
+ public:
+  /**
+   * @brief Policy choosing the move of the bot.
+   * @note Receives the bot's view of the state (current player is the bot) and
+   * the cards seen this round. Returns a move without movements to fold.
+   */
+  using Policy = std::function<BraendiDog::Move(const BraendiDog::GameState&,
+                                                std::span<const size_t>)>;
+
+  /**
+   * @brief Connects to the server, the bot gets ready once it is listed.
+   * @param serverAddress IP address of the server.
+   * @param port Port number to connect to.
+   * @param playerName Name of the bot.
+   * @param policy Move policy.
+   * @param startPlayers Request the game start once this many players are
+   * ready, 0 to wait for someone else to start.
+   * @throws std::runtime_error if connection to the server fails.
+   */
+  BotClient(const std::string& serverAddress, int port,
+            const std::string& playerName, Policy policy,
+            size_t startPlayers = 0);
+
+  /**
+   * @brief Plays until the game ended or the connection dropped.
+   * @return Final rankings, std::nullopt if the game did not finish.
+   */
+  std::optional<std::array<std::optional<int>, 4>> run();
+
+  /**
+   * @brief Gets the number of turns played by the bot.
+   */
+  size_t getTurnsPlayed() const;
+
+ private:
+  Client client_;       ///< Connection using the regular client protocol.
+  Policy policy_;       ///< Move policy.
+  size_t startPlayers_;  ///< Players needed before requesting the start.
+
+  mutable std::mutex mutex_;       ///< Guards the state below.
+  std::condition_variable doneCv_;  ///< Signalled when the game is over.
+  BraendiDog::PlayerView view_;    ///< Local view of the game.
+  bool readySent_ = false;          ///< Ready message sent.
+  bool startSent_ = false;          ///< Start request sent.
+  bool awaitingUpdate_ = false;     ///< Turn sent, waiting for the new state.
+  size_t rejections_ = 0;           ///< Rejected turns in a row.
+  size_t turnsPlayed_ = 0;          ///< Accepted turns.
+  bool done_ = false;               ///< Game over or connection lost.
+  std::optional<std::array<std::optional<int>, 4>>
+      results_;  ///< Final rankings.
+
+  /**
+   * @brief Handles a decoded message from the client listener.
+   * @param message Server message, nullptr if the connection dropped.
+   */
+  void onMessage(std::shared_ptr<const Message> message);
+
+  /**
+   * @brief Plays a turn if it is the bot's turn.
+   * @note Caller holds mutex_.
+   */
+  void maybeAct();
+
+  /**
+   * @brief Marks the bot as done and wakes run().
+   * @note Caller holds mutex_.
+   */
+  void finish();
+};
+
+/**
+ * @brief Policy playing a uniformly random legal move.
+ * @param seed Seed of the policy's generator.
+ */
+BotClient::Policy randomBotPolicy(uint64_t seed);
+
+/**
+ * @brief Policy searching with ISMCTS.
+ * @param config Search budget and tuning.
+ */
+BotClient::Policy ismctsBotPolicy(const BraendiDog::IsmctsConfig& config);
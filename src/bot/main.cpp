@@ -0,0 +1,99 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "bot/bot_client.hpp"
+
+// Function to print usage instructions for running the bot
+void printUsage(const char* programName) {
+  std::cout << "Usage: " << programName
+            << " [--host ADDRESS] [--port PORT] [--name NAME]"
+               " [--policy random|ismcts] [--think-ms MS] [--threads N]"
+               " [--seed S] [--start N]\n"
+            << "  --policy    Move policy (default random)\n"
+            << "  --think-ms  ISMCTS time budget per move (default 200)\n"
+            << "  --threads   ISMCTS search threads, 0 = all cores (default "
+               "1)\n"
+            << "  --start N   Request the game start once N players are "
+               "ready\n"
+            << "Defaults to 127.0.0.1 12345 and the name Bot.\n";
+}
+
+int main(int argc, char* argv[]) {
+  // Defaults
+  std::string serverAddress = "127.0.0.1";
+  int port = 12345;
+  std::string name = "Bot";
+  std::string policyName = "random";
+  BraendiDog::IsmctsConfig config;
+  config.threads = 1;
+  size_t startPlayers = 0;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("Missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--host") {
+        serverAddress = value();
+      } else if (arg == "--port") {
+        port = std::stoi(value());
+      } else if (arg == "--name") {
+        name = value();
+      } else if (arg == "--policy") {
+        policyName = value();
+      } else if (arg == "--think-ms") {
+        config.timeBudget = std::chrono::milliseconds(std::stoul(value()));
+      } else if (arg == "--threads") {
+        config.threads = std::stoul(value());
+      } else if (arg == "--seed") {
+        config.seed = std::stoull(value());
+      } else if (arg == "--start") {
+        startPlayers = std::stoul(value());
+      } else {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+    if (port < 1024 || port > 65535) {
+      throw std::invalid_argument(
+          "Invalid port number. Must be between 1024 and 65535.");
+    }
+
+    BotClient::Policy policy;
+    if (policyName == "random") {
+      policy = randomBotPolicy(config.seed);
+    } else if (policyName == "ismcts") {
+      policy = ismctsBotPolicy(config);
+    } else {
+      throw std::invalid_argument("Unknown policy " + policyName);
+    }
+
+    // Play one game
+    BotClient bot(serverAddress, port, name, policy, startPlayers);
+    auto results = bot.run();
+    if (!results.has_value()) {
+      std::cerr << name << ": game did not finish" << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << name << ": game over after " << bot.getTurnsPlayed()
+              << " turns, rankings";
+    for (const auto& rank : results.value()) {
+      std::cout << " " << (rank.has_value() ? std::to_string(rank.value())
+                                            : std::string("-"));
+    }
+    std::cout << std::endl;
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -1,5 +1,6 @@
 #include "LobbyFrame.hpp"
 
+#include <memory>
 #include <queue>
 #include <string>
 
@@ -42,9 +43,9 @@ LobbyFrame::LobbyFrame(wxWindow* parent, Client* client)
   mainSizer->Add(startGameButton, 0, wxALIGN_CENTER | wxALL, 5);
 
   // Bind the GUI to the client's update callback
-  client->setUpdateCallback([this](const std::string& message) {
+  client->setUpdateCallback([this](std::shared_ptr<const Message> message) {
     wxThreadEvent* evt = new wxThreadEvent(wxEVT_THREAD, wxID_ANY);
-    evt->SetString(message);
+    evt->SetPayload(message);
     wxQueueEvent(this, evt);
   });
 
@@ -62,12 +63,12 @@ void LobbyFrame::OnStartGameButtonClicked(wxCommandEvent& event) {
 
 void LobbyFrame::OnServerUpdate(wxThreadEvent& event) {
   // Process high-level directives passed by `Client`
-  nlohmann::json messageJson =
-      nlohmann::json::parse(event.GetString().ToStdString());
-  std::cout << event.GetString().ToStdString() << "\n";
-
-  auto message = Message::fromJson(messageJson);
+  auto message = event.GetPayload<std::shared_ptr<const Message>>();
+  if (!message) {
+    return;  // Connection dropped
+  }
   MessageType messageType = message->getMessageType();
+  std::cout << messageTypeToString(messageType) << "\n";
 
   switch (messageType) {
     case MessageType::BRDC_PLAYER_LIST: {
@@ -107,7 +108,7 @@ void LobbyFrame::OnServerUpdate(wxThreadEvent& event) {
     }
 
     case MessageType::BRDC_GAME_START: {
-      auto* startMessage = static_cast<GameStartMessage*>(message.get());
+      auto* startMessage = static_cast<const GameStartMessage*>(message.get());
       unsigned numPlayers = startMessage->numPlayers;
       std::cout << "Received BRDC_GAME_START with " << numPlayers << " players"
                 << std::endl
@@ -120,11 +121,12 @@ void LobbyFrame::OnServerUpdate(wxThreadEvent& event) {
       mainGameFrame->SetPosition(currentPos);
 
       // Set up callback
-      client->setUpdateCallback([mainGameFrame](const std::string& msg) {
-        auto evt = new wxThreadEvent(wxEVT_THREAD);
-        evt->SetString(msg);
-        wxQueueEvent(mainGameFrame, evt);
-      });
+      client->setUpdateCallback(
+          [mainGameFrame](std::shared_ptr<const Message> msg) {
+            auto evt = new wxThreadEvent(wxEVT_THREAD);
+            evt->SetPayload(msg);
+            wxQueueEvent(mainGameFrame, evt);
+          });
 
       // Process buffered messages FIRST
       client->completeTransitionToGame();
@@ -141,6 +143,7 @@ void LobbyFrame::OnServerUpdate(wxThreadEvent& event) {
     }
     // These messages shouldn't appear in the lobby context
     case MessageType::BRDC_GAMESTATE_UPDATE:
+    case MessageType::BRDC_GAMESTATE_DELTA:
     case MessageType::BRDC_PLAYER_FINISHED:
     case MessageType::BRDC_RESULTS:
     case MessageType::BRDC_PLAYER_DISCONNECTED:  // Currently not made for lobby
@@ -149,6 +152,9 @@ void LobbyFrame::OnServerUpdate(wxThreadEvent& event) {
     case MessageType::RESP_START_GAME:
     case MessageType::RESP_PLAY_CARD:
     case MessageType::RESP_SKIP_TURN:
+    case MessageType::RESP_LIST_ROOMS:  // The GUI joins rooms via REQ_CONNECT
+    case MessageType::RESP_CREATE_ROOM:
+    case MessageType::RESP_JOIN_ROOM:
       std::cerr << "Unexpected game message in lobby: "
                 << static_cast<int>(messageType) << std::endl;
       break;
@@ -158,6 +164,10 @@ void LobbyFrame::OnServerUpdate(wxThreadEvent& event) {
     case MessageType::REQ_START_GAME:
     case MessageType::REQ_PLAY_CARD:
     case MessageType::REQ_SKIP_TURN:
+    case MessageType::REQ_LIST_ROOMS:
+    case MessageType::REQ_CREATE_ROOM:
+    case MessageType::REQ_JOIN_ROOM:
+    case MessageType::REQ_GAMESTATE:
     case MessageType::RESP_CONNECT: {
       std::cerr << "Invalid client-to-server message received in lobby: "
                 << static_cast<int>(messageType) << std::endl;
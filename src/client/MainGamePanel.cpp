@@ -7,6 +7,7 @@
 #include <array>
 #include <cmath>
 #include <iostream>
+#include <memory>
 #include <optional>
 
 #include "client/client.hpp"
@@ -95,9 +96,9 @@ MainGameFrame::MainGameFrame(const wxString& title, Client* client,
 
     // 8. Set up client callback last
     std::cout << "Setting up client callback..." << std::endl;
-    client->setUpdateCallback([this](const std::string& message) {
+    client->setUpdateCallback([this](std::shared_ptr<const Message> message) {
       auto evt = new wxThreadEvent(wxEVT_THREAD, wxID_ANY);
-      evt->SetString(message);
+      evt->SetPayload(message);
       wxQueueEvent(this, evt);
     });
 
@@ -1077,40 +1078,51 @@ void MainGameFrame::OnMarbleClicked(wxMouseEvent& event) {
 
 void MainGameFrame::OnServerUpdate(wxThreadEvent& event) {
   try {
-    nlohmann::json messageJson =
-        nlohmann::json::parse(event.GetString().ToStdString());
-
-    auto message = Message::fromJson(messageJson);
+    auto message = event.GetPayload<std::shared_ptr<const Message>>();
+    if (!message) {
+      statusText->SetLabel("Connection to the server lost.");
+      return;
+    }
 
     std::cout << "Received message type: "
               << static_cast<int>(message->getMessageType()) << std::endl;
 
     switch (message->getMessageType()) {
       /// GAME STATE UPDATE///
-      case MessageType::BRDC_GAMESTATE_UPDATE: {
-        auto* gsMsg = static_cast<GameStateUpdateMessage*>(message.get());
-        const BraendiDog::GameState& gs = gsMsg->gameState;
-
-        // Update local game state
-        // check if hand is empty before updating
-        // or if player does not exist yet because game just started
-        if (!gameState_.getPlayerByIndex(client->getPlayerIndex())
-                 .has_value() ||
+      case MessageType::BRDC_GAMESTATE_UPDATE:
+      case MessageType::BRDC_GAMESTATE_DELTA: {
+        if (message->getMessageType() == MessageType::BRDC_GAMESTATE_DELTA) {
+          // The client checked the sequence, deltas leave the hand alone
+          auto* deltaMsg =
+              static_cast<const GameStateDeltaMessage*>(message.get());
+          gameState_.applyDelta(deltaMsg->delta);
+          std::cout << "GameState delta applied." << std::endl;
+        } else {
+          auto* gsMsg =
+              static_cast<const GameStateUpdateMessage*>(message.get());
+          const BraendiDog::GameState& gs = gsMsg->gameState;
+
+          // Update local game state
+          // check if hand is empty before updating
+          // or if player does not exist yet because game just started
+          if (!gameState_.getPlayerByIndex(client->getPlayerIndex())
+                   .has_value() ||
+              gameState_.getPlayerByIndex(client->getPlayerIndex())
+                  .value()
+                  .isHandEmpty()) {
+            gameState_ = gs;
+            std::cout << "GameState updated, hand was empty." << std::endl;
+          } else {
+            // take hand from existing gamestate
+            auto hand = gameState_.getPlayerByIndex(client->getPlayerIndex())
+                            .value()
+                            .getHand();
+            gameState_ = gs;
             gameState_.getPlayerByIndex(client->getPlayerIndex())
                 .value()
-                .isHandEmpty()) {
-          gameState_ = gs;
-          std::cout << "GameState updated, hand was empty." << std::endl;
-        } else {
-          // take hand from existing gamestate
-          auto hand = gameState_.getPlayerByIndex(client->getPlayerIndex())
-                          .value()
-                          .getHand();
-          gameState_ = gs;
-          gameState_.getPlayerByIndex(client->getPlayerIndex())
-              .value()
-              .setHand(hand);
-          std::cout << "GameState updated, hand preserved." << std::endl;
+                .setHand(hand);
+            std::cout << "GameState updated, hand preserved." << std::endl;
+          }
         }
 
         panel->Refresh();
@@ -1130,13 +1142,13 @@ void MainGameFrame::OnServerUpdate(wxThreadEvent& event) {
           statusText->SetLabel("Waiting for other players to move...");
         }
 
-        int roundCardCount = gs.getRoundCardCount();
+        int roundCardCount = gameState_.getRoundCardCount();
         UpdateDiceIcon(roundCardCount);
         break;
       }
       /// PRIVATE CARDS DEALT ///
       case MessageType::PRIV_CARDS_DEALT: {
-        auto* dealt = static_cast<CardsDealtMessage*>(message.get());
+        auto* dealt = static_cast<const CardsDealtMessage*>(message.get());
         if (dealt->getPlayerId() ==
             static_cast<size_t>(client->getPlayerIndex())) {
           auto& playerOpt =
@@ -1162,7 +1174,7 @@ void MainGameFrame::OnServerUpdate(wxThreadEvent& event) {
       }
       /// PLAY CARD RESPONSE ///
       case MessageType::RESP_PLAY_CARD: {
-        auto* resp = static_cast<PlayCardResponseMessage*>(message.get());
+        auto* resp = static_cast<const PlayCardResponseMessage*>(message.get());
         if (resp->getSuccess()) {
           statusText->SetLabel("Card played successfully.");
           // Update pop card in local copy of gamestate
@@ -1186,7 +1198,7 @@ void MainGameFrame::OnServerUpdate(wxThreadEvent& event) {
       }
       /// FOLD TURN RESPONSE ///
       case MessageType::RESP_SKIP_TURN: {
-        auto* resp = static_cast<SkipTurnResponseMessage*>(message.get());
+        auto* resp = static_cast<const SkipTurnResponseMessage*>(message.get());
         if (resp->getSuccess()) {
           statusText->SetLabel("Forced to fold for the round.");
 
@@ -1206,7 +1218,7 @@ void MainGameFrame::OnServerUpdate(wxThreadEvent& event) {
       }
       /// BROADCAST if PLAYER FINISHED ///
       case MessageType::BRDC_PLAYER_FINISHED: {
-        auto* finMsg = static_cast<PlayerFinishedMessage*>(message.get());
+        auto* finMsg = static_cast<const PlayerFinishedMessage*>(message.get());
         const size_t pId = finMsg->playerId;
         std::string playerName = getPlayerDisplayName(pId);
         statusText->SetLabel(playerName + " has finished the game!");
@@ -1229,7 +1241,7 @@ void MainGameFrame::OnServerUpdate(wxThreadEvent& event) {
       }
       /// GAME END RESULTS ///
       case MessageType::BRDC_RESULTS: {
-        auto* resMsg = static_cast<GameResultsMessage*>(message.get());
+        auto* resMsg = static_cast<const GameResultsMessage*>(message.get());
         statusText->SetLabel("Game Over!");
         auto& playerOpt = gameState_.getPlayerByIndex(client->getPlayerIndex());
         if (playerOpt.has_value()) playerOpt.value().setHand({});
@@ -1242,7 +1254,8 @@ void MainGameFrame::OnServerUpdate(wxThreadEvent& event) {
       }
       /// DISCONNECTION DETECTION ///
       case MessageType::BRDC_PLAYER_DISCONNECTED: {
-        auto* discMsg = static_cast<PlayerDisconnectedMessage*>(message.get());
+        auto* discMsg =
+            static_cast<const PlayerDisconnectedMessage*>(message.get());
         int id = static_cast<int>(discMsg->playerId);
 
         if (id >= 0 && id <= 3) {
@@ -1,8 +1,9 @@
 #include "client/MovePhaseController.hpp"
 
-#include <iostream>
 #include <stdexcept>
 
+#include "shared/logging.hpp"
+
 MovePhaseController::MovePhaseController(Client* client, size_t myPlayerIndex,
                                          BraendiDog::GameState& gameState)
     : client_(client),
@@ -189,18 +190,12 @@ void MovePhaseController::onBoardPositionClicked(
     size_t moveValue = calculateMoveSteps(currentPos, pos);
     totalSevenMoveValue_ += moveValue;
 
-    std::cout << "DEBUG: clicked pos = (" << static_cast<int>(pos.boardLocation)
-              << ", " << pos.index << ")" << std::endl;
-    std::cout << "DEBUG: calculated moveValue = " << moveValue << std::endl;
-    std::cout << "DEBUG: move has "
-              << matchingMove.value().getMovements().size() << " movements"
-              << std::endl;
-    for (const auto& mv : matchingMove.value().getMovements()) {
-      std::cout << "  Movement: player " << mv.first.playerID << " marble "
-                << mv.first.marbleIdx << " to ("
-                << static_cast<int>(mv.second.boardLocation) << ", "
-                << mv.second.index << ")" << std::endl;
-    }
+    BD_LOG_DEBUG("Client", "Seven part to ("
+                               << static_cast<int>(pos.boardLocation) << ", "
+                               << pos.index << "), " << moveValue
+                               << " steps, "
+                               << matchingMove.value().getMovements().size()
+                               << " movements");
 
     // Append to built Seven move
     if (builtSevenMove_.getMovements().empty()) {
@@ -236,7 +231,7 @@ void MovePhaseController::onBoardPositionClicked(
       return;
     } else if (totalSevenMoveValue_ > 7) {
       // Invalid
-      std::cerr << "Error: Seven move exceeded 7 steps." << std::endl;
+      BD_LOG_ERROR("Client", "Seven move exceeded 7 steps.");
       if (statusCallback) {
         statusCallback("Invalid move: exceeded 7 steps. Selection cleared.");
       }
@@ -253,7 +248,8 @@ void MovePhaseController::onBoardPositionClicked(
 
       // Recompute remaining moves with updated temp state
       if (sevenTempGameState_.has_value()) {
-        sevenMoves_ = sevenTempGameState_->computeLegalMoves(
+        sevenMoves_ = *moveCache_.legalMoves(
+            *sevenTempGameState_,
             std::array<size_t, 3>{syntheticCardID,
                                   static_cast<size_t>(selectedHandIndex_),
                                   static_cast<size_t>(selectedCardID_)},
@@ -311,12 +307,12 @@ void MovePhaseController::filterByCard(int handIndex) {
 
   if (isSevenMove) {
     filteredMoves_ = sevenMoves_;
-    std::cout << "  -> Using sevenMoves_" << std::endl;
+    BD_LOG_TRACE("Client", "Using sevenMoves_");
   } else if (selectedCard.getRank() == BraendiDog::Rank::JOKER) {  // Joker
     filteredMoves_ = jokerMoves_;
-    std::cout << "  -> Using jokerMoves_" << std::endl;
+    BD_LOG_TRACE("Client", "Using jokerMoves_");
   } else {
-    std::cout << "  -> Filtering legalMoves_ by handIndex" << std::endl;
+    BD_LOG_TRACE("Client", "Filtering legalMoves_ by handIndex");
     // filters legal Moves by handIndex
     for (const auto& move : legalMoves_) {
       if (move.getHandIndex() == static_cast<size_t>(handIndex)) {
@@ -327,15 +323,12 @@ void MovePhaseController::filterByCard(int handIndex) {
     }
   }
 
-  std::cout << "  Result: filteredMoves_ size: " << filteredMoves_.size()
-            << std::endl;
-
   if (filteredMoves_.empty()) {
     if (statusCallback) statusCallback("No legal moves for selected card.");
   } else {
     if (statusCallback) statusCallback("Filtered moves by selected card.");
-    std::cout << "After card filter: " << filteredMoves_.size() << " moves"
-              << std::endl;
+    BD_LOG_DEBUG("Client",
+                 "After card filter: " << filteredMoves_.size() << " moves");
   }
 }
 
@@ -358,8 +351,8 @@ bool MovePhaseController::filterByMarble(
   filteredMoves_ = newFiltered;
 
   if (statusCallback) statusCallback("Filtered moves by selected marble.");
-  std::cout << "After marble filter: " << filteredMoves_.size() << " moves"
-            << std::endl;
+  BD_LOG_DEBUG("Client",
+               "After marble filter: " << filteredMoves_.size() << " moves");
 
   return true;
 }
@@ -425,9 +418,11 @@ void MovePhaseController::setJokerRank(int rank, size_t jokerHandIndex) {
   size_t jID = gameState_.getPlayers()[myPlayerIndex_]
                    .value()
                    .getHand()[jokerHandIndex];  // get joker cardID from hand
-  jokerMoves_ = gameState_.computeLegalMoves(std::array<size_t, 3>{
-      selectedCardID, jokerHandIndex,
-      jID});  // Pass joker cardID and hand index and jID (52 or 53)
+  jokerMoves_ = *moveCache_.legalMoves(
+      gameState_,
+      std::array<size_t, 3>{
+          selectedCardID, jokerHandIndex,
+          jID});  // Pass joker cardID and hand index and jID (52 or 53)
 }
 
 int MovePhaseController::getJokerRank() const { return jokerSelectedRank_; }
@@ -449,39 +444,5 @@ size_t MovePhaseController::getTotalSevenMoveValue() const {
 
 size_t MovePhaseController::calculateMoveSteps(
     const BraendiDog::Position& from, const BraendiDog::Position& to) const {
-  // For FINISH area (marble moving within finish)
-  if (from.boardLocation == BraendiDog::BoardLocation::FINISH &&
-      to.boardLocation == BraendiDog::BoardLocation::FINISH) {
-    return to.index - from.index;
-  }
-
-  // For TRACK to FINISH
-  if (from.boardLocation == BraendiDog::BoardLocation::TRACK &&
-      to.boardLocation == BraendiDog::BoardLocation::FINISH) {
-    size_t startIdx =
-        gameState_.getPlayers()[myPlayerIndex_].value().getStartField();
-
-    // Calculate distance to start field
-    size_t distToStart;
-    if (startIdx >= from.index) {
-      distToStart = startIdx - from.index;
-    } else {
-      distToStart = 64 - from.index + startIdx;  // Wrap around
-    }
-
-    // Distance = to start + into finish + 1 (for start field itself)
-    return distToStart + to.index + 1;
-  }
-
-  // For TRACK to TRACK (normal walking)
-  if (from.boardLocation == BraendiDog::BoardLocation::TRACK &&
-      to.boardLocation == BraendiDog::BoardLocation::TRACK) {
-    if (to.index >= from.index) {
-      return to.index - from.index;
-    } else {
-      return 64 - from.index + to.index;  // Wrap around
-    }
-  }
-
-  return 0;
+  return gameState_.sevenSteps(from, to);
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "client/client.hpp"
 #include "shared/game.hpp"
 #include "shared/game_types.hpp"
+#include "shared/transposition_table.hpp"
 
 class MovePhaseController {
  public:
@@ -188,4 +189,8 @@ class MovePhaseController {
       selectedMarble_;     ///< Selected marble
   int jokerSelectedRank_;  ///< The rank selected for a Joker card, -1 if not
                            ///< set
+
+  // Caches
+  BraendiDog::TranspositionTable moveCache_{
+      1 << 20};  ///< Legal moves of Seven splits and Joker ranks
 };
\ No newline at end of file
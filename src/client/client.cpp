@@ -5,12 +5,17 @@
 #include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
 #include <thread>
 
+#include "shared/framing.hpp"
 #include "shared/game_types.hpp"
 #include "shared/messages.hpp"
+#include "shared/wire_format.hpp"
 
 // Constructor: Establishes a connection to the server
 Client::Client(const std::string& serverAddress, const int port,
@@ -25,27 +30,31 @@ Client::Client(const std::string& serverAddress, const int port,
   std::cout << "Connected to Server." << std::endl;
 
   // Send connection request (REQ_CONNECT) and receive response (RESP_CONNECT)
-  ConnectionRequestMessage connReq(playerName);
-  std::string connReqJson = connReq.toJson().dump() + "\n";
-  if (connection.write(connReqJson) != connReqJson.size()) {
+  // Offer the binary format, the request itself is JSON so any server reads it
+  ConnectionRequestMessage connReq(
+      playerName, static_cast<size_t>(BraendiDog::latestWireFormat));
+  std::string connReqFrame =
+      BraendiDog::encodeMessageFrame(connReq, BraendiDog::WireFormat::JSON);
+  if (connection.write(connReqFrame) != connReqFrame.size()) {
     throw std::runtime_error("Failed to send connection request to server");
   }
 
-  // Buffer to receive initial data from server
-  char buf[1024];
-  // Read the response from the server
-  ssize_t n = connection.read(buf, sizeof(buf));
-  if (n <= 0) {
-    throw std::runtime_error("Failed to receive connection response");
+  // Read until the first frame (RESP_CONNECT) is complete
+  std::optional<std::string_view> firstMessage;
+  while (!(firstMessage = inbox_.next())) {
+    auto space = inbox_.prepare();
+    ssize_t n = connection.read(space.data(), space.size());
+    if (n <= 0) {
+      throw std::runtime_error("Failed to receive connection response");
+    }
+    inbox_.commit(n);
+  }
+
+  // Parse
+  auto responseMessage = BraendiDog::decodeMessage(*firstMessage);
+  if (responseMessage->getMessageType() != MessageType::RESP_CONNECT) {
+    throw std::runtime_error("Unexpected connection response");
   }
-  // Extract message (RESP_CONNECT) and handle newline
-  std::string responseStr(buf, n);
-  size_t pos = responseStr.find('\n');
-  std::string firstMessage = responseStr.substr(0, pos);
-
-  // Pars
-  nlohmann::json responseJson = nlohmann::json::parse(firstMessage);
-  auto responseMessage = Message::fromJson(responseJson);
   auto* connResponse =
       static_cast<ConnectionResponseMessage*>(responseMessage.get());
 
@@ -55,15 +64,11 @@ Client::Client(const std::string& serverAddress, const int port,
                              connResponse->getErrorMsg());
   }
   playerIndex = connResponse->playerId;
+  wireFormat_ = BraendiDog::negotiateWireFormat(connResponse->wireFormat);
   std::cout << "Got Player Index: " << playerIndex << std::endl;
 
-  // Handle remaining messages from server (e.g., initial player list)
-  std::string remainder =
-      responseStr.substr(pos + 1);  // everything after first \n
-  if (!remainder.empty()) {
-    // Store remainder for listener thread to process first
-    initialBuffer_ = remainder;
-  }
+  // Frames received after the response (e.g., initial player list) stay in
+  // the buffer for the listener thread
 
   // Start the listener thread to receive messages from the server
   listenerThread = std::thread(&Client::ServerListener, this);
@@ -78,39 +83,36 @@ Client::~Client() {
 
 //// Interface Methods ////
 
+// Close the connection (the blocked read in the listener returns)
+void Client::disconnect() {
+  running = false;
+  connection.shutdown();
+}
+
 // Listener thread function to receive messages from the server
 void Client::ServerListener() {
-  std::string buffer;  // Accumulate data here
-
-  // If there's initial buffered data, process it first
-  if (!initialBuffer_.empty()) {
-    buffer += initialBuffer_;
-    initialBuffer_.clear();
-  }
-
-  char buf[4096];
   while (running) {  // Ensure the thread respects the running flag
     try {
-      // Process complete messages (newline-delimited)
-      size_t pos;
-      while ((pos = buffer.find('\n')) != std::string::npos) {
-        std::string message = buffer.substr(0, pos);
-        buffer.erase(0, pos + 1);  // Remove processed message
-
-        if (!message.empty()) {
-          nlohmann::json receivedJson = nlohmann::json::parse(message);
-          handleServerMessage(receivedJson);
+      // Process complete frames, the payloads are read in place
+      while (auto message = inbox_.next()) {
+        auto parsed = BraendiDog::decodeMessage(*message);
+        MessageType type = parsed->getMessageType();
+        if (type == MessageType::BRDC_GAMESTATE_UPDATE ||
+            type == MessageType::BRDC_GAMESTATE_DELTA) {
+          parsed = syncGameState(std::move(parsed));
+        }
+        if (parsed) {
+          handleServerMessage(std::move(parsed));
         }
       }
 
-      ssize_t n = connection.read(buf, sizeof(buf));
+      auto space = inbox_.prepare();
+      ssize_t n = connection.read(space.data(), space.size());
       if (n <= 0) {
-        notifyUpdate("");  // Notify GUI of a potential disconnect
+        notifyUpdate(nullptr);  // Notify GUI of a potential disconnect
         break;
       }
-
-      // Append new data to buffer
-      buffer.append(buf, n);
+      inbox_.commit(n);
     } catch (const std::exception& ex) {
       std::cerr << "Exception in ServerListener: " << ex.what() << std::endl;
       break;
@@ -121,11 +123,43 @@ void Client::ServerListener() {
   running = false;  // Securely stop the loop
 }
 
+// Apply updates to the local game state, the GUI gets the ones that applied
+std::unique_ptr<Message> Client::syncGameState(
+    std::unique_ptr<Message> message) {
+  if (message->getMessageType() == MessageType::BRDC_GAMESTATE_UPDATE) {
+    auto* update = static_cast<GameStateUpdateMessage*>(message.get());
+    gameState_ = update->gameState;
+    stateSequence_ = update->sequence;
+    resyncRequested_ = false;
+    return message;
+  }
+
+  auto* delta = static_cast<GameStateDeltaMessage*>(message.get());
+  if (gameState_.has_value() && delta->sequence == stateSequence_ + 1) {
+    try {
+      gameState_->applyDelta(delta->delta);
+      stateSequence_ = delta->sequence;
+      return message;
+    } catch (const std::invalid_argument& e) {
+      std::cerr << "Invalid game state delta: " << e.what() << std::endl;
+    }
+  }
+
+  // Missed an update, skip deltas until the full state arrives
+  if (!resyncRequested_) {
+    std::cerr << "Game state delta " << delta->sequence
+              << " does not apply, requesting the full state" << std::endl;
+    resyncRequested_ = true;
+    sendMessage(GameStateRequestMessage(playerIndex));
+  }
+  return nullptr;
+}
+
 // Centralized server message handler
-void Client::handleServerMessage(const nlohmann::json& message) {
+void Client::handleServerMessage(std::shared_ptr<const Message> message) {
   try {
-    auto parsedMessage = Message::fromJson(message);
-    MessageType messageType = parsedMessage->getMessageType();
+    // The GUI gets the decoded message, whatever format the server sends
+    MessageType messageType = message->getMessageType();
 
     // Route based on client state
     switch (state_) {
@@ -136,7 +170,7 @@ void Client::handleServerMessage(const nlohmann::json& message) {
 
       case ClientState::TRANSITIONING:
         // Buffer ALL messages during transition
-        transitionBuffer_.push(message.dump());
+        transitionBuffer_.push(message);
         std::cout << "Buffered message during transition: "
                   << messageTypeToString(messageType) << std::endl;
         return;  // Don't process now, will be flushed later
@@ -146,7 +180,7 @@ void Client::handleServerMessage(const nlohmann::json& message) {
       // BRDC_* messages from server
       case MessageType::BRDC_PLAYER_LIST: {
         auto* playerListMessage =
-            static_cast<PlayerListUpdateMessage*>(parsedMessage.get());
+            static_cast<const PlayerListUpdateMessage*>(message.get());
 
         // Clear the current list
         playerList_.fill(
@@ -163,7 +197,7 @@ void Client::handleServerMessage(const nlohmann::json& message) {
           playerList_[playerInfo.id] =
               player;  // the list is in order of the players' IDs now
         }
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       case MessageType::BRDC_GAME_START: {
@@ -173,42 +207,46 @@ void Client::handleServerMessage(const nlohmann::json& message) {
         // arrive right after this one will be buffered instead of delivered to
         // lobby
         beginTransitionToGame();
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       case MessageType::BRDC_GAMESTATE_UPDATE: {
         std::cout << "GameStateUpdate triggered \n";
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
+        break;
+      }
+      case MessageType::BRDC_GAMESTATE_DELTA: {
+        notifyUpdate(message);
         break;
       }
       case MessageType::BRDC_PLAYER_DISCONNECTED: {
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       case MessageType::BRDC_PLAYER_FINISHED: {
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       case MessageType::BRDC_RESULTS: {
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       // PRIV_* messages from server
       case MessageType::PRIV_CARDS_DEALT: {
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       // RESP_* messages from server
       case MessageType::RESP_START_GAME: {
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       case MessageType::RESP_PLAY_CARD: {
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       case MessageType::RESP_SKIP_TURN: {
-        notifyUpdate(message.dump());
+        notifyUpdate(message);
         break;
       }
       // Unexpected message types from server (all REQ_*)
@@ -218,6 +256,13 @@ void Client::handleServerMessage(const nlohmann::json& message) {
       case MessageType::REQ_START_GAME:
       case MessageType::REQ_PLAY_CARD:
       case MessageType::REQ_SKIP_TURN:
+      case MessageType::REQ_LIST_ROOMS:
+      case MessageType::REQ_CREATE_ROOM:
+      case MessageType::REQ_JOIN_ROOM:
+      case MessageType::RESP_LIST_ROOMS:  // Rooms are joined by REQ_CONNECT
+      case MessageType::RESP_CREATE_ROOM:
+      case MessageType::RESP_JOIN_ROOM:
+      case MessageType::REQ_GAMESTATE:
       case MessageType::RESP_CONNECT:  // Should not be received here only in
                                        // constructor
         std::cerr << "Unexpected message type from server: "
@@ -239,23 +284,22 @@ void Client::beginTransitionToGame() {
 
 // Signal that MainGameFrame is ready and flush buffered messages
 void Client::completeTransitionToGame() {
-  std::queue<std::string> reordered;
-  std::optional<std::string> gameStateMsg;
+  std::queue<std::shared_ptr<const Message>> reordered;
+  std::shared_ptr<const Message> gameStateMsg;
 
   std::cout << "=== BUFFER CONTENTS ===" << std::endl << std::flush;
 
   while (!transitionBuffer_.empty()) {
-    std::string msg = transitionBuffer_.front();
+    std::shared_ptr<const Message> msg = transitionBuffer_.front();
     transitionBuffer_.pop();
 
     // DEBUG: Print what we're looking at
-    std::cout << "Checking message: " << msg.substr(0, 100) << "..."
-              << std::endl
+    std::cout << "Checking message: "
+              << messageTypeToString(msg->getMessageType()) << std::endl
               << std::flush;
 
     // Check if this is the GAMESTATE_UPDATE message
-    if (msg.find("\"msgType\":\"BRDC_GAMESTATE_UPDATE\"") !=
-        std::string::npos) {
+    if (msg->getMessageType() == MessageType::BRDC_GAMESTATE_UPDATE) {
       std::cout << "FOUND GAMESTATE_UPDATE!" << std::endl << std::flush;
       gameStateMsg = msg;
     } else {
@@ -266,9 +310,27 @@ void Client::completeTransitionToGame() {
     }
   }
 
+  // Deltas up to the full state are already part of it
+  if (gameStateMsg) {
+    size_t sequence =
+        static_cast<const GameStateUpdateMessage*>(gameStateMsg.get())
+            ->sequence;
+    std::queue<std::shared_ptr<const Message>> kept;
+    while (!reordered.empty()) {
+      std::shared_ptr<const Message> msg = reordered.front();
+      reordered.pop();
+      if (msg->getMessageType() != MessageType::BRDC_GAMESTATE_DELTA ||
+          static_cast<const GameStateDeltaMessage*>(msg.get())->sequence >
+              sequence) {
+        kept.push(msg);
+      }
+    }
+    reordered = std::move(kept);
+  }
+
   std::cout << "=== END BUFFER ===" << std::endl << std::flush;
   std::cout << "gameStateMsg has value: "
-            << (gameStateMsg.has_value() ? "YES" : "NO") << std::endl
+            << (gameStateMsg ? "YES" : "NO") << std::endl
             << std::flush;
   std::cout << "updateCallback is null: " << (updateCallback ? "NO" : "YES")
             << std::endl
@@ -276,12 +338,12 @@ void Client::completeTransitionToGame() {
 
   state_ = ClientState::GAME;
 
-  if (gameStateMsg.has_value() && updateCallback) {
+  if (gameStateMsg && updateCallback) {
     std::cout
         << "Processing GAMESTATE_UPDATE first (reordered for initialization)"
         << std::endl
         << std::flush;
-    updateCallback(gameStateMsg.value());
+    updateCallback(gameStateMsg);
     std::cout << "GAMESTATE_UPDATE processed successfully" << std::endl
               << std::flush;
   } else {
@@ -295,9 +357,9 @@ void Client::completeTransitionToGame() {
             << " remaining buffered messages" << std::endl
             << std::flush;
   while (!reordered.empty() && updateCallback) {
-    std::string msg = reordered.front();
-    std::cout << "Processing buffered message: " << msg.substr(0, 50) << "..."
-              << std::endl
+    std::shared_ptr<const Message> msg = reordered.front();
+    std::cout << "Processing buffered message: "
+              << messageTypeToString(msg->getMessageType()) << std::endl
               << std::flush;
     updateCallback(msg);
     reordered.pop();
@@ -306,7 +368,7 @@ void Client::completeTransitionToGame() {
 }
 
 // Notify the GUI of an incoming server message
-void Client::notifyUpdate(const std::string& message) {
+void Client::notifyUpdate(std::shared_ptr<const Message> message) {
   if (updateCallback) {
     // Check if there's a valid callback set
     updateCallback(message);
@@ -316,9 +378,17 @@ void Client::notifyUpdate(const std::string& message) {
   }
 }
 
+// Sends a message in the negotiated wire format
+void Client::sendMessage(const Message& message) {
+  std::string frame = BraendiDog::encodeMessageFrame(message, wireFormat_);
+  if (connection.write(frame) != frame.size()) {
+    throw std::runtime_error("Failed to send action to server");
+  }
+}
+
 // Sends a JSON action to the server
 void Client::sendAction(nlohmann::json& actionJson) {
-  std::string message = actionJson.dump() + "\n";
+  std::string message = BraendiDog::encodeFrame(actionJson.dump());
   if (connection.write(message) != message.size()) {
     throw std::runtime_error("Failed to send action to server");
   }
@@ -326,7 +396,7 @@ void Client::sendAction(nlohmann::json& actionJson) {
 
 // Sets a callback function for receiving updates from the server
 void Client::setUpdateCallback(
-    std::function<void(const std::string&)> callback) {
+    std::function<void(std::shared_ptr<const Message>)> callback) {
   updateCallback = callback;
 
   // Process any pending messages
@@ -371,27 +441,23 @@ void Client::setPlayerIndex(size_t id) {
 // Sends a "ready" command to indicate the player is ready to play
 void Client::sendReady() {
   ReadyMessage message = ReadyMessage(playerIndex);
-  nlohmann::json actionJson = message.toJson();
-  sendAction(actionJson);
+  sendMessage(message);
 }
 
 // Sends a request to start the game and switch to game panel
 void Client::sendStartGame() {
   StartGameRequestMessage message(playerIndex);
-  nlohmann::json actionJson = message.toJson();
-  sendAction(actionJson);
+  sendMessage(message);
 }
 
 // Sends a playCard command to play a specific move to the server
 void Client::sendPlayCard(BraendiDog::Move move) {
   PlayCardRequestMessage message(playerIndex, move);
-  nlohmann::json actionJson = message.toJson();
-  sendAction(actionJson);
+  sendMessage(message);
 }
 
 // Send skip turn request to server
 void Client::sendSkipTurn() {
   SkipTurnRequestMessage message(playerIndex);
-  nlohmann::json actionJson = message.toJson();
-  sendAction(actionJson);
+  sendMessage(message);
 }
@@ -3,12 +3,16 @@
 #include <sockpp/tcp_connector.h>
 
 #include <functional>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <queue>
 #include <string>
 #include <thread>
 
+#include "shared/framing.hpp"
 #include "shared/game_types.hpp"
+#include "shared/messages.hpp"
+#include "shared/wire_format.hpp"
 
 /**
  * @struct Player
@@ -43,11 +47,22 @@ class Client {
   ~Client();
 
   /**
-   * @brief Sends an action to the server.
+   * @brief Closes the connection, which ends the listener thread.
+   */
+  void disconnect();
+
+  /**
+   * @brief Sends an action to the server as JSON.
    * @param actionJson JSON object representing the action.
    */
   void sendAction(nlohmann::json& actionJson);
 
+  /**
+   * @brief Sends a message to the server in the negotiated wire format.
+   * @param message The message to send.
+   */
+  void sendMessage(const Message& message);
+
   /**
    * @brief Signals that the client is transitioning from lobby to game.
    *        All subsequent messages will be buffered until game is ready.
@@ -62,9 +77,11 @@ class Client {
 
   /**
    * @brief Sets a callback function to handle incoming server messages.
-   * @param callback Function to call when new data is received.
+   * @param callback Function to call with each decoded message, nullptr if
+   * the connection dropped.
    */
-  void setUpdateCallback(std::function<void(const std::string&)> callback);
+  void setUpdateCallback(
+      std::function<void(std::shared_ptr<const Message>)> callback);
 
   //// Client Action Methods ////
 
@@ -133,15 +150,22 @@ class Client {
   sockpp::tcp_connector connection;  ///< TCP connection to the server.
   std::thread listenerThread;        ///< Thread to listen for server messages.
 
-  std::string initialBuffer_;  // Store any messages received during connection
+  BraendiDog::FrameBuffer inbox_;  ///< Received bytes not yet taken as frames.
+  BraendiDog::WireFormat wireFormat_ =
+      BraendiDog::WireFormat::JSON;  ///< Format of sent messages.
+  std::optional<BraendiDog::GameState>
+      gameState_;             ///< Local game state, deltas apply to it.
+  size_t stateSequence_ = 0;  ///< Sequence number of gameState_.
+  bool resyncRequested_ = false;  ///< Full game state requested.
   ClientState state_ = ClientState::LOBBY;
-  std::queue<std::string>
+  std::queue<std::shared_ptr<const Message>>
       transitionBuffer_;  // Buffer messages during transition
 
-  std::function<void(const std::string&)>
+  std::function<void(std::shared_ptr<const Message>)>
       updateCallback;  ///< Callback function for received messages.
-  std::queue<std::string> pendingMessages_;  ///< Stores pending messages if
-                                             ///< callback is not yet set.
+  std::queue<std::shared_ptr<const Message>>
+      pendingMessages_;  ///< Stores pending messages if callback is not yet
+                         ///< set.
   bool running = true;  ///< Flag for controlling the listener thread loop.
 
   int playerIndex = -1;  ///< Player's assigned index from the server.
@@ -155,14 +179,23 @@ class Client {
   void ServerListener();
 
   /**
-   * @brief Centralized handler for parsing and acting on server messages.
-   * @param message The JSON message received from the server.
+   * @brief Keeps the local game state in sync with the server.
+   * @param message Received BRDC_GAMESTATE_UPDATE or BRDC_GAMESTATE_DELTA.
+   * @return The message for the GUI, nullptr if the delta does not apply (the
+   * full state is requested then).
+   */
+  std::unique_ptr<Message> syncGameState(std::unique_ptr<Message> message);
+
+  /**
+   * @brief Centralized handler for acting on server messages.
+   * @param message The decoded message received from the server.
    */
-  void handleServerMessage(const nlohmann::json& message);
+  void handleServerMessage(std::shared_ptr<const Message> message);
 
   /**
    * @brief Updates the UI via the GUI callback.
-   * @param message The raw message to send to the GUI.
+   * @param message The decoded message to send to the GUI, nullptr if the
+   * connection dropped.
    */
-  void notifyUpdate(const std::string& message);
+  void notifyUpdate(std::shared_ptr<const Message> message);
 };
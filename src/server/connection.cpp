@@ -0,0 +1,292 @@
+#include "server/connection.hpp"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "shared/logging.hpp"
+
+namespace {
+// Frames gathered into one write
+constexpr size_t maxIovecs = 64;
+
+// Bounds of one receive(), the other sockets of the loop are served between
+// them and level-triggered readiness reports the rest again
+constexpr size_t readChunkSize = 4096;
+constexpr size_t maxReadsPerEvent = 16;
+
+// A client that went away must not kill the server with SIGPIPE
+#if defined(MSG_NOSIGNAL)
+constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+constexpr int sendFlags = 0;
+#endif
+}  // namespace
+
+// Constructor
+Connection::Connection(size_t id, sockpp::tcp_socket socket, EventLoop& loop,
+                       SendQueueLimits limits)
+    : id_(id), socket_(std::move(socket)), loop_(loop), limits_(limits) {
+  socket_.set_non_blocking(true);
+  // Frames are batched per write already, Nagle would only delay them
+  int noDelay = 1;
+  ::setsockopt(socket_.handle(), IPPROTO_TCP, TCP_NODELAY, &noDelay,
+               sizeof(noDelay));
+#if defined(SO_NOSIGPIPE)
+  int noSigPipe = 1;
+  ::setsockopt(socket_.handle(), SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe,
+               sizeof(noSigPipe));
+#endif
+}
+
+// Get connection ID
+size_t Connection::getId() const { return id_; }
+
+// Get socket descriptor
+int Connection::getHandle() const { return socket_.handle(); }
+
+// Get event loop
+EventLoop& Connection::getLoop() const { return loop_; }
+
+// Get wire format
+BraendiDog::WireFormat Connection::getWireFormat() const {
+  return wireFormat_.load();
+}
+
+// Set wire format
+void Connection::setWireFormat(BraendiDog::WireFormat format) {
+  wireFormat_.store(format);
+}
+
+// Encode a frame to share
+Connection::Frame Connection::encode(const Message& message,
+                                     BraendiDog::WireFormat format) {
+  return std::make_shared<const std::string>(
+      BraendiDog::encodeMessageFrame(message, format));
+}
+
+// Send one message as a frame
+bool Connection::send(const Message& message, FrameKind kind) {
+  return sendFrame(encode(message, wireFormat_.load()), kind);
+}
+
+// Queue an encoded frame
+bool Connection::sendFrame(Frame frame, FrameKind kind) {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  if (closed_ || error_ != 0) {
+    return false;
+  }
+  if (kind == FrameKind::STATE_DELTA && needsSnapshot_) {
+    ++droppedFrames_;
+    return true;  // Its base was discarded, the next snapshot replaces it
+  }
+  if (!makeRoom(frame->size())) {
+    ++droppedFrames_;
+    refused_ = true;
+    return false;
+  }
+  if (kind == FrameKind::STATE_DELTA && needsSnapshot_) {
+    ++droppedFrames_;
+    return true;  // Making room discarded its base
+  }
+  if (kind == FrameKind::STATE) {
+    needsSnapshot_ = false;
+  }
+
+  // Queue behind pending output, the loop writes it in order
+  refused_ = false;
+  queuedBytes_ += frame->size();
+  outbox_.push_back({std::move(frame), kind});
+  if (!flushScheduled_) {
+    flushScheduled_ = true;
+    loop_.post([weak = weak_from_this()]() {
+      if (auto self = weak.lock()) {
+        self->flush();
+      }
+    });
+  }
+  return true;
+}
+
+bool Connection::needsSnapshot() const {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return needsSnapshot_;
+}
+
+size_t Connection::getDroppedFrames() const {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  return droppedFrames_;
+}
+
+bool Connection::makeRoom(size_t size) {
+  // A frame larger than the bound still goes out on its own
+  if (queuedBytes_ == 0 || queuedBytes_ + size <= limits_.maxBytes) {
+    return true;
+  }
+
+  switch (limits_.policy) {
+    case Backpressure::DROP:
+      BD_LOG_WARN("Server", "Connection " << id_
+                                          << ": Send queue full, dropping "
+                                             "a frame");
+      return false;
+    case Backpressure::DISCONNECT:
+      break;
+    case Backpressure::COALESCE: {
+      // Game states not started yet are stale, the client gets the next one
+      auto first = outbox_.begin() + (sentBytes_ > 0 ? 1 : 0);
+      auto stale = std::stable_partition(first, outbox_.end(),
+                                         [](const Pending& pending) {
+                                           return pending.kind ==
+                                                  FrameKind::MESSAGE;
+                                         });
+      for (auto it = stale; it != outbox_.end(); ++it) {
+        queuedBytes_ -= it->frame->size();
+        ++droppedFrames_;
+        needsSnapshot_ = true;
+      }
+      BD_LOG_DEBUG("Server", "Connection "
+                                 << id_ << ": Send queue full, discarded "
+                                 << (outbox_.end() - stale)
+                                 << " game states");
+      outbox_.erase(stale, outbox_.end());
+      if (queuedBytes_ == 0 || queuedBytes_ + size <= limits_.maxBytes) {
+        return true;
+      }
+      break;
+    }
+  }
+
+  BD_LOG_WARN("Server", "Connection " << id_
+                                      << ": Send queue full, disconnecting");
+  fail(ENOBUFS);
+  return false;
+}
+
+void Connection::fail(int error) {
+  error_ = error;
+  outbox_.clear();
+  queuedBytes_ = 0;
+  sentBytes_ = 0;
+  socket_.shutdown();
+}
+
+// Flush pending output
+void Connection::flush() {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  if (closed_) {
+    return;
+  }
+
+  // Wait for WRITABLE only while the socket does not take everything
+  bool pending = writePending() && !outbox_.empty();
+  flushScheduled_ = pending;
+  if (pending != writeWatched_) {
+    writeWatched_ = pending;
+    loop_.setWritable(socket_.handle(), pending);
+  }
+}
+
+bool Connection::writePending() {
+  while (!outbox_.empty()) {
+    iovec iov[maxIovecs];
+    size_t count = std::min(outbox_.size(), maxIovecs);
+    for (size_t i = 0; i < count; ++i) {
+      const std::string& frame = *outbox_[i].frame;
+      size_t offset = i == 0 ? sentBytes_ : 0;
+      iov[i].iov_base = const_cast<char*>(frame.data() + offset);
+      iov[i].iov_len = frame.size() - offset;
+    }
+
+    msghdr msg{};
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    ssize_t n = ::sendmsg(socket_.handle(), &msg, sendFlags);
+    if (n < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return true;
+      }
+      fail(errno);
+      return false;
+    }
+
+    // Pop the frames written completely
+    size_t written = static_cast<size_t>(n);
+    while (written > 0) {
+      size_t rest = outbox_.front().frame->size() - sentBytes_;
+      if (written < rest) {
+        sentBytes_ += written;
+        return true;  // The socket took only part of the batch
+      }
+      written -= rest;
+      queuedBytes_ -= outbox_.front().frame->size();
+      outbox_.pop_front();
+      sentBytes_ = 0;
+    }
+  }
+  return true;
+}
+
+// Read what is available, up to the per event bounds
+bool Connection::receive() {
+  for (size_t reads = 0; reads < maxReadsPerEvent; ++reads) {
+    // A complete frame or an oversized header is buffered, take it first
+    if (inbox_.size() >=
+        BraendiDog::frameHeaderSize + BraendiDog::maxFrameSize) {
+      return true;
+    }
+
+    // Read straight into the frame buffer
+    auto space = inbox_.prepare(readChunkSize);
+    ssize_t n =
+        socket_.read(space.data(), std::min(space.size(), readChunkSize));
+    if (n > 0) {
+      inbox_.commit(static_cast<size_t>(n));
+    } else if (n < 0 && errno == EINTR) {
+      continue;  // Interrupted by a signal, read again
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    } else {
+      return false;  // Closed by the peer or broken
+    }
+  }
+  return true;
+}
+
+// Take the next complete message
+std::optional<std::string_view> Connection::nextMessage() {
+  return inbox_.next();
+}
+
+// Close the socket
+void Connection::close() {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  if (closed_) {
+    return;
+  }
+  closed_ = true;
+  outbox_.clear();
+  queuedBytes_ = 0;
+  sentBytes_ = 0;
+  loop_.unwatch(socket_.handle());
+  socket_.shutdown();
+  socket_.close();
+}
+
+// Get last error
+std::string Connection::lastError() const {
+  std::lock_guard<std::mutex> lock(writeMutex_);
+  if (error_ != 0) {
+    return std::strerror(error_);
+  }
+  return refused_ ? "Send queue full" : socket_.last_error_str();
+}
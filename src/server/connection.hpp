@@ -0,0 +1,212 @@
+#ifndef CONNECTION_HPP
+#define CONNECTION_HPP
+
+#include <sockpp/tcp_socket.h>
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "server/reactor.hpp"
+#include "shared/framing.hpp"
+#include "shared/messages.hpp"
+#include "shared/wire_format.hpp"
+
+/**
+ * @brief What a connection does when its send queue is full.
+ */
+enum class Backpressure {
+  DROP,        ///< Discard the new frame.
+  DISCONNECT,  ///< Close the connection, the client does not keep up.
+  COALESCE,    ///< Discard queued game states in favor of the next snapshot,
+               ///< disconnect if other messages still do not fit.
+};
+
+/**
+ * @brief Bound of the send queue of a connection.
+ */
+struct SendQueueLimits {
+  size_t maxBytes = 256 * 1024;  ///< Queued bytes before the policy applies.
+  Backpressure policy = Backpressure::COALESCE;
+};
+
+/**
+ * @class Connection
+ * @brief Non-blocking socket of one connected client, served by one event
+ * loop and shared by the server and the client's room.
+ *
+ * Reads happen on the loop thread only. Messages to a client may be sent from
+ * any thread (its own requests and the broadcasts triggered by other players);
+ * sending only queues the frame, the loop thread writes the whole queue with
+ * one gathered write. So a response and the broadcasts of the same turn
+ * usually leave in one syscall, and a slow client never blocks its room.
+ */
+class Connection : public std::enable_shared_from_this<Connection> {
+ public:
+  /// Encoded frame, shared by all recipients of a broadcast.
+  using Frame = std::shared_ptr<const std::string>;
+
+  /** @brief What a frame carries, decides what backpressure may discard. */
+  enum class FrameKind {
+    MESSAGE,      ///< Any message, never discarded by COALESCE.
+    STATE,        ///< Full game state, superseded by newer ones.
+    STATE_DELTA,  ///< Game state delta, useless once a state was discarded.
+  };
+
+  /**
+   * @brief Constructs a Connection object.
+   * @param id Server-wide ID of the connection.
+   * @param socket Accepted socket, switched to non-blocking mode.
+   * @param loop Event loop serving the socket.
+   * @param limits Bound of the send queue.
+   */
+  Connection(size_t id, sockpp::tcp_socket socket, EventLoop& loop,
+             SendQueueLimits limits = {});
+
+  /**
+   * @brief Gets the server-wide ID of the connection.
+   */
+  size_t getId() const;
+
+  /**
+   * @brief Gets the socket descriptor.
+   */
+  int getHandle() const;
+
+  /**
+   * @brief Gets the event loop serving the connection.
+   */
+  EventLoop& getLoop() const;
+
+  /**
+   * @brief Gets the wire format messages are sent in.
+   */
+  BraendiDog::WireFormat getWireFormat() const;
+
+  /**
+   * @brief Sets the wire format negotiated with the client.
+   */
+  void setWireFormat(BraendiDog::WireFormat format);
+
+  /**
+   * @brief Queues a message as one frame in the connection's wire format.
+   * @param message The message to send.
+   * @param kind What the message carries.
+   * @return False if the connection is closed, broken or refused the frame.
+   */
+  bool send(const Message& message, FrameKind kind = FrameKind::MESSAGE);
+
+  /**
+   * @brief Queues an encoded frame without copying it.
+   * @param frame Frame in the connection's wire format.
+   * @param kind What the frame carries.
+   * @return False if the connection is closed, broken or refused the frame.
+   */
+  bool sendFrame(Frame frame, FrameKind kind = FrameKind::MESSAGE);
+
+  /**
+   * @brief Checks if queued game states were discarded, so the next state
+   * has to be a full snapshot (deltas are discarded until then).
+   */
+  bool needsSnapshot() const;
+
+  /**
+   * @brief Gets the number of frames backpressure discarded so far (refused
+   * frames, coalesced game states and skipped deltas).
+   */
+  size_t getDroppedFrames() const;
+
+  /**
+   * @brief Encodes a message once for any number of connections.
+   * @throws BraendiDog::FramingError if the message exceeds maxFrameSize.
+   */
+  static Frame encode(const Message& message, BraendiDog::WireFormat format);
+
+  /**
+   * @brief Writes queued frames (loop thread only), called for posted
+   * flushes and when the loop reports the socket writable.
+   */
+  void flush();
+
+  /**
+   * @brief Reads what the socket has available (loop thread only).
+   *
+   * Reads a bounded amount per call and stops once a largest frame is
+   * buffered, the caller takes the frames before the next call.
+   * @return False on end of stream or a read error.
+   */
+  bool receive();
+
+  /**
+   * @brief Takes the payload of the next complete frame received.
+   * @return View valid until the next receive(), nullopt if no complete frame
+   * is buffered.
+   * @throws BraendiDog::FramingError if the peer sent an oversized frame.
+   */
+  std::optional<std::string_view> nextMessage();
+
+  /**
+   * @brief Stops watching and closes the socket. Later sends fail.
+   */
+  void close();
+
+  /**
+   * @brief Gets the description of the last socket error.
+   */
+  std::string lastError() const;
+
+ private:
+  size_t id_;                  ///< Server-wide ID of the connection.
+  sockpp::tcp_socket socket_;  ///< Connection socket of the client.
+  EventLoop& loop_;            ///< Loop serving the socket.
+  std::atomic<BraendiDog::WireFormat> wireFormat_{
+      BraendiDog::WireFormat::JSON};  ///< Format of sent messages.
+
+  BraendiDog::FrameBuffer inbox_;  ///< Received bytes not yet taken.
+
+  /** @brief Frame waiting in the send queue. */
+  struct Pending {
+    Frame frame;
+    FrameKind kind;
+  };
+
+  SendQueueLimits limits_;  ///< Bound of the send queue.
+
+  mutable std::mutex writeMutex_;  ///< Protects the fields below.
+  std::deque<Pending> outbox_;     ///< Frames the socket did not take yet.
+  size_t queuedBytes_ = 0;         ///< Bytes of the frames in outbox_.
+  size_t sentBytes_ = 0;           ///< Bytes of the front frame written.
+  size_t droppedFrames_ = 0;       ///< Frames discarded by backpressure.
+  bool flushScheduled_ = false;    ///< Flush posted or waiting for WRITABLE.
+  bool writeWatched_ = false;      ///< WRITABLE events enabled.
+  bool needsSnapshot_ = false;     ///< Game states were discarded.
+  bool refused_ = false;           ///< The last frame was dropped.
+  bool closed_ = false;            ///< Whether close() was called.
+  int error_ = 0;                  ///< errno of the last failed write.
+
+  /**
+   * @brief Makes room for a frame according to the policy (lock held).
+   * @return False if the frame does not fit.
+   */
+  bool makeRoom(size_t size);
+
+  /**
+   * @brief Drops all queued output and shuts the socket down, so the loop
+   * sees the end of stream and closes the session (lock held).
+   */
+  void fail(int error);
+
+  /**
+   * @brief Writes as many frames as the socket takes, gathered into one
+   * sendmsg per batch (lock held).
+   * @return False if the write failed.
+   */
+  bool writePending();
+};
+
+#endif  // CONNECTION_HPP
@@ -3,6 +3,7 @@
 #include <stdexcept>
 
 #include "server/server.hpp"
+#include "shared/logging.hpp"
 
 // Function to print usage instructions for running the server
 void printUsage(const char* programName) {
@@ -32,15 +33,22 @@ int main(int argc, char* argv[]) {
       return EXIT_FAILURE;
     }
 
+    // Log lines are written by a background thread from here on, see
+    // BRAENDI_LOG_FILE, BRAENDI_LOG_FORMAT and BRAENDI_LOG_RATE
+    BraendiDog::Log::startAsync(
+        BraendiDog::Log::AsyncOptions::fromEnvironment());
+
     // Create a server instance with the given parameters
     Server server(serverAddress, port, 30);
     server.start();  // Start the server
   } catch (const std::exception& e) {
+    BraendiDog::Log::stopAsync();  // Flush the lines before the error
     // Catch and display any errors that occur
     std::cerr << "Error: " << e.what() << std::endl;
     printUsage(argv[0]);  // Print usage instructions again
     return EXIT_FAILURE;  // Exit with error status
   }
 
+  BraendiDog::Log::stopAsync();
   return EXIT_SUCCESS;  // Exit successfully
 }
@@ -0,0 +1,300 @@
+#include "server/reactor.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#else
+#include <sys/event.h>
+#include <sys/time.h>
+#endif
+
+#include "shared/logging.hpp"
+
+namespace {
+// Events fetched per wait
+constexpr int maxEvents = 256;
+
+std::runtime_error pollerError(const std::string& what) {
+  return std::runtime_error(what + ": " + std::strerror(errno));
+}
+}  // namespace
+
+// Constructor: Creates the poller
+EventLoop::EventLoop() {
+#if defined(__linux__)
+  pollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+  if (pollFd_ < 0) {
+    throw pollerError("Error creating epoll instance");
+  }
+  wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wakeFd_ < 0) {
+    ::close(pollFd_);
+    throw pollerError("Error creating eventfd");
+  }
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.ptr = nullptr;  // Not a watched descriptor
+  ::epoll_ctl(pollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+#else
+  pollFd_ = ::kqueue();
+  if (pollFd_ < 0) {
+    throw pollerError("Error creating kqueue");
+  }
+  struct kevent ev;
+  EV_SET(&ev, 0, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+  ::kevent(pollFd_, &ev, 1, nullptr, 0, nullptr);
+#endif
+}
+
+// Destructor
+EventLoop::~EventLoop() {
+  if (wakeFd_ >= 0) {
+    ::close(wakeFd_);
+  }
+  ::close(pollFd_);
+}
+
+void EventLoop::watch(int fd, Handler handler) {
+  // The handler is in place before the poller can report the descriptor
+  auto entry = std::make_unique<Watch>();
+  entry->handler = std::move(handler);
+  std::lock_guard<std::mutex> lock(watchesMutex_);
+#if defined(__linux__)
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLRDHUP;
+  ev.data.ptr = entry.get();
+  if (::epoll_ctl(pollFd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+#else
+  struct kevent ev;
+  EV_SET(&ev, fd, EVFILT_READ, EV_ADD, 0, 0, entry.get());
+  if (::kevent(pollFd_, &ev, 1, nullptr, 0, nullptr) < 0) {
+#endif
+    BD_LOG_ERROR("Server", "Could not watch descriptor "
+                               << fd << ": " << std::strerror(errno));
+    return;
+  }
+  watches_[fd] = std::move(entry);
+}
+
+void EventLoop::unwatch(int fd) {
+  std::lock_guard<std::mutex> lock(watchesMutex_);
+#if defined(__linux__)
+  ::epoll_ctl(pollFd_, EPOLL_CTL_DEL, fd, nullptr);
+#else
+  struct kevent ev[2];
+  EV_SET(&ev[0], fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+  EV_SET(&ev[1], fd, EVFILT_WRITE, EV_DELETE, 0, 0, nullptr);
+  for (auto& change : ev) {
+    ::kevent(pollFd_, &change, 1, nullptr, 0, nullptr);  // May be absent
+  }
+#endif
+
+  // Events fetched before the removal still point to the registration: it is
+  // skipped by dispatch() and kept alive until they are handled, as is the
+  // handler if it unwatches itself
+  auto it = watches_.find(fd);
+  if (it != watches_.end()) {
+    it->second->active = false;
+    retired_.push_back(std::move(it->second));
+    watches_.erase(it);
+  }
+}
+
+void EventLoop::setWritable(int fd, bool enabled) {
+  std::lock_guard<std::mutex> lock(watchesMutex_);
+  auto it = watches_.find(fd);
+  if (it == watches_.end()) {
+    return;  // Unwatched meanwhile
+  }
+#if defined(__linux__)
+  epoll_event ev{};
+  ev.events = EPOLLIN | EPOLLRDHUP | (enabled ? EPOLLOUT : 0u);
+  ev.data.ptr = it->second.get();
+  ::epoll_ctl(pollFd_, EPOLL_CTL_MOD, fd, &ev);
+#else
+  struct kevent ev;
+  EV_SET(&ev, fd, EVFILT_WRITE, enabled ? EV_ADD | EV_ENABLE : EV_DELETE, 0,
+         0, it->second.get());
+  ::kevent(pollFd_, &ev, 1, nullptr, 0, nullptr);
+#endif
+}
+
+void EventLoop::post(Task task) {
+  {
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    tasks_.push_back(std::move(task));
+  }
+  if (!isInLoopThread()) {
+    wakeUp();
+  }
+}
+
+void EventLoop::runAfter(std::chrono::milliseconds delay, Task task) {
+  {
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    timers_.push(Timer{Clock::now() + delay, nextSequence_++, std::move(task)});
+  }
+  if (!isInLoopThread()) {
+    wakeUp();
+  }
+}
+
+bool EventLoop::isInLoopThread() const {
+  return thread_.load() == std::this_thread::get_id();
+}
+
+void EventLoop::run() {
+  thread_ = std::this_thread::get_id();
+  while (!stopped_) {
+    poll(runPending());
+  }
+  runPending();
+  thread_ = std::thread::id();
+}
+
+void EventLoop::stop() {
+  stopped_ = true;
+  wakeUp();
+}
+
+void EventLoop::wakeUp() {
+#if defined(__linux__)
+  uint64_t one = 1;
+  [[maybe_unused]] ssize_t n = ::write(wakeFd_, &one, sizeof(one));
+#else
+  struct kevent ev;
+  EV_SET(&ev, 0, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
+  ::kevent(pollFd_, &ev, 1, nullptr, 0, nullptr);
+#endif
+}
+
+void EventLoop::poll(int timeoutMs) {
+#if defined(__linux__)
+  epoll_event events[maxEvents];
+  int n = ::epoll_wait(pollFd_, events, maxEvents, timeoutMs);
+  for (int i = 0; i < n; ++i) {
+    auto* entry = static_cast<Watch*>(events[i].data.ptr);
+    if (entry == nullptr) {
+      uint64_t count;
+      [[maybe_unused]] ssize_t r = ::read(wakeFd_, &count, sizeof(count));
+      continue;
+    }
+    uint32_t flags = events[i].events;
+    uint32_t ready = 0;
+    if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+      ready |= READABLE;  // The read reports end of stream and errors
+    }
+    if (flags & EPOLLOUT) {
+      ready |= WRITABLE;
+    }
+    dispatch(*entry, ready);
+  }
+#else
+  struct kevent events[maxEvents];
+  timespec timeout{timeoutMs / 1000, (timeoutMs % 1000) * 1000000L};
+  int n = ::kevent(pollFd_, nullptr, 0, events, maxEvents,
+                   timeoutMs < 0 ? nullptr : &timeout);
+  for (int i = 0; i < n; ++i) {
+    if (events[i].filter == EVFILT_USER) {
+      continue;
+    }
+    dispatch(*static_cast<Watch*>(events[i].udata),
+             events[i].filter == EVFILT_WRITE ? WRITABLE : READABLE);
+  }
+#endif
+  releaseRetired();
+}
+
+int EventLoop::runPending() {
+  std::vector<Task> tasks;
+  std::vector<Task> due;
+  {
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    tasks.swap(tasks_);
+    auto now = Clock::now();
+    while (!timers_.empty() && timers_.top().due <= now) {
+      due.push_back(timers_.top().task);
+      timers_.pop();
+    }
+  }
+
+  for (auto& task : tasks) {
+    task();
+  }
+  for (auto& task : due) {
+    task();
+  }
+  releaseRetired();
+
+  // The tasks may have queued new work themselves
+  std::lock_guard<std::mutex> lock(tasksMutex_);
+  if (!tasks_.empty()) {
+    return 0;
+  }
+  if (timers_.empty()) {
+    return -1;
+  }
+  auto wait = std::chrono::ceil<std::chrono::milliseconds>(timers_.top().due -
+                                                           Clock::now());
+  return static_cast<int>(std::max<int64_t>(wait.count(), 0));
+}
+
+void EventLoop::dispatch(Watch& entry, uint32_t events) {
+  if (entry.active) {
+    entry.handler(events);
+  }
+}
+
+void EventLoop::releaseRetired() {
+  std::vector<std::unique_ptr<Watch>> retired;
+  {
+    std::lock_guard<std::mutex> lock(watchesMutex_);
+    retired.swap(retired_);
+  }
+  // Handlers are destroyed outside the lock, they may hold connections
+}
+
+// Constructor: Creates the loops
+Reactor::Reactor(size_t numThreads) {
+  loops_.reserve(std::max<size_t>(numThreads, 1));
+  for (size_t i = 0; i < std::max<size_t>(numThreads, 1); ++i) {
+    loops_.push_back(std::make_unique<EventLoop>());
+  }
+}
+
+// Destructor
+Reactor::~Reactor() { stop(); }
+
+size_t Reactor::getNumThreads() const { return loops_.size(); }
+
+EventLoop& Reactor::getLoop(size_t index) { return *loops_.at(index); }
+
+EventLoop& Reactor::nextLoop() {
+  return *loops_[nextLoop_.fetch_add(1) % loops_.size()];
+}
+
+void Reactor::run() {
+  std::vector<std::thread> threads;
+  threads.reserve(loops_.size() - 1);
+  for (size_t i = 1; i < loops_.size(); ++i) {
+    threads.emplace_back(&EventLoop::run, loops_[i].get());
+  }
+  loops_[0]->run();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+void Reactor::stop() {
+  for (auto& loop : loops_) {
+    loop->stop();
+  }
+}
@@ -0,0 +1,215 @@
+#ifndef REACTOR_HPP
+#define REACTOR_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class EventLoop
+ * @brief One IO thread waiting for readiness of its non-blocking sockets
+ * (epoll on Linux, kqueue on macOS/BSD) and for its timers.
+ *
+ * Each file descriptor belongs to exactly one loop, so its handler never runs
+ * concurrently with itself. Handlers, posted tasks and timers all run on the
+ * loop thread.
+ */
+class EventLoop {
+ public:
+  /** @brief Readiness reported to a handler (bit flags). */
+  enum Event : uint32_t {
+    READABLE = 1,  ///< Data, end of stream or an error can be read.
+    WRITABLE = 2,  ///< The socket accepts more data.
+  };
+
+  using Handler = std::function<void(uint32_t events)>;
+  using Task = std::function<void()>;
+
+  /**
+   * @brief Creates the poller of the loop.
+   * @throws std::runtime_error if the poller cannot be created.
+   */
+  EventLoop();
+
+  /**
+   * @brief Closes the poller.
+   */
+  ~EventLoop();
+
+  EventLoop(const EventLoop&) = delete;
+  EventLoop& operator=(const EventLoop&) = delete;
+
+  /**
+   * @brief Watches a descriptor for readability (thread-safe).
+   * @param fd Non-blocking descriptor, owned by the caller.
+   * @param handler Called on the loop thread with the ready events.
+   */
+  void watch(int fd, Handler handler);
+
+  /**
+   * @brief Stops watching a descriptor, before the caller closes it
+   * (thread-safe). No events are delivered for it afterwards, also none the
+   * loop fetched already, so the descriptor may be closed and reused at once.
+   */
+  void unwatch(int fd);
+
+  /**
+   * @brief Enables or disables WRITABLE events of a watched descriptor
+   * (thread-safe).
+   */
+  void setWritable(int fd, bool enabled);
+
+  /**
+   * @brief Runs a task on the loop thread (thread-safe).
+   */
+  void post(Task task);
+
+  /**
+   * @brief Runs a task on the loop thread once the delay has passed
+   * (thread-safe).
+   */
+  void runAfter(std::chrono::milliseconds delay, Task task);
+
+  /**
+   * @brief Checks if the caller is the loop thread.
+   */
+  bool isInLoopThread() const;
+
+  /**
+   * @brief Dispatches events until stop() is called.
+   */
+  void run();
+
+  /**
+   * @brief Makes run() return, also if it has not been called yet
+   * (thread-safe).
+   */
+  void stop();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /** @brief Pending timer, ordered by due time. */
+  struct Timer {
+    Clock::time_point due;
+    uint64_t sequence;  ///< Keeps timers with the same due time in order.
+    Task task;
+
+    bool operator>(const Timer& other) const {
+      return due != other.due ? due > other.due : sequence > other.sequence;
+    }
+  };
+
+  /**
+   * @brief Registration of a descriptor, referenced by the poller's event
+   * data so that events fetched before an unwatch can be told apart.
+   */
+  struct Watch {
+    Handler handler;
+    std::atomic<bool> active{true};  ///< Cleared by unwatch().
+  };
+
+  int pollFd_ = -1;  ///< epoll or kqueue descriptor.
+  int wakeFd_ = -1;  ///< eventfd interrupting the wait (Linux only).
+  std::atomic<bool> stopped_{false};
+  std::atomic<std::thread::id> thread_;  ///< Thread inside run().
+
+  std::mutex watchesMutex_;  ///< Protects watches_ and retired_.
+  std::unordered_map<int, std::unique_ptr<Watch>> watches_;
+  /// Unwatched, freed by the loop thread once no fetched event refers to them.
+  std::vector<std::unique_ptr<Watch>> retired_;
+
+  std::mutex tasksMutex_;  ///< Protects tasks_, timers_ and nextSequence_.
+  std::vector<Task> tasks_;
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers_;
+  uint64_t nextSequence_ = 0;
+
+  /**
+   * @brief Interrupts a blocking wait of the loop thread.
+   */
+  void wakeUp();
+
+  /**
+   * @brief Waits for events and calls their handlers.
+   * @param timeoutMs Longest wait, -1 to wait without limit.
+   */
+  void poll(int timeoutMs);
+
+  /**
+   * @brief Runs posted tasks and due timers.
+   * @return Milliseconds until the next timer, -1 if there is none.
+   */
+  int runPending();
+
+  /**
+   * @brief Calls the handler of a registration if it is still watched.
+   */
+  void dispatch(Watch& entry, uint32_t events);
+
+  /**
+   * @brief Frees the retired registrations (loop thread, between dispatches).
+   */
+  void releaseRetired();
+};
+
+/**
+ * @class Reactor
+ * @brief A small fixed pool of IO threads, each running its own EventLoop.
+ *
+ * New descriptors are spread over the loops round robin, so the number of
+ * threads stays fixed however many connections are open.
+ */
+class Reactor {
+ public:
+  /**
+   * @brief Creates the loops.
+   * @param numThreads Number of IO threads, at least one.
+   */
+  explicit Reactor(size_t numThreads);
+
+  /**
+   * @brief Stops the loops.
+   */
+  ~Reactor();
+
+  /**
+   * @brief Gets the number of IO threads.
+   */
+  size_t getNumThreads() const;
+
+  /**
+   * @brief Gets a loop by index (0 to getNumThreads() - 1).
+   */
+  EventLoop& getLoop(size_t index);
+
+  /**
+   * @brief Picks the loop for a new descriptor (round robin).
+   */
+  EventLoop& nextLoop();
+
+  /**
+   * @brief Runs the loops on the IO threads until stop() is called.
+   *
+   * The calling thread runs the first loop.
+   */
+  void run();
+
+  /**
+   * @brief Stops all loops; run() returns once they are done (thread-safe).
+   */
+  void stop();
+
+ private:
+  std::vector<std::unique_ptr<EventLoop>> loops_;
+  std::atomic<size_t> nextLoop_{0};
+};
+
+#endif  // REACTOR_HPP
@@ -0,0 +1,651 @@
+#include "server/room.hpp"
+
+#include <sstream>
+#include <utility>
+#include <stdexcept>
+#include <string>
+
+#include "shared/logging.hpp"
+
+// ID Assignment order for new players
+const std::vector<int> Room::idAssignmentOrder{0, 2, 1, 3};
+
+// Constructor: Initializes an empty room
+Room::Room(size_t id, std::string name, WorkerPool& workers)
+    : id_(id),
+      name_(std::move(name)),
+      strand_(std::make_shared<Strand>(workers)),
+      logTag_("room " + std::to_string(id)) {
+  for (int i = 0; i < 4; ++i) {
+    players_[i].id = i;
+  }
+}
+
+size_t Room::getId() const { return id_; }
+
+RoomInfo Room::getInfo() const {
+  RoomInfo info;
+  info.id = id_;
+  info.name = name_;
+  info.inGame = gameRunning_;
+  std::lock_guard<std::mutex> lock(playersMutex_);
+  info.players = static_cast<size_t>(numPlayers_);
+  return info;
+}
+
+bool Room::isJoinable() const {
+  std::lock_guard<std::mutex> lock(playersMutex_);
+  return !closed_ && !gameRunning_ && numPlayers_ < 4;
+}
+
+int Room::join(const std::shared_ptr<Connection>& connection,
+               const std::string& playerName,
+               const std::function<std::unique_ptr<Message>(int)>& welcome) {
+  int clientId = -1;
+  std::string name;
+  {
+    std::lock_guard<std::mutex> lock(playersMutex_);
+    if (closed_ || gameRunning_) {
+      return -1;
+    }
+
+    // Search for first non-occupied ID
+    for (int id : idAssignmentOrder) {
+      if (!players_[id].isActive) {
+        clientId = id;
+        break;
+      }
+    }
+    if (clientId == -1) {
+      return -1;
+    }
+
+    ClientInfo& p = players_[clientId];
+    p.connectionId = connection->getId();
+    p.id = clientId;
+    p.connection = connection;
+    p.name = isValidName(playerName)
+                 ? playerName
+                 : "Player " + std::to_string(clientId);  // Default username
+    p.isActive = true;
+    p.isReady = false;
+    name = p.name;
+
+    ++numPlayers_;
+
+    // Send client its ID. Queued under the lock, so no broadcast that
+    // already sees the seat can overtake it
+    connection->send(*welcome(clientId));
+  }
+
+  log("Player " + std::to_string(clientId) + " joined with name: " + name);
+
+  strand_->post([self = shared_from_this()]() {
+    BraendiDog::Log::ScopedTag tag(self->logTag_);
+    self->broadcastPlayerList();
+  });
+  return clientId;
+}
+
+void Room::handleMessage(size_t connectionId,
+                         std::shared_ptr<const Message> message) {
+  strand_->post([self = shared_from_this(), connectionId,
+                 message = std::move(message)]() {
+    BraendiDog::Log::ScopedTag tag(self->logTag_);
+    self->processMessage(connectionId, *message);
+  });
+}
+
+void Room::processMessage(size_t connectionId, const Message& message) {
+  int playerId = findPlayer(connectionId);
+  if (playerId < 0) {
+    return;
+  }
+
+  MessageType messageType = message.getMessageType();
+  if (messageType == MessageType::REQ_READY) {
+    if (gameRunning_) {
+      std::string errorMsg =
+          "Game is already in progress, cannot set player as ready";
+      logError(errorMsg);
+      ReadyResponseMessage resp = ReadyResponseMessage(false, errorMsg);
+      return messagePlayer(playerId, resp);
+    }
+
+    setPlayerReady(playerId);
+    broadcastPlayerList();
+  } else if (messageType == MessageType::REQ_START_GAME) {
+    log("Player " + std::to_string(playerId) + " requested to start game");
+
+    if (gameRunning_) {
+      std::string errorMsg =
+          "Game is already in progress, cannot start a new game";
+      logError(errorMsg);
+      StartGameResponseMessage resp =
+          StartGameResponseMessage(false, errorMsg);
+      return messagePlayer(playerId, resp);
+    }
+
+    if (areAllPlayersReady() && getNumPlayers() >= 2) {
+      log("Starting game with " + std::to_string(getNumPlayers()));
+      startGame();
+    } else {
+      std::string errorMsg =
+          "Start Game request denied: Not all players are ready. Current "
+          "number of players: " +
+          std::to_string(getNumPlayers());
+      logError(errorMsg);
+      StartGameResponseMessage resp =
+          StartGameResponseMessage(false, errorMsg);
+    }
+  } else if (messageType == MessageType::REQ_PLAY_CARD) {
+    const auto& msg = static_cast<const PlayCardRequestMessage&>(message);
+    log("Player " + std::to_string(playerId) +
+        " requested to play the card at handIndex : " +
+        std::to_string(msg.move.handIndex));
+    handlePlayCard(msg.move.handIndex, playerId, msg);
+  } else if (messageType == MessageType::REQ_SKIP_TURN) {
+    log("Player " + std::to_string(playerId) +
+        " requested to skip their turn");
+    handleSkipTurn(playerId);
+  } else if (messageType == MessageType::REQ_GAMESTATE) {
+    // A client that could not apply a delta starts over from the full state
+    log("Player " + std::to_string(playerId) + " requested the game state");
+    if (sentState_.has_value()) {
+      GameStateUpdateMessage msg(*sentState_, stateSequence_);
+      messagePlayer(playerId, msg, Connection::FrameKind::STATE);
+    }
+  }
+}
+
+void Room::leave(size_t connectionId, std::function<void()> onClosed) {
+  strand_->post([self = shared_from_this(), connectionId,
+                 onClosed = std::move(onClosed)]() {
+    BraendiDog::Log::ScopedTag tag(self->logTag_);
+    int playerId = self->findPlayer(connectionId);
+    if (playerId < 0) {
+      return;
+    }
+    self->log("Player " + std::to_string(playerId) + " disconnected.");
+    self->handleDisconnect(static_cast<size_t>(playerId));
+
+    // The last player closes the room, late joins are refused
+    {
+      std::lock_guard<std::mutex> lock(self->playersMutex_);
+      if (self->numPlayers_ > 0) {
+        return;
+      }
+      self->closed_ = true;
+    }
+    if (onClosed) {
+      onClosed();
+    }
+  });
+}
+
+int Room::getNumPlayers() const {
+  std::lock_guard<std::mutex> lock(playersMutex_);
+  return numPlayers_;
+}
+
+int Room::findPlayer(size_t connectionId) const {
+  std::lock_guard<std::mutex> lock(playersMutex_);
+  for (const auto& p : players_) {
+    if (p.isActive && p.connectionId == connectionId) {
+      return p.id;
+    }
+  }
+  return -1;
+}
+
+bool Room::isValidName(const std::string& name) const {
+  // Name must be a non-empty string
+  if (name.empty()) {
+    logError("Name cannot be empty");
+    return false;
+  }
+
+  // Name must be unique in the room
+  for (const auto& player : players_) {
+    if (player.isActive && player.name == name) {
+      logError("Player with name " + name + " already exists");
+      return false;
+    }
+  }
+  return true;
+}
+
+void Room::handlePlayCard(size_t handIndex, int playerId,
+                          const PlayCardRequestMessage& req) {
+  if (!gameRunning_ || !game_) {
+    PlayCardResponseMessage resp(handIndex, false, "No game is running");
+    return messagePlayer(playerId, resp);
+  }
+
+  auto& gs = *game_;
+
+  // 1. Check if it's the current player's
+  if (!gs.isMyTurn(static_cast<size_t>(playerId))) {
+    PlayCardResponseMessage resp(handIndex, false, "Not your turn");
+    return messagePlayer(playerId, resp);
+  }
+
+  try {
+    // 2. Convert PlayCardRequestMessage → Move
+    BraendiDog::Move target_move(req.move);
+
+    // 3. Validate move against the legal moves of this turn (built once)
+    if (!legalMoveSet_.has_value() || legalMoveSet_->stateHash != gs.hash()) {
+      legalMoveSet_ = gs.buildLegalMoveSet();
+    }
+    if (!gs.isValidTurn(target_move, legalMoveSet_.value())) {
+      PlayCardResponseMessage resp(handIndex, false, "Invalid move");
+      return messagePlayer(playerId, resp);
+    }
+
+    // DEBUG: log gamestate hands
+    if (BraendiDog::Log::enabled(BraendiDog::Log::Level::DEBUG)) {
+      const auto& constGs = gs;
+      for (size_t i = 0; i < 4; i++) {
+        const auto& playerOpt = constGs.getPlayerByIndex(i);
+        if (playerOpt.has_value()) {
+          std::ostringstream hand;
+          for (const auto& cardIdx : playerOpt->getHand()) {
+            hand << cardIdx << " ";
+          }
+          BD_LOG_DEBUG("Server", "Player " << i << " hand: " << hand.str());
+        }
+      }
+    }
+
+    // 4. Execute the move
+    bool playerFinished = gs.executeMove(target_move);
+    auto [gameEnded, roundEnded] = gs.endTurn();
+
+    // 6. Respond
+    PlayCardResponseMessage resp(handIndex, true, "");
+    messagePlayer(playerId, resp);
+
+    // 7. Broadcast updated game state
+    broadcastGameState();
+
+    // 8. If player finished, broadcast message
+    if (playerFinished) {
+      PlayerFinishedMessage finishMsg(static_cast<size_t>(playerId));
+      broadcastMessage(finishMsg);
+    }
+
+    // 9. Broadcast game end if needed
+    if (gameEnded) {
+      handleGameEnd();
+    }
+    // 10. Deal cards again if round ended
+    else if (roundEnded) {
+      newRound();
+    }
+
+  } catch (const std::exception& e) {
+    logError("Could not make a move — " + std::string(e.what()));
+
+    PlayCardResponseMessage resp(handIndex, false, e.what());
+    return messagePlayer(playerId, resp);
+  }
+}
+
+void Room::handleSkipTurn(int playerId) {
+  if (!gameRunning_ || !game_) {
+    SkipTurnResponseMessage resp(false, "No game is running");
+    return messagePlayer(playerId, resp);
+  }
+
+  auto& gs = *game_;
+
+  // 1. Check if it's the current player's
+  if (!gs.isMyTurn(static_cast<size_t>(playerId))) {
+    SkipTurnResponseMessage resp(false, "Not your turn");
+    return messagePlayer(playerId, resp);
+  }
+
+  try {
+    // 2. Validate fold against the legal moves of this turn (built once)
+    if (!legalMoveSet_.has_value() || legalMoveSet_->stateHash != gs.hash()) {
+      legalMoveSet_ = gs.buildLegalMoveSet();
+    }
+    if (!gs.isValidTurn(BraendiDog::Move(), legalMoveSet_.value())) {
+      SkipTurnResponseMessage resp(false, "Invalid fold - legal moves exist");
+      return messagePlayer(playerId, resp);
+    }
+
+    // 3. Execute the fold
+    gs.executeFold();
+    auto [gameEnded, roundEnded] = gs.endTurn();
+
+    // 4. Respond
+    SkipTurnResponseMessage resp(true, "");
+    messagePlayer(playerId, resp);
+
+    // 5. Broadcast updated game state
+    broadcastGameState();  // Player status has changed
+
+    // 6. Broadcast game end if needed
+    if (gameEnded) {
+      handleGameEnd();
+    }
+
+    // 7. Deal cards again if round ended
+    else if (roundEnded) {
+      newRound();
+    }
+
+  } catch (const std::exception& e) {
+    logError("Could not skip turn — " + std::string(e.what()));
+
+    SkipTurnResponseMessage resp(false, e.what());
+    return messagePlayer(playerId, resp);
+  }
+}
+
+void Room::newRound() {
+  log("Starting new round.");
+  auto dealtCards = game_->dealCards();
+
+  for (const auto& [id, hand] : dealtCards) {
+    // Save in game state
+    auto& playerOpt = game_->getPlayerByIndex(id);
+    if (playerOpt.has_value()) {
+      playerOpt.value().setHand(hand);
+    } else {
+      logError("Could not find player " + std::to_string(id) +
+               " in game state when dealing new round cards!");
+      continue;
+    }
+    // Send private message to each player with their dealt cards
+    CardsDealtMessage cardsMsg(id, hand);
+    messagePlayer(static_cast<int>(id), cardsMsg);
+  }
+}
+
+void Room::handleGameEnd() {
+  log("Game ended, releasing rankings.");
+
+  // Build a simple results message from leaderBoard
+  const auto& leaderboard = game_->getLeaderBoard();
+
+  GameResultsMessage resultsMsg(leaderboard);
+  broadcastMessage(resultsMsg);
+
+  // Back to the lobby, the players get ready again for a rematch
+  gameRunning_ = false;
+  legalMoveSet_.reset();
+  std::lock_guard<std::mutex> lock(playersMutex_);
+  for (auto& player : players_) {
+    player.isReady = false;
+  }
+}
+
+void Room::handleDisconnect(const size_t playerId) {
+  {
+    std::lock_guard<std::mutex> lock(playersMutex_);
+
+    auto& p = players_[playerId];
+
+    // Update player info, the server closes the socket
+    p.isActive = false;
+    p.isReady = false;
+    p.connection.reset();
+
+    numPlayers_--;
+
+    // Re-arrange Player ID's if game hasn't started
+    if (!gameRunning_) {
+      std::array<ClientInfo, 4> updatedPlayers;
+
+      int assignmentIdx = 0;
+
+      for (auto& p : players_) {
+        if (p.isActive) {
+          size_t updatedId = idAssignmentOrder[assignmentIdx];
+
+          updatedPlayers[updatedId] = std::move(p);
+          updatedPlayers[updatedId].id = updatedId;
+          assignmentIdx++;
+        }
+      }
+      for (int id = 0; id < 4; ++id) {
+        updatedPlayers[id].id = id;  // Free seats keep their IDs
+      }
+      players_ = std::move(updatedPlayers);
+    }
+
+    log("Cleaned up after disconnected player " + std::to_string(playerId));
+  }
+
+  // Send disconnect message to remaining players
+  PlayerDisconnectedMessage disconnectMsg(playerId);
+  broadcastMessage(disconnectMsg);
+
+  // LOBBY -> update player list
+  if (!gameRunning_) {
+    broadcastPlayerList();
+  }
+  // MAIN GAME -> update game state
+  else {
+    // Update gamestate and call gamestate update
+    game_->disconnectPlayer(playerId);
+
+    // The player may have been the last one left in the round
+    bool roundEnded = !game_->checkGameEnd() && game_->checkRoundEnd();
+    if (roundEnded) {
+      game_->endTurn();
+    }
+    broadcastGameState();
+
+    // Finished players stay seated, so ask the game rather than count seats
+    if (getNumPlayers() <= 1 || game_->checkGameEnd()) {
+      handleGameEnd();
+    } else if (roundEnded) {
+      newRound();
+    }
+  }
+}
+
+void Room::setPlayerReady(int playerId) {
+  log("setPlayerReady Function called by " + std::to_string(playerId));
+
+  if (playerId < 0 || playerId >= 4) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(playersMutex_);
+  auto& p = players_[playerId];
+  if (!p.isActive) return;  // Check if player is active
+
+  p.isReady = true;
+  log("Player " + std::to_string(playerId) + " is ready!");
+}
+
+bool Room::areAllPlayersReady() const {
+  log("areAllPlayersReady Function called.");
+
+  std::lock_guard<std::mutex> lock(playersMutex_);
+  int numReady = 0;
+
+  for (const auto& player : players_) {
+    if (!player.isActive) {
+      continue;
+    }
+
+    if (!player.isReady) {
+      log("Player " + std::to_string(player.id) + " is not ready");
+      return false;  // If any player is not ready, return false
+    }
+    numReady++;
+  }
+
+  log(std::to_string(numReady) + "/" + std::to_string(numReady) +
+      " players are ready.");
+  return true;
+}
+
+void Room::startGame() {
+  log("All players ready, starting game...");
+
+  // Build list of players for GameState, joins stop with the same lock
+  std::array<std::optional<std::string>, 4> gamePlayers;
+  {
+    std::lock_guard<std::mutex> lock(playersMutex_);
+    for (const auto& p : players_) {
+      if (p.isActive) {
+        gamePlayers[p.id] = p.name;
+      }
+    }
+    gameRunning_ = true;
+  }
+
+  // Initialize Game
+  game_ = std::make_unique<BraendiDog::GameState>(gamePlayers);
+  legalMoveSet_.reset();
+  sentState_.reset();
+  stateSequence_ = 0;
+
+  // Notify clients game is starting
+  GameStartMessage startMsg(getNumPlayers());
+  broadcastMessage(startMsg);
+
+  // Broadcast initial game state
+  broadcastGameState();
+
+  // Deal cards and send to each active player
+  newRound();
+}
+
+void Room::messagePlayer(int playerId, const Message& message,
+                         Connection::FrameKind kind) const {
+  if (playerId < 0 || playerId >= 4) {
+    log("Sending message to invalid player ID.");
+    return;
+  }
+
+  // Get connection under lock to prevent race conditions
+  std::shared_ptr<Connection> connection;
+  {
+    std::lock_guard<std::mutex> lock(playersMutex_);
+    auto& p = players_[playerId];
+    if (!p.isActive || !p.connection) {
+      log("Sending message to inactive player.");
+      return;
+    }
+    connection = p.connection;
+  }
+
+  // Send message without holding lock (I/O should not block mutex)
+  if (!connection->send(message, kind)) {
+    logError("Failed to send message to player " + std::to_string(playerId) +
+             ": " + connection->lastError());
+    return;
+  }
+  BD_LOG_TRACE("Server", "Sending message to " << playerId << ": "
+                                                << message.toString(-1));
+}
+
+void Room::broadcastMessage(
+    const Message& message, Connection::FrameKind kind,
+    const std::function<std::unique_ptr<Message>()>& snapshot) const {
+  // Collect the connections under lock to avoid race conditions with ID
+  // reassignment
+  std::vector<std::pair<int, std::shared_ptr<Connection>>> recipients;
+  {
+    std::lock_guard<std::mutex> lock(playersMutex_);
+    for (const auto& p : players_) {
+      if (p.isActive && p.connection) {
+        recipients.emplace_back(p.id, p.connection);
+      }
+    }
+  }
+
+  // Encode once per wire format in use, every recipient queues the same
+  // frame. Send without holding the lock (I/O should not block mutex)
+  std::array<Connection::Frame, BraendiDog::wireFormatCount> frames;
+  std::array<Connection::Frame, BraendiDog::wireFormatCount> snapshotFrames;
+  std::unique_ptr<Message> snapshotMessage;
+  for (const auto& [playerId, connection] : recipients) {
+    const auto format = connection->getWireFormat();
+    const size_t index = static_cast<size_t>(format);
+    Connection::Frame frame;
+    Connection::FrameKind frameKind = kind;
+    if (snapshot && connection->needsSnapshot()) {
+      // Lagging client, its queue discarded the base of the delta
+      if (!snapshotMessage) {
+        snapshotMessage = snapshot();
+      }
+      if (!snapshotFrames[index]) {
+        snapshotFrames[index] = Connection::encode(*snapshotMessage, format);
+      }
+      frame = snapshotFrames[index];
+      frameKind = Connection::FrameKind::STATE;
+    } else {
+      if (!frames[index]) {
+        frames[index] = Connection::encode(message, format);
+      }
+      frame = frames[index];
+    }
+    if (!connection->sendFrame(std::move(frame), frameKind)) {
+      logError("Failed to send message to player " +
+               std::to_string(playerId) + ": " + connection->lastError());
+    }
+  }
+  BD_LOG_TRACE("Server", "Broadcasting to " << recipients.size()
+                                             << " players: "
+                                             << message.toString(-1));
+}
+
+void Room::broadcastGameState() {
+  ++stateSequence_;
+  if (!sentState_.has_value() || stateSequence_ % snapshotInterval == 0) {
+    log("Broadcasting game state");
+    sentState_ = *game_;
+    GameStateUpdateMessage msg(*sentState_, stateSequence_);
+    return broadcastMessage(msg, Connection::FrameKind::STATE);
+  }
+
+  log("Broadcasting game state delta");
+  GameStateDeltaMessage msg(stateSequence_, game_->diff(*sentState_));
+  // Advance the base like the clients do
+  sentState_->applyDelta(msg.delta);
+  broadcastMessage(msg, Connection::FrameKind::STATE_DELTA, [this]() {
+    return std::make_unique<GameStateUpdateMessage>(*sentState_,
+                                                    stateSequence_);
+  });
+}
+
+void Room::broadcastPlayerList() const {
+  log("Broadcasting player list");
+
+  std::vector<PlayerInfo> playersInfo;
+
+  {
+    std::lock_guard<std::mutex> lock(playersMutex_);
+    for (const auto& p : players_) {
+      if (!p.isActive) continue;
+
+      PlayerInfo info;
+      info.id = p.id;
+      info.name = p.name;
+      info.ready = p.isReady;
+      playersInfo.push_back(info);
+    }
+  }
+
+  PlayerListUpdateMessage msg(playersInfo);
+  broadcastMessage(msg);
+}
+
+void Room::log(const std::string& message) const {
+  BraendiDog::Log::ScopedTag tag(logTag_);
+  BD_LOG_INFO("Server", message);
+}
+
+void Room::logError(const std::string& message) const {
+  BraendiDog::Log::ScopedTag tag(logTag_);
+  BD_LOG_ERROR("Server", message);
+}
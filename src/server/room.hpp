@@ -0,0 +1,229 @@
+#ifndef ROOM_HPP
+#define ROOM_HPP
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "server/connection.hpp"
+#include "server/worker_pool.hpp"
+#include "shared/game.hpp"
+#include "shared/logging.hpp"
+#include "shared/messages.hpp"
+
+/**
+ * @class Room
+ * @brief One table of the server with its own players, game state and
+ * lifecycle.
+ *
+ * Player IDs are seats within the room (0-3). All events of a room (joins,
+ * requests, disconnects) run on its Strand, one at a time and in arrival
+ * order, so the game state needs no lock and the messages each event sends
+ * reach the clients in order. Rooms share the server's WorkerPool and make
+ * progress in parallel. Create rooms with std::make_shared, queued events
+ * keep their room alive.
+ */
+class Room : public std::enable_shared_from_this<Room> {
+ public:
+  /**
+   * @brief Constructs an empty Room.
+   * @param id Server-wide ID of the room.
+   * @param name Display name of the room.
+   * @param workers Pool running the events of the room.
+   */
+  Room(size_t id, std::string name, WorkerPool& workers);
+
+  /**
+   * @brief Gets the ID of the room.
+   */
+  size_t getId() const;
+
+  /**
+   * @brief Gets the summary shown in room lists.
+   */
+  RoomInfo getInfo() const;
+
+  /**
+   * @brief Checks if a player could join right now.
+   * @return True if the room is open, has a free seat and no game is running.
+   */
+  bool isJoinable() const;
+
+  /**
+   * @brief Seats a connection in the room (on the caller's thread).
+   * @param connection Connection of the joining client.
+   * @param playerName Requested player name (default name if invalid).
+   * @param welcome Builds the response sent to the client for its seat,
+   * queued before any other message of the room reaches the client.
+   * @return Seat (player ID) of the client, -1 if the room cannot be joined.
+   */
+  int join(const std::shared_ptr<Connection>& connection,
+           const std::string& playerName,
+           const std::function<std::unique_ptr<Message>(int)>& welcome);
+
+  /**
+   * @brief Queues a game or lobby request of a seated client.
+   * @param connectionId ID of the sending connection.
+   * @param message The parsed request.
+   */
+  void handleMessage(size_t connectionId,
+                     std::shared_ptr<const Message> message);
+
+  /**
+   * @brief Queues the removal of a disconnected client.
+   * @param connectionId ID of the connection that was closed.
+   * @param onClosed Called on the room's strand if the room is empty then
+   * and was closed.
+   */
+  void leave(size_t connectionId, std::function<void()> onClosed);
+
+  /**
+   * @brief Checks the number of players seated in the room.
+   */
+  int getNumPlayers() const;
+
+  /**
+   * @brief Checks if all seated players are ready to start the game.
+   */
+  bool areAllPlayersReady() const;
+
+ private:
+  /** @brief Player-specific data slot. */
+  struct ClientInfo {
+    size_t connectionId = 0;  ///< Connection seated here.
+    int id = -1;              ///< ID of the player (seat).
+    std::shared_ptr<Connection> connection;  ///< Connection of the client.
+    std::string name;         ///< Player name.
+    bool isActive = false;    ///< Whether the seat is taken.
+    bool isReady = false;     ///< Whether the player is ready to start.
+  };
+
+  const size_t id_;         ///< Server-wide ID of the room.
+  const std::string name_;  ///< Display name of the room.
+
+  std::shared_ptr<Strand> strand_;  ///< Runs the events of the room.
+  /// Tags the lines logged for the room, with the room's rate limit.
+  mutable BraendiDog::Log::Tag logTag_;
+  mutable std::mutex playersMutex_;  ///< Protects players_ and numPlayers_.
+
+  int numPlayers_ = 0;  ///< Number of seated players.
+  std::array<ClientInfo, 4> players_;  ///< Seats of the room (IDs 0-3).
+
+  static const std::vector<int> idAssignmentOrder;
+
+  /// Every this many updates the full game state is sent instead of a delta
+  static constexpr size_t snapshotInterval = 32;
+
+  // Game of the room, only touched on the strand
+  std::unique_ptr<BraendiDog::GameState> game_;  ///< Game instance.
+  std::optional<BraendiDog::LegalMoveSet>
+      legalMoveSet_;  ///< Legal moves of the current turn, reused on retries
+  std::optional<BraendiDog::GameState>
+      sentState_;  ///< Last broadcast state, the base of the next delta
+  size_t stateSequence_ = 0;  ///< Sequence number of the last broadcast
+  std::atomic<bool> gameRunning_{false};  ///< Whether a game is running.
+  std::atomic<bool> closed_{false};  ///< Set once the last player left.
+
+  /**
+   * @brief Processes a request of a seated client (on the strand).
+   */
+  void processMessage(size_t connectionId, const Message& message);
+
+  /**
+   * @brief Finds the seat of a connection.
+   * @return Player ID, -1 if the connection is not seated here.
+   */
+  int findPlayer(size_t connectionId) const;
+
+  /**
+   * @brief Checks if a player's name is non-empty and unique in the room.
+   */
+  bool isValidName(const std::string& name) const;
+
+  /**
+   * @brief Marks a player as ready.
+   */
+  void setPlayerReady(int playerId);
+
+  /**
+   * @brief Starts the game when all players are ready.
+   */
+  void startGame();
+
+  /**
+   * @brief Handles a client's request to play a card.
+   * @param handIndex Hand index of the played card.
+   * @param playerId The ID of the player attempting to play a card.
+   * @param req The incoming PlayCardRequestMessage containing the move.
+   */
+  void handlePlayCard(size_t handIndex, int playerId,
+                      const PlayCardRequestMessage& req);
+
+  /**
+   * @brief Handles a player's request to skip their turn.
+   */
+  void handleSkipTurn(int playerId);
+
+  /**
+   * @brief Deals a new round and sends every player their hand.
+   */
+  void newRound();
+
+  /**
+   * @brief Broadcasts the results and returns the room to the lobby.
+   */
+  void handleGameEnd();
+
+  /**
+   * @brief Updates game state and clients when a client disconnects.
+   */
+  void handleDisconnect(size_t playerId);
+
+  /**
+   * @brief Sends a message to a specific player.
+   * @param kind What the message carries, for the player's send queue.
+   */
+  void messagePlayer(
+      int playerId, const Message& message,
+      Connection::FrameKind kind = Connection::FrameKind::MESSAGE) const;
+
+  /**
+   * @brief Broadcasts a message to all seated players.
+   * @param kind What the message carries, for the players' send queues.
+   * @param snapshot Makes the full state sent instead of a delta to players
+   * whose queue discarded game states.
+   */
+  void broadcastMessage(
+      const Message& message,
+      Connection::FrameKind kind = Connection::FrameKind::MESSAGE,
+      const std::function<std::unique_ptr<Message>()>& snapshot = {}) const;
+
+  /**
+   * @brief Broadcasts the changes of the game state to all seated players.
+   *
+   * Sends the full state at game start and every snapshotInterval updates.
+   */
+  void broadcastGameState();
+
+  /**
+   * @brief Broadcasts the player list to all seated players.
+   */
+  void broadcastPlayerList() const;
+
+  /**
+   * @brief Logs room information.
+   */
+  void log(const std::string& message) const;
+
+  /**
+   * @brief Logs room errors.
+   */
+  void logError(const std::string& message) const;
+};
+
+#endif  // ROOM_HPP
@@ -1,30 +1,67 @@
 #include "server/server.hpp"
 
-#include <iostream>
+#include <algorithm>
+#include <cerrno>
+#include <optional>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
-#include "shared/game.hpp"
+#include "shared/framing.hpp"
+#include "shared/logging.hpp"
 #include "shared/messages.hpp"
+#include "shared/wire_format.hpp"
+
+namespace {
+// Response to a room entering request, matching the request type
+std::unique_ptr<Message> roomResponse(const Message& request, bool success,
+                                      const std::string& error, size_t roomId,
+                                      int playerId,
+                                      BraendiDog::WireFormat format) {
+  size_t id = playerId < 0 ? 0 : static_cast<size_t>(playerId);
+  size_t wireFormat = static_cast<size_t>(format);
+  switch (request.getMessageType()) {
+    case MessageType::REQ_CREATE_ROOM:
+      return std::make_unique<CreateRoomResponseMessage>(success, error, roomId,
+                                                         id, wireFormat);
+    case MessageType::REQ_JOIN_ROOM:
+      return std::make_unique<JoinRoomResponseMessage>(success, error, roomId,
+                                                       id, wireFormat);
+    default:
+      return std::make_unique<ConnectionResponseMessage>(success, error, id,
+                                                         wireFormat);
+  }
+}
+
+// Default number of IO threads
+size_t defaultIoThreads() {
+  return std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 4);
+}
 
-// ID Assignment order for new connections
-const std::vector<int> Server::idAssignmentOrder{0, 2, 1, 3};
+// Default number of threads running the rooms
+size_t defaultWorkerThreads() {
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+}  // namespace
 
 // Constructor: Initializes the server with the given address, port, and
 // connection timeout limit
-Server::Server(std::string serverAddress, int port, int connectionTimeout)
-    : serverAddress_(std::move(serverAddress)), port_(port), acceptor_() {
+Server::Server(std::string serverAddress, int port, int connectionTimeout,
+               size_t ioThreads, SendQueueLimits sendLimits,
+               size_t workerThreads)
+    : acceptor_(),
+      serverAddress_(std::move(serverAddress)),
+      port_(port),
+      reactor_(ioThreads > 0 ? ioThreads : defaultIoThreads()),
+      sendLimits_(sendLimits),
+      workers_(workerThreads > 0 ? workerThreads : defaultWorkerThreads()),
+      connectionTimeout_(connectionTimeout) {
   if (!acceptor_.open(sockpp::inet_address(serverAddress_, port_))) {
     throw std::runtime_error("Error creating the server: " +
                              acceptor_.last_error_str());
   }
-
-  // Initialize players (inactive)
-  for (int i = 0; i < 4; ++i) {
-    players_[i].id = i;
-  }
 }
 
 // Destructor
@@ -32,18 +69,24 @@ Server::~Server() {
   stop();  // Ensure all connections are properly closed
 }
 
-// Starts the server and waits for players before running the game loop
+// Starts the server and serves clients until it is stopped
 void Server::start() {
   if (!acceptor_.is_open()) {
     throw std::runtime_error("Error starting server: acceptor not running.");
   }
 
   running_ = true;
+  acceptor_.set_non_blocking(true);
+  reactor_.getLoop(0).watch(acceptor_.handle(),
+                            [this](uint32_t) { acceptConnections(); });
+  reactor_.getLoop(0).runAfter(statsInterval, [this]() { logWorkerStats(); });
 
   log("Server listening on " + serverAddress_ + ":" + std::to_string(port_) +
-      ", waiting for players...");
+      " with " + std::to_string(reactor_.getNumThreads()) + " IO threads and " +
+      std::to_string(workers_.getNumThreads()) +
+      " workers, waiting for players...");
 
-  waitForPlayers();
+  reactor_.run();
   stop();
 }
 
@@ -55,6 +98,12 @@ void Server::stop() {
 
   log("Shutting down server");
   shuttingDown_ = true;
+  running_ = false;
+
+  // Make run() return, the IO threads finish their current events, the
+  // workers their current room events
+  reactor_.stop();
+  workers_.stop();
 
   if (acceptor_.is_open()) {
     acceptor_.shutdown();
@@ -63,663 +112,322 @@ void Server::stop() {
 
   // Close sockets
   {
-    std::lock_guard<std::mutex> lock(playersMutex_);
-    for (auto& player : players_) {
-      if (player.socket) {
-        player.socket->shutdown();
-      }
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    for (auto& [id, session] : sessions_) {
+      session->connection->close();
     }
+    sessions_.clear();
   }
 
-  // Clean up threads
   {
-    std::lock_guard<std::mutex> lock(threadsMutex_);
-    auto self = std::this_thread::get_id();
-
-    for (auto& t : clientThreads_) {
-      if (t.joinable() && t.get_id() != self) {
-        t.join();
-      }
-    }
-    clientThreads_.clear();
-  }
-
-  // Clean up players
-  {
-    std::lock_guard<std::mutex> lock(playersMutex_);
-    for (auto& player : players_) {
-      if (player.socket) {
-        player.socket->close();
-        player.socket.reset();
-      }
-      player.isActive = false;
-      player.isReady = false;
-    }
+    std::lock_guard<std::mutex> lock(roomsMutex_);
+    rooms_.clear();
   }
 
   log("Server stopped.");
 }
 
-std::array<std::optional<std::string>, 4> Server::getPlayerNames() const {
-  std::lock_guard<std::mutex> lock(playersMutex_);
+size_t Server::getNumRooms() const {
+  std::lock_guard<std::mutex> lock(roomsMutex_);
+  return rooms_.size();
+}
+
+std::vector<WorkerPool::Stats> Server::getWorkerStats() const {
+  return workers_.getStats();
+}
 
-  std::array<std::optional<std::string>, 4> names;
-  for (int i = 0; i < 4; i++) {
-    if (players_[i].isActive) {
-      names[i] = players_[i].name;
+void Server::logWorkerStats() {
+  auto stats = workers_.getStats();
+  loggedStats_.resize(stats.size());
+  const double seconds = static_cast<double>(statsInterval.count());
+  for (size_t i = 0; i < stats.size(); ++i) {
+    // Counters since the last log
+    WorkerPool::Stats interval = stats[i];
+    const WorkerPool::Stats& last = loggedStats_[i];
+    interval.tasks -= last.tasks;
+    interval.stolen -= last.stolen;
+    interval.busy -= last.busy;
+    for (size_t b = 0; b < interval.waitBuckets.size(); ++b) {
+      interval.waitBuckets[b] -= last.waitBuckets[b];
     }
+
+    BD_LOG_INFO("Server",
+                "Worker " << i << ": " << interval.tasks / seconds
+                          << " tasks/s (" << interval.stolen << " stolen), "
+                          << interval.busy.count() / (seconds * 1e4)
+                          << "% busy, wait p50 < "
+                          << interval.waitPercentile(0.5).count()
+                          << " us, p99 < "
+                          << interval.waitPercentile(0.99).count()
+                          << " us, max " << stats[i].maxWait.count() << " us");
   }
-  return names;
-}
+  loggedStats_ = std::move(stats);
 
-int Server::getNumPlayers() const {
-  std::lock_guard<std::mutex> lock(playersMutex_);
-  return numPlayers_;
+  if (running_) {
+    reactor_.getLoop(0).runAfter(statsInterval, [this]() { logWorkerStats(); });
+  }
 }
 
-void Server::waitForPlayers() {
+void Server::acceptConnections() {
   while (running_) {
-    log("Waiting for players to connect");
-
     sockpp::tcp_socket sock = acceptor_.accept();
     if (!sock) {
-      // Check if server is running
-      if (!running_) {
-        return;
+      // Nothing left to accept
+      if (errno != EAGAIN && errno != EWOULDBLOCK && running_) {
+        logError("Error accepting connection: " + acceptor_.last_error_str());
       }
-
-      throw std::runtime_error("Error accepting connection: " +
-                               acceptor_.last_error_str());
-    }
-
-    // Handle the new connection
-    int id = handleNewConnection(std::move(sock));
-    if (id < 0) {
-      continue;  // Game is full, connection rejected.
-    }
-
-    // Start a thread to process actions for this client
-    {
-      std::lock_guard<std::mutex> lock(threadsMutex_);
-      clientThreads_.emplace_back(&Server::handleNewMessage, this, id);
+      return;
     }
-    // std::thread(&Server::handleNewMessage, this, playerId).detach();
-
-    broadcastPlayerList();
+    openSession(std::move(sock));
   }
 }
 
-int Server::handleNewConnection(sockpp::tcp_socket sock) {
-  log("New connection request received");
-
-  if (!running_) {
-    log("Cannot accept new connections: server is not running");
-    return -1;
-  }
-
-  int clientId = -1;
-
+void Server::openSession(sockpp::tcp_socket socket) {
+  EventLoop& loop = reactor_.nextLoop();
+  auto session = std::make_shared<Session>();
   {
-    std::lock_guard<std::mutex> lock(playersMutex_);
-
-    // Search for first non-occupied ID
-    for (int id : idAssignmentOrder) {
-      if (!players_[id].isActive) {
-        clientId = id;
-        break;
-      }
-    }
-    if (clientId == -1) {
-      sock.shutdown();
-      sock.close();
-      log("Connection error: maximum players reached.");
-      return -1;
+    std::lock_guard<std::mutex> lock(connectionsMutex_);
+    session->connection = std::make_shared<Connection>(
+        nextConnectionId_++, std::move(socket), loop, sendLimits_);
+    sessions_[session->connection->getId()] = session;
+  }
+  log("New connection " + std::to_string(session->connection->getId()));
+
+  loop.watch(session->connection->getHandle(),
+             [this, session](uint32_t events) {
+               handleEvents(session, events);
+             });
+
+  // Connections that never enter a room are dropped
+  std::weak_ptr<Session> weak = session;
+  loop.runAfter(connectionTimeout_, [this, weak]() {
+    auto session = weak.lock();
+    if (session && !session->room && !session->closed) {
+      log("Connection " + std::to_string(session->connection->getId()) +
+          " did not enter a room in time.");
+      closeSession(*session);
     }
-
-    log("Connecting client with client ID " + std::to_string(clientId));
-
-    ClientInfo& p = players_[clientId];
-    p.threadId = clientId;
-    p.id = clientId;
-    p.socket = std::make_unique<sockpp::tcp_socket>(std::move(sock));
-    p.isActive = true;  // Claim the slot immediately under lock
-    p.isReady = false;
-    if (p.name.empty()) {
-      p.name =
-          "Player " + std::to_string(clientId);  // Default username for players
-    }
-
-    ++numPlayers_;
-  }
-
-  // Send client its ID
-  ConnectionResponseMessage welcomeMessage(true, "", clientId);
-  messagePlayer(clientId, welcomeMessage.toJson());
-
-  log("Player " + std::to_string(clientId) + " connected!");
-
-  // Get player name from the client
-  char buf[1024];
-  ssize_t n = players_[clientId].socket->read(buf, sizeof(buf));
-  if (n <= 0) {
-    throw std::runtime_error("Error reading player name: " +
-                             players_[clientId].socket->last_error_str());
-  }
-
-  std::string receivedData(buf, n);
-  nlohmann::json receivedJson = nlohmann::json::parse(receivedData);
-  auto nameMessage = Message::fromJson(receivedJson);
-  auto* setNameMessage =
-      static_cast<ConnectionRequestMessage*>(nameMessage.get());
-  const std::string playerName = setNameMessage->name;
-
-  if (isValidName(playerName)) {
-    players_[clientId].name = playerName;
-  }
-
-  log("Player " + std::to_string(clientId) +
-      " connected with name: " + players_[clientId].name);
-
-  return clientId;
+  });
 }
 
-void Server::handlePlayCard(size_t handIndex, int playerId,
-                            const PlayCardRequestMessage& req) {
-  if (!gameRunning_ || !game_) {
-    PlayCardResponseMessage resp(handIndex, false, "No game is running");
-    return messagePlayer(playerId, resp.toJson());
+void Server::handleEvents(const std::shared_ptr<Session>& session,
+                          uint32_t events) {
+  Connection& connection = *session->connection;
+  if (events & EventLoop::WRITABLE) {
+    connection.flush();
   }
-
-  auto& gs = *game_;
-
-  // 1. Check if it's the current player's
-  if (!gs.isMyTurn(static_cast<size_t>(playerId))) {
-    PlayCardResponseMessage resp(handIndex, false, "Not your turn");
-    return messagePlayer(playerId, resp.toJson());
+  if (!(events & EventLoop::READABLE)) {
+    return;
   }
 
+  bool open = connection.receive();
   try {
-    // 2. Convert PlayCardRequestMessage → Move
-    BraendiDog::Move target_move(req.move);
-
-    // 3. Validate move using GameState logic
-    if (!gs.isValidTurn(target_move)) {
-      PlayCardResponseMessage resp(handIndex, false, "Invalid move");
-      return messagePlayer(playerId, resp.toJson());
-    }
-
-    // DEGUG: cout gamestate hands
-    for (size_t i = 0; i < 4; i++) {
-      auto playerOpt = gs.getPlayerByIndex(i);
-      if (playerOpt.has_value()) {
-        const auto& player = playerOpt.value();
-        const auto& hand = player.getHand();
-        std::cout << "Player " << i << " hand: ";
-        for (const auto& cardIdx : hand) {
-          std::cout << cardIdx << " ";
-        }
-        std::cout << std::endl;
+    while (open && !session->closed) {
+      auto message = connection.nextMessage();
+      if (!message) {
+        break;
       }
+      open = handleMessage(*session, *message);
     }
-
-    // 4. Execute the move
-    bool playerFinished = gs.executeMove(target_move);
-    auto [gameEnded, roundEnded] = gs.endTurn();
-
-    // 6. Respond
-    PlayCardResponseMessage resp(handIndex, true, "");
-    messagePlayer(playerId, resp.toJson());
-
-    // 7. Broadcast updated game state
-    broadcastGameState();
-
-    // 8. If player finished, broadcast message
-    if (playerFinished) {
-      PlayerFinishedMessage finishMsg(static_cast<size_t>(playerId));
-      broadcastMessage(finishMsg.toJson());
-    }
-
-    // 9. Broadcast game end if needed
-    if (gameEnded) {
-      handleGameEnd();
-    }
-    // 10. Deal cards again if round ended
-    else if (roundEnded) {
-      newRound();
-    }
-
-  } catch (const std::exception& e) {
-    logError("Could not make a move — " + std::string(e.what()));
-
-    PlayCardResponseMessage resp(handIndex, false, e.what());
-    return messagePlayer(playerId, resp.toJson());
-  }
-}
-
-void Server::handleSkipTurn(int playerId) {
-  if (!gameRunning_ || !game_) {
-    SkipTurnResponseMessage resp(false, "No game is running");
-    return messagePlayer(playerId, resp.toJson());
+  } catch (const BraendiDog::FramingError& ex) {
+    logError("Connection " + std::to_string(connection.getId()) + ": " +
+             ex.what());
+    open = false;
   }
-
-  auto& gs = *game_;
-
-  // 1. Check if it's the current player's
-  if (!gs.isMyTurn(static_cast<size_t>(playerId))) {
-    SkipTurnResponseMessage resp(false, "Not your turn");
-    return messagePlayer(playerId, resp.toJson());
-  }
-
-  try {
-    // 2. Validate fold using GameState logic
-    if (!gs.isValidTurn()) {
-      SkipTurnResponseMessage resp(false, "Invalid fold - legal moves exist");
-      return messagePlayer(playerId, resp.toJson());
-    }
-
-    // 3. Execute the fold
-    gs.executeFold();
-    auto [gameEnded, roundEnded] = gs.endTurn();
-
-    // 4. Respond
-    SkipTurnResponseMessage resp(true, "");
-    messagePlayer(playerId, resp.toJson());
-
-    // 5. Broadcast updated game state
-    broadcastGameState();  // Player status has changed
-
-    // 6. Broadcast game end if needed
-    if (gameEnded) {
-      handleGameEnd();
-    }
-
-    // 7. Deal cards again if round ended
-    else if (roundEnded) {
-      newRound();
-    }
-
-  } catch (const std::exception& e) {
-    logError("Could not skip turn — " + std::string(e.what()));
-
-    SkipTurnResponseMessage resp(false, e.what());
-    return messagePlayer(playerId, resp.toJson());
+  if (!open) {
+    closeSession(*session);
   }
 }
 
-void Server::newRound() {
-  log("Starting new round.");
-  auto dealtCards = game_->dealCards();
+bool Server::handleMessage(Session& session, std::string_view message) {
+  Connection& connection = *session.connection;
+  const size_t connectionId = connection.getId();
 
-  for (const auto& [id, hand] : dealtCards) {
-    // Save in game state
-    auto& playerOpt = game_->getPlayerByIndex(id);
-    if (playerOpt.has_value()) {
-      playerOpt.value().setHand(hand);
+  try {
+    auto parsedMessage = BraendiDog::decodeMessage(message);
+
+    BD_LOG_TRACE("Server", "Received message from connection "
+                               << connectionId << ":\n "
+                               << parsedMessage->toString(-1));
+
+    MessageType messageType = parsedMessage->getMessageType();
+
+    if (messageType == MessageType::REQ_LIST_ROOMS) {
+      auto* msg = static_cast<ListRoomsRequestMessage*>(parsedMessage.get());
+      ListRoomsResponseMessage resp(listRooms(msg->openOnly));
+      connection.send(resp);
+    } else if (messageType == MessageType::REQ_CONNECT ||
+               messageType == MessageType::REQ_CREATE_ROOM ||
+               messageType == MessageType::REQ_JOIN_ROOM) {
+      if (session.room) {
+        connection.send(*roomResponse(*parsedMessage, false,
+                                      "Already in a room",
+                                      session.room->getId(), -1,
+                                      connection.getWireFormat()));
+      } else {
+        session.room = enterRoom(session.connection, *parsedMessage);
+      }
+    } else if (session.room) {
+      session.room->handleMessage(connectionId, std::move(parsedMessage));
     } else {
-      std::cerr << "Error: Could not find player " << id
-                << " in game state when dealing new round cards!" << std::endl;
-      continue;
+      logError("Connection " + std::to_string(connectionId) + " sent " +
+               messageTypeToString(messageType) + " outside of a room");
     }
-    // Send private message to each player with their dealt cards
-    CardsDealtMessage cardsMsg(id, hand);
-    messagePlayer(static_cast<int>(id), cardsMsg.toJson());
+  } catch (const std::exception& ex) {
+    logError("Error handling action from connection " +
+             std::to_string(connectionId) + ": " + ex.what());
+    return false;
   }
+  return true;
 }
 
-void Server::handleGameEnd() {
-  log("Game ended, releaseing rankings.");
-
-  // Build a simple results message from leaderBoard
-  const auto& leaderboard = game_->getLeaderBoard();
+void Server::closeSession(Session& session) {
+  if (session.closed) {
+    return;
+  }
+  session.closed = true;
 
-  GameResultsMessage resultsMsg(leaderboard);
-  broadcastMessage(resultsMsg.toJson());
+  const size_t connectionId = session.connection->getId();
+  log("Connection " + std::to_string(connectionId) + " closed.");
 
-  gameRunning_ = false;
-  running_ = false;
+  // Free the seat, the last player closes the room
+  if (session.room) {
+    size_t roomId = session.room->getId();
+    session.room->leave(connectionId, [this, roomId]() { removeRoom(roomId); });
+  }
+  session.room.reset();
+  session.connection->close();
 
-  std::this_thread::sleep_for(std::chrono::seconds(300));
-  acceptor_.shutdown();
-  acceptor_.close();
+  std::lock_guard<std::mutex> lock(connectionsMutex_);
+  sessions_.erase(connectionId);
 }
 
-void Server::handleDisconnect(const size_t playerId) {
-  {
-    std::lock_guard<std::mutex> lock(playersMutex_);
-
-    auto& p = players_[playerId];
-
-    // Close socket
-    if (p.socket) {
-      p.socket->shutdown();
-      p.socket->close();
+std::shared_ptr<Room> Server::enterRoom(
+    const std::shared_ptr<Connection>& connection, const Message& message) {
+  std::string name;
+  std::string roomName;
+  std::optional<size_t> roomId;
+  size_t wireFormat = 0;
+  switch (message.getMessageType()) {
+    case MessageType::REQ_CREATE_ROOM: {
+      const auto& req = static_cast<const CreateRoomRequestMessage&>(message);
+      name = req.name;
+      roomName = req.roomName;
+      wireFormat = req.wireFormat;
+      break;
     }
-
-    // Update player info
-    p.isActive = false;
-    p.isReady = false;
-    p.socket = nullptr;
-
-    numPlayers_--;
-
-    // Re-arrange Player ID's if game hasn't started
-    if (!gameRunning_) {
-      std::array<ClientInfo, 4> updatedPlayers;
-
-      int assignmentIdx = 0;
-
-      for (auto& p : players_) {
-        if (p.isActive) {
-          size_t updatedId = idAssignmentOrder[assignmentIdx];
-
-          updatedPlayers[updatedId] = std::move(p);
-          updatedPlayers[updatedId].id = updatedId;
-          assignmentIdx++;
-        }
-      }
-      players_ = std::move(updatedPlayers);
+    case MessageType::REQ_JOIN_ROOM: {
+      const auto& req = static_cast<const JoinRoomRequestMessage&>(message);
+      name = req.name;
+      roomId = req.roomId;
+      wireFormat = req.wireFormat;
+      break;
     }
-
-    log("Cleaned up after disconnected player " + std::to_string(playerId));
-  }
-
-  // Send disconnect message to remaining players
-  PlayerDisconnectedMessage disconnectMsg(playerId);
-  broadcastMessage(disconnectMsg.toJson());
-
-  // LOBBY -> update player list
-  if (!gameRunning_) {
-    broadcastPlayerList();
-  }
-  // MAIN GAME -> update game state
-  else {
-    // Update gamestate and call gamestate update
-    game_->disconnectPlayer(playerId);
-    broadcastGameState();
-
-    if (!shuttingDown_ && numPlayers_ <= 1) {
-      handleGameEnd();
+    default: {
+      const auto& req = static_cast<const ConnectionRequestMessage&>(message);
+      name = req.name;
+      wireFormat = req.wireFormat;
+      break;
     }
   }
-}
-
-void Server::handleNewMessage(int threadId) {
-  while (true) {
-    int playerId = -1;
-    sockpp::tcp_socket* socket = nullptr;
-
-    // Find current player by threadId and get socket - all under lock
-    {
-      std::lock_guard<std::mutex> lock(playersMutex_);
-
-      // Find player based on thread ID
-      for (auto& p : players_) {
-        if (p.threadId == threadId && p.isActive) {
-          playerId = p.id;
-          break;
-        }
-      }
 
-      // Exit if player not found or inactive
-      if (playerId < 0) {
-        return;
-      }
+  // The response is the first message in the negotiated format
+  const BraendiDog::WireFormat format =
+      BraendiDog::negotiateWireFormat(wireFormat);
+  connection->setWireFormat(format);
 
-      // Exit if no socket
-      if (!players_[playerId].socket) {
-        return;
+  while (true) {
+    std::shared_ptr<Room> room;
+    if (roomId.has_value()) {
+      room = findRoom(roomId.value());
+      if (!room) {
+        connection->send(*roomResponse(message, false, "Room not found",
+                                       roomId.value(), -1, format));
+        return nullptr;
       }
-
-      socket = players_[playerId].socket.get();
+    } else if (message.getMessageType() == MessageType::REQ_CONNECT) {
+      room = findJoinableRoom();
+    }
+    bool created = !room;
+    if (created) {
+      room = createRoom(roomName);
     }
 
-    try {
-      char buf[1024];
-      ssize_t n = socket->read(buf, sizeof(buf));
-
-      // Connection closed or error reading from socket
-      if (n <= 0) {
-        log("Player " + std::to_string(playerId) + " disconnected.");
-        handleDisconnect(playerId);
-        break;
-      }
-
-      std::string message(buf, n);
-      nlohmann::json messageJson = nlohmann::json::parse(message);
-
-      log("Received message from client " + std::to_string(playerId) + ":\n " +
-          message);
-
-      auto parsedMessage = Message::fromJson(messageJson);
-      MessageType messageType = parsedMessage->getMessageType();
-
-      log("Parsed message from player " + std::to_string(playerId) + ":\n " +
-          parsedMessage->toString());
-
-      if (messageType == MessageType::REQ_READY) {
-        if (game_ && gameRunning_) {
-          std::string errorMsg =
-              "Game is already in progress, cannot set player as ready";
-          logError(errorMsg);
-          ReadyResponseMessage resp = ReadyResponseMessage(false, errorMsg);
-        }
-
-        setPlayerReady(messageJson["playerId_"]);
-        broadcastPlayerList();
-      } else if (messageType == MessageType::REQ_START_GAME) {
-        log("Player " + std::to_string(playerId) + " requested to start game");
-
-        if (game_ && gameRunning_) {
-          std::string errorMsg =
-              "Game is already in progress, cannot start a new game";
-          logError(errorMsg);
-          StartGameResponseMessage resp =
-              StartGameResponseMessage(false, errorMsg);
-        }
-
-        if (areAllPlayersReady() && numPlayers_ >= 2) {
-          log("Starting game with " + std::to_string(numPlayers_));
-          startGame();
-        } else {
-          std::string errorMsg =
-              "Start Game request denied: Not all players are ready. Current "
-              "number of players: " +
-              std::to_string(numPlayers_);
-          logError(errorMsg);
-          StartGameResponseMessage resp =
-              StartGameResponseMessage(false, errorMsg);
-        }
-      } else if (messageType == MessageType::REQ_PLAY_CARD) {
-        auto* msg = static_cast<PlayCardRequestMessage*>(parsedMessage.get());
-        log("Player " + std::to_string(playerId) +
-            " requested to play the card at handIndex : " +
-            std::to_string(msg->move.handIndex));
-        handlePlayCard(msg->move.handIndex, playerId, *msg);
-      } else if (messageType == MessageType::REQ_SKIP_TURN) {
-        log("Player " + std::to_string(playerId) +
-            " requested to skip their turn");
-        handleSkipTurn(playerId);
+    int playerId = room->join(connection, name, [&](int seat) {
+      return roomResponse(message, true, "", room->getId(), seat, format);
+    });
+    if (playerId >= 0) {
+      if (created) {
+        addRoom(room);
       }
-    } catch (const std::exception& ex) {
-      logError("Error handling action from player " + std::to_string(playerId) +
-               ": " + ex.what());
-      break;
+      log("Connection " + std::to_string(connection->getId()) +
+          " joined room " + std::to_string(room->getId()) + " as player " +
+          std::to_string(playerId));
+      return room;
     }
-  }
-}
-
-bool Server::isValidName(const std::string name) const {
-  // Name must be a non-empty string
-  if (name.empty()) {
-    logError("Name cannot be empty");
-    return false;
-  }
-
-  // Name must be unique
-  for (auto& player : players_) {
-    if (player.name == name) {
-      logError("Player with name " + name + " already exists");
-      return false;
+    if (roomId.has_value()) {
+      connection->send(*roomResponse(message, false,
+                                     "Room is full or a game is running",
+                                     roomId.value(), -1, format));
+      return nullptr;
     }
+    // Another client took the last seat first, try the next room
   }
-  return true;
 }
 
-void Server::setPlayerReady(int playerId) {
-  log("setPlayerReady Function called by " + std::to_string(playerId));
-
-  if (playerId < 0 || playerId >= 4) {
-    return;
+std::shared_ptr<Room> Server::createRoom(std::string name) {
+  std::lock_guard<std::mutex> lock(roomsMutex_);
+  size_t id = nextRoomId_++;
+  if (name.empty()) {
+    name = "Room " + std::to_string(id);
   }
-
-  std::lock_guard<std::mutex> lock(playersMutex_);
-  auto& p = players_[playerId];
-  if (!p.isActive) return;  // Check if player is active
-
-  p.isReady = true;
-  log("Player " + std::to_string(playerId) + " is ready!");
+  return std::make_shared<Room>(id, std::move(name), workers_);
 }
 
-bool Server::areAllPlayersReady() const {
-  log("areAllPlayersReady Function called.");
-
-  std::lock_guard<std::mutex> lock(playersMutex_);
-  int numReady = 0;
-
-  for (const auto& player : players_) {
-    if (!player.isActive) {
-      continue;
-    }
-
-    if (!player.isReady) {
-      log("Player " + std::to_string(player.id) + " is not ready");
-      return false;  // If any player is not ready, return false
-    }
-    numReady++;
-  }
-
-  log(std::to_string(numReady) + "/" + std::to_string(numReady) +
-      " players are ready.");
-  return true;
+void Server::addRoom(std::shared_ptr<Room> room) {
+  std::lock_guard<std::mutex> lock(roomsMutex_);
+  rooms_[room->getId()] = std::move(room);
 }
 
-void Server::startGame() {
-  log("All players ready, starting game...");
-
-  // Build list of players for GameState
-  auto gamePlayers = getPlayerNames();
-
-  // Initialize Game
-  game_ = std::make_unique<BraendiDog::GameState>(gamePlayers);
-  gameRunning_ = true;
-
-  // Notify clients game is starting
-  GameStartMessage startMsg(numPlayers_);
-  broadcastMessage(startMsg.toJson());
-
-  // Broadcast initial game state
-  broadcastGameState();
-
-  // Deal cards and send to each active player
-  newRound();
-}
-
-void Server::messagePlayer(int playerId, const nlohmann::json& message) const {
-  if (!running_ || shuttingDown_) {
-    log("Server not running, cannot send message");
-    return;
-  }
-
-  if (playerId < 0 || playerId >= 4) {
-    log("Sending message to invalid player ID.");
-    return;
-  }
-
-  // Get socket pointer under lock to prevent race conditions
-  sockpp::tcp_socket* socket = nullptr;
-  {
-    std::lock_guard<std::mutex> lock(playersMutex_);
-    auto& p = players_[playerId];
-    if (!p.isActive || !p.socket) {
-      log("Sending message to inactive player.");
-      return;
+std::shared_ptr<Room> Server::findJoinableRoom() const {
+  std::lock_guard<std::mutex> lock(roomsMutex_);
+  for (const auto& [id, room] : rooms_) {
+    if (room->isJoinable()) {
+      return room;
     }
-    socket = p.socket.get();
-  }
-
-  // Send message without holding lock (I/O should not block mutex)
-  try {
-    std::string data = message.dump() + "\n";
-    socket->write(data);
-
-    log("Sending message to " + std::to_string(playerId) + ": " + data);
-  } catch (const std::exception& e) {
-    logError("Failed to send message to player " + std::to_string(playerId) +
-             ": " + e.what());
   }
+  return nullptr;
 }
 
-void Server::broadcastMessage(const nlohmann::json& message) const {
-  // Collect active player IDs under lock to avoid race conditions with ID
-  // reassignment
-  std::vector<int> activePlayerIds;
-  {
-    std::lock_guard<std::mutex> lock(playersMutex_);
-    for (const auto& p : players_) {
-      if (p.isActive) {
-        activePlayerIds.push_back(p.id);
-      }
-    }
-  }
-
-  // Send messages without holding the lock (I/O should not block mutex)
-  for (int playerId : activePlayerIds) {
-    messagePlayer(playerId, message);
-  }
+std::shared_ptr<Room> Server::findRoom(size_t roomId) const {
+  std::lock_guard<std::mutex> lock(roomsMutex_);
+  auto it = rooms_.find(roomId);
+  return it == rooms_.end() ? nullptr : it->second;
 }
 
-void Server::broadcastGameState() const {
-  log("Broadcasting game state");
-
-  GameStateUpdateMessage msg(*game_);
-  broadcastMessage(msg.toJson());
+void Server::removeRoom(size_t roomId) {
+  std::lock_guard<std::mutex> lock(roomsMutex_);
+  rooms_.erase(roomId);
+  log("Room " + std::to_string(roomId) + " closed, " +
+      std::to_string(rooms_.size()) + " rooms open");
 }
 
-void Server::broadcastPlayerList() const {
-  log("Broadcasting player list");
-
-  std::vector<PlayerInfo> playersInfo;
-
-  {
-    std::lock_guard<std::mutex> lock(playersMutex_);
-    for (const auto& p : players_) {
-      if (!p.isActive) continue;
-
-      PlayerInfo info;
-      info.id = p.id;
-      info.name = p.name;
-      info.ready = p.isReady;
-      playersInfo.push_back(info);
+std::vector<RoomInfo> Server::listRooms(bool openOnly) const {
+  std::vector<RoomInfo> rooms;
+  std::lock_guard<std::mutex> lock(roomsMutex_);
+  rooms.reserve(rooms_.size());
+  for (const auto& [id, room] : rooms_) {
+    if (!openOnly || room->isJoinable()) {
+      rooms.push_back(room->getInfo());
     }
   }
-
-  PlayerListUpdateMessage msg(playersInfo);
-  broadcastMessage(msg.toJson());
+  return rooms;
 }
 
 void Server::log(const std::string& message) const {
-  std::cout << "[Server] " << message << std::endl;
+  BD_LOG_INFO("Server", message);
 }
 
 void Server::logError(const std::string& message) const {
-  std::cout << "[ERROR] " << message << std::endl << std::flush;
-
-  std::cerr << "[ERROR] " << message << std::endl << std::flush;
-}
-
-// Logs a player's action to the console
-void Server::logPlayerAction(int playerId,
-                             const nlohmann::json& actionJson) const {
-  std::cout << "[Action] Player " << playerId << ": " << actionJson.dump()
-            << std::endl;
+  BD_LOG_ERROR("Server", message);
 }
@@ -5,18 +5,34 @@
 #include <sockpp/tcp_socket.h>
 
 #include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <nlohmann/json.hpp>
-#include <thread>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
-#include "shared/game.hpp"
+#include "server/connection.hpp"
+#include "server/reactor.hpp"
+#include "server/room.hpp"
+#include "server/worker_pool.hpp"
 #include "shared/messages.hpp"
 
 /**
  * @class Server
- * @brief Handles the game server, including client connections and invoking
- * game logic.
+ * @brief Handles the game server: accepts client connections and hosts any
+ * number of independent rooms, each running its own game.
+ *
+ * A client enters a room with REQ_CONNECT (oldest room with a free seat, a new
+ * one if there is none), REQ_CREATE_ROOM or REQ_JOIN_ROOM. REQ_LIST_ROOMS may
+ * be sent at any time.
+ *
+ * All sockets are non-blocking and served by a Reactor with a small fixed
+ * number of IO threads, which parse the requests and hand them to the rooms.
+ * The rooms run their events on a shared WorkerPool, one at a time per room.
  */
 class Server {
  public:
@@ -24,10 +40,16 @@ class Server {
    * @brief Constructs a Server object.
    * @param serverAddress The address of the server.
    * @param port The port number the server listens on.
-   * @param connectionTimeout The number of seconds to wait until a connection
-   * is considered inactive.
+   * @param connectionTimeout The number of seconds a new connection has to
+   * enter a room before it is closed.
+   * @param ioThreads Number of IO threads, 0 to pick one per core (at most 4).
+   * @param sendLimits Bound of each connection's send queue.
+   * @param workerThreads Number of threads running the rooms, 0 for one per
+   * core.
    */
-  Server(std::string serverAddress, int port, int connectionTimeout);
+  Server(std::string serverAddress, int port, int connectionTimeout,
+         size_t ioThreads = 0, SendQueueLimits sendLimits = {},
+         size_t workerThreads = 0);
 
   /**
    * @brief Destructs a Server object.
@@ -35,7 +57,7 @@ class Server {
   ~Server();
 
   /**
-   * @brief Starts the server and initializes the game.
+   * @brief Starts the server and serves clients until it is stopped.
    * @throws std::runtime_error if the server fails to start.
    */
   void start();
@@ -46,207 +68,141 @@ class Server {
   void stop();
 
   /**
-   * @brief Runs the game loop
+   * @brief Gets the number of open rooms.
    */
-  void run();
+  size_t getNumRooms() const;
 
   /**
-   * @brief Checks the number of players that are connected to the server.
-   * @return Number of currently connected players
+   * @brief Gets the counters of the threads running the rooms.
    */
-  int getNumPlayers() const;
-
-  /**
-   * @brief Marks a player as ready.
-   * @param playerId The ID of the player
-   */
-  void setPlayerReady(int playerId);
-
-  /**
-   * @brief Checks if all players are ready to start the game.
-   * @return True if all players are ready, false otherwise.
-   */
-  bool areAllPlayersReady() const;
+  std::vector<WorkerPool::Stats> getWorkerStats() const;
 
  private:
-  /** @brief Player-specific data slot. */
-  struct ClientInfo {
-    ClientInfo() = default;
-
-    // ENABLE MOVE
-    ClientInfo(ClientInfo&&) = default;
-    ClientInfo& operator=(ClientInfo&&) = default;
-
-    // DELETE COPY
-    ClientInfo(const ClientInfo&) = delete;
-    ClientInfo& operator=(const ClientInfo&) = delete;
-
-    int threadId = -1;  ///< ID to identify the listener thread of the client
-    int id = -1;        ///< ID of the player
-    std::unique_ptr<sockpp::tcp_socket>
-        socket;             ///< Connection socket of the client
-    std::string name;       ///< Player name.
-    bool isActive = false;  ///< Whether the player is connected.
-    bool isReady = false;   ///< Whether the player is ready to start.
-  };
+  /// Interval of the worker statistics in the log
+  static constexpr std::chrono::seconds statsInterval{60};
 
   sockpp::tcp_acceptor acceptor_;  ///< TCP acceptor for handling connections.
 
   std::string serverAddress_;  ///< Address of the server.
   int port_;                   ///< Port number for the server.
 
-  mutable std::mutex playersMutex_;  ///< Protects players_ and numPlayers_ from
-                                     ///< race conditions
+  mutable std::mutex roomsMutex_;  ///< Protects rooms_ and nextRoomId_.
+  std::map<size_t, std::shared_ptr<Room>>
+      rooms_;              ///< Open rooms by ID, oldest first.
+  size_t nextRoomId_ = 0;  ///< ID of the next room.
 
-  int numPlayers_ = 0;  ///< Number of players.
-  std::array<ClientInfo, 4>
-      players_;  ///< Fixed slots for up to 4 players in the game (IDs 0–3).
+  /** @brief State of one client connection. */
+  struct Session {
+    std::shared_ptr<Connection> connection;
+    std::shared_ptr<Room> room;  ///< Room entered, nullptr before.
+    bool closed = false;         ///< Whether the session was torn down.
+  };
 
-  static const std::vector<int> idAssignmentOrder;
+  Reactor reactor_;             ///< IO threads serving all sockets.
+  SendQueueLimits sendLimits_;  ///< Bound of each connection's send queue.
+  WorkerPool workers_;          ///< Threads running the rooms' events.
 
-  std::unique_ptr<BraendiDog::GameState> game_;  ///< Game instance.
-  bool gameRunning_ = false;  ///< Flag to control game running status
-  bool running_ = true;       ///< Flag to control server status
+  mutable std::mutex connectionsMutex_;  ///< Protects sessions_.
+  std::unordered_map<size_t, std::shared_ptr<Session>>
+      sessions_;                 ///< Connected clients by connection ID.
+  size_t nextConnectionId_ = 0;  ///< ID of the next connection.
 
+  std::atomic<bool> running_{true};  ///< Flag to control server status
   std::atomic<bool> shuttingDown_{
       false};  ///< Atomic flag to control server shutdown status
 
-  std::vector<std::thread> clientThreads_;
-  std::mutex threadsMutex_;
-
   std::chrono::seconds
-      connectionTimeout_;  ///< Seconds until an unresponsive client is
-                           ///< considered disconnected.
-
-  /**
-   * @brief Waits for human players to connect.
-   * @throws std::runtime_error if connection issues occur.
-   */
-  void waitForPlayers();
-
-  /**
-   * @brief Handles when a new player joins the server.
-   * @param sock The connection to the user provided by Sockpp.
-   * @return Returns the ID of the newly connected player.
-   */
-  int handleNewConnection(sockpp::tcp_socket sock);
-
-  /**
-   * @brief Handles post-connection workflow (broadcasts player list).
-   */
-  void onSuccessfulConnection();
+      connectionTimeout_;  ///< Seconds a new connection has to enter a room.
 
-  /**
-   * @brief Checks if a player's name is non-empty and unique.
-   * @param name The name of the player requesting to connect.
-   * @return Returns whether the name is valid.
-   */
-  bool isValidName(const std::string name) const;
+  std::vector<WorkerPool::Stats>
+      loggedStats_;  ///< Worker counters at the last log (first loop only).
 
   /**
-   * @brief Sends a broadcast of the current player list to all active clients.
+   * @brief Accepts all pending connections (listening socket readable).
    */
-  void broadcastPlayerList() const;
+  void acceptConnections();
 
   /**
-   * @brief Checks the connection status of all clients, and updates any
-   * disconnected players.
+   * @brief Sets up a session for an accepted socket on one of the loops.
    */
-  void checkConnections();
+  void openSession(sockpp::tcp_socket socket);
 
   /**
-   * @brief Starts the game when all players are ready.
+   * @brief Handles the socket events of a session (on its loop thread).
    */
-  void startGame();
+  void handleEvents(const std::shared_ptr<Session>& session, uint32_t events);
 
   /**
-   * @brief Processes actions from a connected player.
-   * @param playerId The ID of the player.
+   * @brief Processes one message of a session.
+   * @return False if the connection should be closed.
    */
-  void handleNewMessage(int playerId);
+  bool handleMessage(Session& session, std::string_view message);
 
   /**
-   * @brief Broadcasts the game state to all connected players.
+   * @brief Frees the seat of a closed connection and forgets it (on its loop
+   * thread).
    */
-  void broadcastGameState() const;
+  void closeSession(Session& session);
 
   /**
-   * @brief Sends a message to a specific player.
+   * @brief Handles a request to enter a room (REQ_CONNECT, REQ_CREATE_ROOM or
+   * REQ_JOIN_ROOM).
+   * @param connection Connection of the requesting client.
+   * @param message The parsed request.
+   * @return Joined room, nullptr if the request was refused.
    */
-  void messagePlayer(int playerId, const nlohmann::json& message) const;
+  std::shared_ptr<Room> enterRoom(const std::shared_ptr<Connection>& connection,
+                                  const Message& message);
 
   /**
-   * @brief Broadcasts a message to all active players.
+   * @brief Creates an empty room, registered once its creator is seated.
+   * @param name Display name, a default name if empty.
    */
-  void broadcastMessage(const nlohmann::json& message) const;
+  std::shared_ptr<Room> createRoom(std::string name);
 
   /**
-   * @brief Logs general server information or state.
+   * @brief Registers a room so it can be listed and joined.
    */
-  void log(const std::string& message) const;
+  void addRoom(std::shared_ptr<Room> room);
 
   /**
-   * @brief Logs error messages to CERR.
+   * @brief Finds the oldest room with a free seat and no running game.
+   * @return The room, nullptr if there is none.
    */
-  void logError(const std::string& message) const;
+  std::shared_ptr<Room> findJoinableRoom() const;
 
   /**
-   * @brief Logs a player's action.
-   * @param playerId The ID of the player.
-   * @param actionJson The JSON representation of the action.
+   * @brief Looks up a room by ID.
+   * @return The room, nullptr if there is none.
    */
-  void logPlayerAction(int playerId, const nlohmann::json& actionJson) const;
+  std::shared_ptr<Room> findRoom(size_t roomId) const;
 
   /**
-   * @brief Retrieves the names of all active players.
-   * @return Array of optional player names indexed by player ID.
+   * @brief Removes a room after its last player left (on its strand).
    */
-  std::array<std::optional<std::string>, 4> getPlayerNames() const;
+  void removeRoom(size_t roomId);
 
   /**
-   * @brief Handles a client's request to play a card.
-   *
-   * Validates the move contained in the PlayCardRequestMessage, checks turn
-   * order, executes the move if legal, updates the game state, and sends the
-   * appropriate response back to the client. If the round or game ends as a
-   * result of the move, this function triggers the required round- or game-end
-   * logic.
-   *
-   * @param playerId The ID of the player attempting to play a card.
-   * @param req The incoming PlayCardRequestMessage containing the move details.
+   * @brief Lists the rooms.
+   * @param openOnly Only list rooms that can be joined.
    */
-  void handlePlayCard(size_t handIndex, int playerId,
-                      const PlayCardRequestMessage& req);
+  std::vector<RoomInfo> listRooms(bool openOnly) const;
 
   /**
-   * @brief Handles a player's request to skip their turn.
-   * @param playerId The ID of the player requesting to skip their turn.
+   * @brief Logs the throughput and queueing delays of every worker over the
+   * last interval and schedules the next log (on the first loop).
    */
-  void handleSkipTurn(int playerId);
+  void logWorkerStats();
 
   /**
-   * @brief Deals cards to all active players and transmits their hands.
-   */
-  void dealCards() const;
-
-  /**
-   * @brief Starts a new round of the game.
-   *
-   * Called when the previous round ends or a new game is started. Distributes a
-   * fresh set of cards, resets per-round player state, and broadcasts related
-   * updates.
-   */
-  void newRound();
-
-  /**
-   * @brief Broadcasts end-of-game results and performs necessary clean up.
+   * @brief Logs general server information or state.
    */
-  void handleGameEnd();
+  void log(const std::string& message) const;
 
   /**
-   * @brief Updates game state and clients when a client disconnects
+   * @brief Logs error messages to CERR.
    */
-  void handleDisconnect(const size_t playerId);
+  void logError(const std::string& message) const;
 };
 
 #endif  // SERVER_HPP
@@ -0,0 +1,245 @@
+#include "server/worker_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <exception>
+#include <utility>
+
+#include "shared/logging.hpp"
+
+namespace {
+// Pool and index of the worker running on this thread
+thread_local const WorkerPool* currentPool = nullptr;
+thread_local size_t currentIndex = WorkerPool::anyWorker;
+}  // namespace
+
+std::chrono::microseconds WorkerPool::Stats::waitPercentile(double p) const {
+  size_t total = 0;
+  for (size_t count : waitBuckets) {
+    total += count;
+  }
+  if (total == 0) {
+    return std::chrono::microseconds(0);
+  }
+
+  const size_t rank = std::max<size_t>(
+      1, static_cast<size_t>(std::ceil(p * static_cast<double>(total))));
+  size_t seen = 0;
+  for (size_t i = 0; i < waitBuckets.size(); ++i) {
+    seen += waitBuckets[i];
+    if (seen >= rank) {
+      return std::chrono::microseconds(int64_t{1} << i);
+    }
+  }
+  return maxWait;
+}
+
+// Constructor: Starts the threads
+WorkerPool::WorkerPool(size_t numThreads) {
+  const size_t count = std::max<size_t>(numThreads, 1);
+  workers_.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // Started once all deques exist, the workers steal from each other
+  for (size_t i = 0; i < count; ++i) {
+    workers_[i]->thread = std::thread(&WorkerPool::run, this, i);
+  }
+}
+
+// Destructor
+WorkerPool::~WorkerPool() { stop(); }
+
+size_t WorkerPool::getNumThreads() const { return workers_.size(); }
+
+size_t WorkerPool::currentWorker() const {
+  return currentPool == this ? currentIndex : anyWorker;
+}
+
+void WorkerPool::submit(Task task, size_t worker) {
+  if (stopped_) {
+    return;
+  }
+  size_t index = worker < workers_.size() ? worker : currentWorker();
+  if (index == anyWorker) {
+    index = nextWorker_.fetch_add(1) % workers_.size();
+  }
+
+  {
+    // Counted before it can be taken, take() decrements under the same lock
+    std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+    ++queued_;
+    workers_[index]->tasks.push_back({std::move(task), Clock::now()});
+  }
+  wakeFor(index);
+}
+
+std::vector<WorkerPool::Stats> WorkerPool::getStats() const {
+  std::vector<Stats> stats;
+  stats.reserve(workers_.size());
+  for (const auto& worker : workers_) {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    stats.push_back(worker->stats);
+  }
+  return stats;
+}
+
+void WorkerPool::stop() {
+  if (stopped_.exchange(true)) {
+    return;
+  }
+  for (auto& worker : workers_) {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->signaled = true;
+    worker->wake.notify_one();
+  }
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+
+  // Dropped outside the locks, tasks may own what posts new ones
+  for (auto& worker : workers_) {
+    std::deque<Entry> dropped;
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      dropped.swap(worker->tasks);
+    }
+  }
+  queued_ = 0;
+}
+
+void WorkerPool::run(size_t index) {
+  currentPool = this;
+  currentIndex = index;
+  Worker& self = *workers_[index];
+
+  while (!stopped_) {
+    Entry entry;
+    bool stolen = false;
+    if (take(index, entry, stolen)) {
+      const auto start = Clock::now();
+      entry.task();
+      const auto end = Clock::now();
+      const auto wait = std::chrono::duration_cast<std::chrono::microseconds>(
+          start - entry.queued);
+      const size_t bucket = std::min<size_t>(
+          std::bit_width(static_cast<uint64_t>(wait.count())),
+          self.stats.waitBuckets.size() - 1);
+
+      std::lock_guard<std::mutex> lock(self.mutex);
+      ++self.stats.tasks;
+      self.stats.stolen += stolen ? 1 : 0;
+      self.stats.busy +=
+          std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+      self.stats.maxWait = std::max(self.stats.maxWait, wait);
+      ++self.stats.waitBuckets[bucket];
+      continue;
+    }
+
+    // Nothing to do anywhere. A task queued after take() looked is either
+    // counted in queued_ here or its submitter sees this worker sleeping.
+    std::unique_lock<std::mutex> lock(self.mutex);
+    self.sleeping = true;
+    self.wake.wait(lock, [this, &self]() {
+      return stopped_ || self.signaled || !self.tasks.empty() || queued_ > 0;
+    });
+    self.sleeping = false;
+    self.signaled = false;
+  }
+}
+
+bool WorkerPool::take(size_t index, Entry& entry, bool& stolen) {
+  {
+    Worker& self = *workers_[index];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    if (!self.tasks.empty()) {
+      entry = std::move(self.tasks.front());
+      self.tasks.pop_front();
+      --queued_;
+      return true;
+    }
+  }
+  if (queued_ == 0) {
+    return false;
+  }
+
+  // Steal the oldest task of the next peer that has one
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker& peer = *workers_[(index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(peer.mutex);
+    if (!peer.tasks.empty()) {
+      entry = std::move(peer.tasks.front());
+      peer.tasks.pop_front();
+      --queued_;
+      stolen = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkerPool::wakeFor(size_t index) {
+  if (wakeUp(*workers_[index])) {
+    return;
+  }
+  // The worker is busy, let an idle one steal the task
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    if (wakeUp(*workers_[(index + i) % workers_.size()])) {
+      return;
+    }
+  }
+}
+
+bool WorkerPool::wakeUp(Worker& worker) {
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  if (!worker.sleeping || worker.signaled) {
+    return false;
+  }
+  worker.signaled = true;
+  worker.wake.notify_one();
+  return true;
+}
+
+// Constructor
+Strand::Strand(WorkerPool& pool) : pool_(pool) {}
+
+void Strand::post(Task task) {
+  size_t home;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(std::move(task));
+    if (scheduled_) {
+      return;  // The worker draining the strand picks it up
+    }
+    scheduled_ = true;
+    home = home_;
+  }
+  pool_.submit([self = shared_from_this()]() { self->drain(); }, home);
+}
+
+void Strand::drain() {
+  for (size_t i = 0; i < batchSize; ++i) {
+    Task task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (tasks_.empty()) {
+        scheduled_ = false;
+        return;
+      }
+      // A steal moves the game to the thief
+      home_ = pool_.currentWorker();
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    try {
+      task();
+    } catch (const std::exception& ex) {
+      BD_LOG_ERROR("Server", "Task failed: " << ex.what());
+    }
+  }
+
+  // Give the other strands a turn, the rest runs on this worker next
+  pool_.submit([self = shared_from_this()]() { self->drain(); },
+               pool_.currentWorker());
+}
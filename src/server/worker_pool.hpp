@@ -0,0 +1,189 @@
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief A fixed set of threads running submitted tasks, shared by all rooms
+ * of the server.
+ *
+ * Every worker has its own deque. A task submitted for a worker lands in its
+ * deque, so a room keeps running where its game state is hot in the caches;
+ * a worker without work steals the oldest task of a busy peer instead of
+ * sleeping. Tasks run in no particular order and concurrently; code that
+ * needs its tasks one at a time posts them to a Strand.
+ */
+class WorkerPool {
+ public:
+  using Task = std::function<void()>;
+
+  /// Submit to any worker: the current one on a worker thread, otherwise
+  /// round robin.
+  static constexpr size_t anyWorker = std::numeric_limits<size_t>::max();
+
+  /** @brief Counters of one worker since the start. */
+  struct Stats {
+    size_t tasks = 0;   ///< Tasks run.
+    size_t stolen = 0;  ///< Tasks taken from other workers.
+    std::chrono::microseconds busy{0};     ///< Time spent running tasks.
+    std::chrono::microseconds maxWait{0};  ///< Longest queueing delay.
+    /// Queueing delays: bucket i counts waits below 2^i microseconds
+    std::array<size_t, 24> waitBuckets{};
+
+    /**
+     * @brief Gets an upper bound of a queueing delay percentile.
+     * @param p Percentile between 0 and 1, e.g. 0.99.
+     */
+    std::chrono::microseconds waitPercentile(double p) const;
+  };
+
+  /**
+   * @brief Starts the threads.
+   * @param numThreads Number of worker threads, at least one.
+   */
+  explicit WorkerPool(size_t numThreads);
+
+  /**
+   * @brief Stops the threads.
+   */
+  ~WorkerPool();
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief Gets the number of worker threads.
+   */
+  size_t getNumThreads() const;
+
+  /**
+   * @brief Runs a task on one of the workers (thread-safe).
+   * @param worker Preferred worker, anyWorker to let the pool pick. Another
+   * worker may still steal the task.
+   */
+  void submit(Task task, size_t worker = anyWorker);
+
+  /**
+   * @brief Gets the index of the calling worker, anyWorker for other
+   * threads.
+   */
+  size_t currentWorker() const;
+
+  /**
+   * @brief Gets the counters of every worker (thread-safe).
+   */
+  std::vector<Stats> getStats() const;
+
+  /**
+   * @brief Lets the running tasks finish, drops the queued ones and joins
+   * the threads (thread-safe, not from a worker).
+   */
+  void stop();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  /** @brief Task with the time it was queued. */
+  struct Entry {
+    Task task;
+    Clock::time_point queued;
+  };
+
+  /** @brief Deque, counters and thread of one worker. */
+  struct Worker {
+    mutable std::mutex mutex;  ///< Protects the fields below.
+    std::deque<Entry> tasks;   ///< Own tasks, oldest first.
+    std::condition_variable wake;
+    bool sleeping = false;  ///< Waiting on wake.
+    bool signaled = false;  ///< Woken for new work.
+    Stats stats;
+    std::thread thread;
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> queued_{0};  ///< Tasks in all deques.
+  std::atomic<size_t> nextWorker_{0};
+  std::atomic<bool> stopped_{false};
+
+  /**
+   * @brief Runs tasks until stop() is called.
+   * @param index Index of the worker.
+   */
+  void run(size_t index);
+
+  /**
+   * @brief Takes the oldest own task, or steals one from a peer.
+   * @param index Index of the taking worker.
+   * @param stolen Set if the task came from a peer.
+   */
+  bool take(size_t index, Entry& entry, bool& stolen);
+
+  /**
+   * @brief Wakes a worker for a task queued for it: the worker itself if it
+   * sleeps, otherwise a sleeping peer that can steal it.
+   */
+  void wakeFor(size_t index);
+
+  /**
+   * @brief Wakes a worker if it sleeps.
+   * @return False if it was awake.
+   */
+  bool wakeUp(Worker& worker);
+};
+
+/**
+ * @class Strand
+ * @brief Serial executor on a WorkerPool: runs the tasks posted to it one at
+ * a time and in order, on whichever worker is free.
+ *
+ * Each room posts all its events (joins, requests, disconnects) to its own
+ * strand, so the game state needs no lock while different rooms run in
+ * parallel. A strand is resubmitted to the worker that ran it last, unless
+ * another worker stole it. Create it with std::make_shared, the worker
+ * draining it keeps it alive.
+ */
+class Strand : public std::enable_shared_from_this<Strand> {
+ public:
+  using Task = WorkerPool::Task;
+
+  /**
+   * @brief Creates an idle strand.
+   * @param pool Workers running the tasks.
+   */
+  explicit Strand(WorkerPool& pool);
+
+  /**
+   * @brief Queues a task behind the ones already posted (thread-safe).
+   */
+  void post(Task task);
+
+ private:
+  /// Tasks run per turn on a worker, before the strand queues up again
+  static constexpr size_t batchSize = 64;
+
+  WorkerPool& pool_;
+  std::mutex mutex_;  ///< Protects tasks_, scheduled_ and home_.
+  std::deque<Task> tasks_;
+  bool scheduled_ = false;  ///< Submitted to the pool or draining.
+  size_t home_ = WorkerPool::anyWorker;  ///< Worker that ran it last.
+
+  /**
+   * @brief Runs queued tasks on a worker.
+   */
+  void drain();
+};
+
+#endif  // WORKER_POOL_HPP
@@ -0,0 +1,105 @@
+#include "shared/framing.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace BraendiDog {
+
+namespace {
+void checkSize(size_t size) {
+  if (size > maxFrameSize) {
+    throw FramingError("Frame of " + std::to_string(size) +
+                       " bytes exceeds the limit of " +
+                       std::to_string(maxFrameSize));
+  }
+}
+
+void writeHeader(char* header, size_t payloadSize) {
+  checkSize(payloadSize);
+  const uint32_t size = static_cast<uint32_t>(payloadSize);
+  header[0] = static_cast<char>(size >> 24);
+  header[1] = static_cast<char>(size >> 16);
+  header[2] = static_cast<char>(size >> 8);
+  header[3] = static_cast<char>(size);
+}
+}  // namespace
+
+void appendFrame(std::string& out, std::string_view payload) {
+  char header[frameHeaderSize];
+  writeHeader(header, payload.size());
+  out.append(header, frameHeaderSize);
+  out.append(payload);
+}
+
+void finishFrame(std::string& frame) {
+  if (frame.size() < frameHeaderSize) {
+    throw FramingError("Frame without header space");
+  }
+  writeHeader(frame.data(), frame.size() - frameHeaderSize);
+}
+
+std::string encodeFrame(std::string_view payload) {
+  std::string frame;
+  frame.reserve(frameHeaderSize + payload.size());
+  appendFrame(frame, payload);
+  return frame;
+}
+
+// Constructor
+FrameBuffer::FrameBuffer(size_t initialCapacity) : data_(initialCapacity) {}
+
+std::span<char> FrameBuffer::prepare(size_t minSize) {
+  // Only a partial frame is left in front of the free space, move it down
+  if (begin_ > 0) {
+    std::memmove(data_.data(), data_.data() + begin_, end_ - begin_);
+    end_ -= begin_;
+    begin_ = 0;
+  }
+  if (data_.size() - end_ < minSize) {
+    data_.resize(std::max(data_.size() * 2, end_ + minSize));
+  }
+  return {data_.data() + end_, data_.size() - end_};
+}
+
+void FrameBuffer::commit(size_t size) {
+  end_ = std::min(end_ + size, data_.size());
+}
+
+void FrameBuffer::append(std::string_view data) {
+  auto space = prepare(data.size());
+  std::memcpy(space.data(), data.data(), data.size());
+  commit(data.size());
+}
+
+std::optional<std::string_view> FrameBuffer::next() {
+  if (end_ - begin_ < frameHeaderSize) {
+    return std::nullopt;
+  }
+  const auto* header =
+      reinterpret_cast<const unsigned char*>(data_.data() + begin_);
+  const size_t size = (static_cast<size_t>(header[0]) << 24) |
+                      (static_cast<size_t>(header[1]) << 16) |
+                      (static_cast<size_t>(header[2]) << 8) | header[3];
+  checkSize(size);
+  if (end_ - begin_ < frameHeaderSize + size) {
+    return std::nullopt;
+  }
+
+  std::string_view payload(data_.data() + begin_ + frameHeaderSize, size);
+  begin_ += frameHeaderSize + size;
+  if (begin_ == end_) {
+    // Everything taken, the next read starts at the front again. The view
+    // stays valid, the bytes are only overwritten by the next read.
+    begin_ = end_ = 0;
+  }
+  return payload;
+}
+
+size_t FrameBuffer::size() const { return end_ - begin_; }
+
+size_t FrameBuffer::capacity() const { return data_.size(); }
+
+void FrameBuffer::clear() { begin_ = end_ = 0; }
+
+}  // namespace BraendiDog
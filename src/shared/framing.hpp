@@ -0,0 +1,122 @@
+/**
+ * @file framing.hpp
+ * @brief Length-prefixed frames of the client-server protocol.
+ *
+ * Every message travels as a 4-byte big-endian payload length followed by
+ * the payload. FrameBuffer reassembles frames from a byte stream in place:
+ * the socket reads straight into its storage and complete frames are handed
+ * out as views into it, so a connection reuses one buffer for its lifetime.
+ *
+ * Usage:
+ *   auto space = buffer.prepare();
+ *   buffer.commit(socket.read(space.data(), space.size()));
+ *   while (auto frame = buffer.next()) { handle(*frame); }
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace BraendiDog {
+
+/// Bytes of the length header in front of every payload.
+constexpr size_t frameHeaderSize = 4;
+
+/// Largest payload accepted, larger announced lengths are protocol errors.
+constexpr size_t maxFrameSize = 1 << 20;
+
+/**
+ * @brief Thrown when a stream does not contain valid frames.
+ */
+class FramingError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Appends one frame (header and payload) to a send buffer.
+ * @throws FramingError if the payload exceeds maxFrameSize.
+ */
+void appendFrame(std::string& out, std::string_view payload);
+
+/**
+ * @brief Writes the header of a frame built in place.
+ * @param frame frameHeaderSize reserved bytes followed by the payload.
+ * @throws FramingError if the payload exceeds maxFrameSize.
+ */
+void finishFrame(std::string& frame);
+
+/**
+ * @brief Encodes a payload as a single frame.
+ * @throws FramingError if the payload exceeds maxFrameSize.
+ */
+std::string encodeFrame(std::string_view payload);
+
+/**
+ * @brief Growable, reusable receive buffer splitting a stream into frames.
+ *
+ * Not thread safe, each connection reads into its own buffer.
+ */
+class FrameBuffer {
+ public:
+  /**
+   * @brief Creates an empty buffer.
+   * @param initialCapacity Bytes reserved up front.
+   */
+  explicit FrameBuffer(size_t initialCapacity = 4096);
+
+  /**
+   * @brief Gets writable space at the end of the buffered bytes.
+   *
+   * Moves a partial frame to the front and grows the storage if needed, which
+   * invalidates the views returned by next().
+   * @param minSize Bytes the space holds at least.
+   */
+  std::span<char> prepare(size_t minSize = 4096);
+
+  /**
+   * @brief Marks bytes written into the prepared space as received.
+   */
+  void commit(size_t size);
+
+  /**
+   * @brief Appends received bytes (copying variant of prepare and commit).
+   */
+  void append(std::string_view data);
+
+  /**
+   * @brief Takes the payload of the next complete frame.
+   * @return View into the buffer, valid until the next prepare() or append(),
+   * nullopt if no complete frame is buffered.
+   * @throws FramingError if the frame announces more than maxFrameSize.
+   */
+  std::optional<std::string_view> next();
+
+  /**
+   * @brief Gets the number of received bytes not yet taken as frames.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Gets the bytes allocated for the buffer.
+   */
+  size_t capacity() const;
+
+  /**
+   * @brief Drops all buffered bytes, keeping the storage.
+   */
+  void clear();
+
+ private:
+  std::vector<char> data_;  ///< Storage, only ever grows.
+  size_t begin_ = 0;        ///< First byte not yet taken.
+  size_t end_ = 0;          ///< One past the last received byte.
+};
+
+}  // namespace BraendiDog
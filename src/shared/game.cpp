@@ -1,17 +1,31 @@
 #include "shared/game.hpp"
 
-#include <algorithm>  // for std::shuffle, std::sort
+#include <algorithm>  // for std::sort
 #include <cstdlib>
-#include <iostream>
 #include <nlohmann/json.hpp>
 #include <numeric>  // for std::iota
-#include <random>   // for std::random_device, std::mt19937
+#include <random>   // for std::random_device
+#include <span>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+#include "shared/logging.hpp"
 
 namespace BraendiDog {
 
 // Constructor
 GameState::GameState(
-    const std::array<std::optional<std::string>, 4>& gamePlayers) {
+    const std::array<std::optional<std::string>, 4>& gamePlayers,
+    std::optional<uint64_t> seed) {
+  // Seed the deal generator (random unless a replay seed is given)
+  if (!seed.has_value()) {
+    std::random_device rd;
+    seed = static_cast<uint64_t>(rd()) << 32 | rd();
+  }
+  rng.reseed(seed.value());
+
   currentPlayer = 0;     // First player to start always player 0
   roundStartPlayer = 0;  // First player to start always player 0
   roundCardCount = 6;    // Initial card count per player -> Round 1 = 6 cards
@@ -53,6 +67,7 @@ const std::array<std::optional<BraendiDog::Player>, 4>& GameState::getPlayers()
 }
 
 std::array<std::optional<BraendiDog::Player>, 4>& GameState::getPlayers() {
+  derivedStale = true;  // Caller may move marbles or change hands directly
   return players;
 }
 
@@ -62,6 +77,7 @@ const std::optional<BraendiDog::Player>& GameState::getPlayerByIndex(
   return players[index];
 }
 std::optional<BraendiDog::Player>& GameState::getPlayerByIndex(size_t index) {
+  derivedStale = true;  // Caller may move marbles or change hands directly
   return players[index];
 }
 
@@ -88,6 +104,8 @@ const std::array<std::optional<int>, 4>& GameState::getLeaderBoard() const {
 
 // Set current player index
 void GameState::setCurrentPlayer(size_t playerIndex) {
+  zobristHash ^= Zobrist::currentPlayerKey(currentPlayer) ^
+                 Zobrist::currentPlayerKey(playerIndex);
   currentPlayer = playerIndex;
 }
 
@@ -98,7 +116,7 @@ void GameState::updateCurrentPlayer() {
   while (true) {
     if (players[nextPlayer].has_value() &&
         players[nextPlayer]->isActiveInRound()) {
-      currentPlayer = nextPlayer;
+      setCurrentPlayer(nextPlayer);
       break;
     }
     nextPlayer = (nextPlayer + 1) % players.size();
@@ -121,11 +139,13 @@ void GameState::updateRoundStartPlayer() {
 
 // Set round card count
 void GameState::updateRoundCardCount() {
+  zobristHash ^= Zobrist::roundCardCountKey(roundCardCount);
   if (roundCardCount > 2) {
     roundCardCount--;
   } else {
     roundCardCount = 6;  // Reset to 6 after reaching minimum of 2
   }
+  zobristHash ^= Zobrist::roundCardCountKey(roundCardCount);
 }
 
 // Set last played card
@@ -162,6 +182,44 @@ void GameState::addLeaderBoardDisconnected(size_t playerID) {
   }
 }
 
+// Set hand and update hash
+void GameState::setHand(size_t playerID, const std::vector<size_t>& hand) {
+  zobristHash ^= handHash(playerID);
+  players[playerID]->setHand(hand);
+  zobristHash ^= handHash(playerID);
+}
+
+// Pop card from hand and update hash
+size_t GameState::popCardFromHand(size_t playerID, size_t handIndex) {
+  zobristHash ^= handHash(playerID);
+  size_t cardID = players[playerID]->popCardFromHand(handIndex);
+  zobristHash ^= handHash(playerID);
+  return cardID;
+}
+
+// Place marble and update occupancy index and hash
+void GameState::setMarblePosition(size_t playerID, size_t marbleIdx,
+                                  const Position& pos) {
+  if (!derivedStale && pos.boardLocation != BoardLocation::HOME) {
+    auto occupant = occupancy.occupant(pos);
+    if (occupant.has_value() && (occupant->playerID != playerID ||
+                                 occupant->marbleIdx != marbleIdx)) {
+      derivedStale = true;  // Two marbles on one field until set up
+    }
+  }
+  moveMarble(playerID, marbleIdx, pos);
+}
+
+// Set active in round status
+void GameState::setActiveInRound(size_t playerID, bool isActive) {
+  players[playerID]->setActiveInRound(isActive);
+}
+
+// Set active in game status
+void GameState::setActiveInGame(size_t playerID, bool isActive) {
+  players[playerID]->setActiveInGame(isActive);
+}
+
 // Update a players attributes if disconnected
 void GameState::disconnectPlayer(size_t playerIndex) {
   auto& playerOpt = players[playerIndex];
@@ -174,7 +232,7 @@ void GameState::disconnectPlayer(size_t playerIndex) {
     player.setActiveInGame(false);
     player.setActiveInRound(false);
     // Clear player's hand and reset marbles
-    player.setHand({});
+    setHand(playerIndex, {});
     // Set all track marbles to home
     for (size_t mIdx = 0; mIdx < 4; ++mIdx) {
       if (player.getMarblePosition(mIdx).boardLocation !=
@@ -182,7 +240,7 @@ void GameState::disconnectPlayer(size_t playerIndex) {
         continue;  // Only reset marbles on track
       }
       Position homePos(BoardLocation::HOME, mIdx, playerIndex);
-      player.setMarblePosition(mIdx, homePos);
+      moveMarble(playerIndex, mIdx, homePos);
     }
     // Add to leaderboard as disconnected
     addLeaderBoardDisconnected(playerIndex);
@@ -192,10 +250,10 @@ void GameState::disconnectPlayer(size_t playerIndex) {
 
   // Check if game has ended
   if (gameEnded) {
-    // Add remaining active player to leaderboard
-    size_t remainingPlayer =
-        getActivePlayerIndices()[0];  // only one remaining player
-    addLeaderBoardUnfinished(remainingPlayer);
+    // Add remaining active player to leaderboard (none if it already ended)
+    for (size_t remainingPlayer : getActivePlayerIndices()) {
+      addLeaderBoardUnfinished(remainingPlayer);
+    }
   }
 }
 
@@ -250,19 +308,26 @@ std::vector<size_t> GameState::getActivePlayerIndices() const {
 }
 
 // Deal cards to players
-std::map<size_t, std::vector<size_t>> GameState::dealCards() const {
+std::map<size_t, std::vector<size_t>> GameState::dealCards() {
+  return dealCards(rng);
+}
+
+// Deal cards to players (caller provided generator)
+std::map<size_t, std::vector<size_t>> GameState::dealCards(
+    Xoshiro256& generator) const {
   std::map<size_t, std::vector<size_t>> dealtCards;
   // Collect active players
   std::vector<size_t> activePlayers = getActivePlayerIndices();
 
-  // Create random number generator
-  static std::random_device rd;
-  static std::mt19937 gen(rd());
-
-  // Create a shuffled deck of card indices
-  std::vector<size_t> cardIndices(deck.size());
+  // Partial Fisher-Yates: only the dealt prefix of the deck is shuffled
+  std::array<uint8_t, 54> cardIndices;
   std::iota(cardIndices.begin(), cardIndices.end(), 0);
-  std::shuffle(cardIndices.begin(), cardIndices.end(), gen);
+  size_t dealCount = std::min(activePlayers.size() * roundCardCount,
+                              cardIndices.size());
+  for (size_t i = 0; i < dealCount; ++i) {
+    size_t j = i + generator.below(cardIndices.size() - i);
+    std::swap(cardIndices[i], cardIndices[j]);
+  }
 
   // Deal first N cards
   size_t cardIdx = 0;
@@ -293,34 +358,103 @@ std::map<size_t, std::vector<size_t>> GameState::dealCards() const {
   return dealtCards;
 }
 
+// Reseed deal generator
+void GameState::reseed(uint64_t seed) { rng.reseed(seed); }
+
+// Get deal generator
+const Xoshiro256& GameState::getRng() const { return rng; }
+
 //// Move Validation and Computation ////
 
-// Field occupied check helper
-std::optional<BraendiDog::MarbleIdentifier> GameState::isFieldOccupied(
-    const Position& pos) const {
-  // For each player
+// Rebuild occupancy index and hash (lazily after external modifications)
+void GameState::refreshDerived() const {
+  if (!derivedStale) {
+    return;
+  }
+  occupancy.clear();
   for (size_t pID = 0; pID < 4; ++pID) {
-    const auto& playerOpt = players[pID];
-    if (!playerOpt.has_value()) {
+    if (!players[pID].has_value()) {
       continue;  // Skip absent players
     }
-    // For each marble of player
     for (size_t mIdx = 0; mIdx < 4; ++mIdx) {
-      const Position& marblePos = playerOpt->getMarblePosition(mIdx);
+      occupancy.add(pID, mIdx, players[pID]->getMarblePosition(mIdx));
+    }
+  }
+  zobristHash = rebuildHash();
+  derivedStale = false;
+}
 
-      // For TRACK, ignore playerID in comparison
-      bool matches = false;
-      if (pos.boardLocation == BoardLocation::TRACK) {
-        matches = (marblePos.boardLocation == pos.boardLocation &&
-                   marblePos.index == pos.index);
-      } else {
-        // For HOME/FINISH, use full comparison including playerID
-        matches = pos.equals(marblePos);
-      }
+// Occupancy index
+const OccupancyIndex& GameState::getOccupancy() const {
+  refreshDerived();
+  return occupancy;
+}
 
-      if (matches) {
-        return MarbleIdentifier(pID, mIdx);
-      }
+// Hash contribution of a players hand
+uint64_t GameState::handHash(size_t playerID) const {
+  uint64_t h = 0;
+  const std::vector<size_t>& hand = players[playerID]->getHand();
+  for (size_t slot = 0; slot < hand.size(); ++slot) {
+    h ^= Zobrist::handKey(playerID, slot, hand[slot]);
+  }
+  return h;
+}
+
+// Set start blocked status and update hash
+void GameState::setStartBlocked(size_t playerID,
+                                   std::optional<size_t> marbleIdx) {
+  Player& player = players[playerID].value();
+  if (!derivedStale) {
+    if (player.isStartBlocked()) {
+      zobristHash ^=
+          Zobrist::startBlockedKey(playerID, player.getStartBlocked().value());
+    }
+    if (marbleIdx.has_value()) {
+      zobristHash ^= Zobrist::startBlockedKey(playerID, marbleIdx.value());
+    }
+  }
+  if (marbleIdx.has_value()) {
+    player.setStartBlocked(marbleIdx.value());
+  } else {
+    player.resetStartBlocked();
+  }
+}
+
+// Move marble and update occupancy index
+void GameState::moveMarble(size_t playerID, size_t marbleIdx,
+                           const Position& newPos) {
+  if (!derivedStale) {
+    const Position& oldPos = players[playerID]->getMarblePosition(marbleIdx);
+    zobristHash ^= Zobrist::marbleKey(playerID, marbleIdx, oldPos) ^
+                   Zobrist::marbleKey(playerID, marbleIdx, newPos);
+    // Only clear the old field if this marble still owns it (a swap partner
+    // may already have been moved onto it)
+    auto oldOccupant = occupancy.occupant(oldPos);
+    if (oldOccupant.has_value() && oldOccupant->playerID == playerID &&
+        oldOccupant->marbleIdx == marbleIdx) {
+      occupancy.remove(oldPos);
+    }
+    occupancy.add(playerID, marbleIdx, newPos);
+  }
+  players[playerID]->setMarblePosition(marbleIdx, newPos);
+}
+
+// Field occupied check helper
+std::optional<BraendiDog::MarbleIdentifier> GameState::isFieldOccupied(
+    const Position& pos) const {
+  // TRACK and FINISH fields are looked up in the occupancy index
+  if (pos.boardLocation != BoardLocation::HOME) {
+    return getOccupancy().occupant(pos);
+  }
+
+  // HOME fields can only be occupied by marbles of the owning player
+  const auto& playerOpt = players[pos.playerID];
+  if (!playerOpt.has_value()) {
+    return std::nullopt;  // Absent player
+  }
+  for (size_t mIdx = 0; mIdx < 4; ++mIdx) {
+    if (pos.equals(playerOpt->getMarblePosition(mIdx))) {
+      return MarbleIdentifier(pos.playerID, mIdx);
     }
   }
 
@@ -328,28 +462,86 @@ std::optional<BraendiDog::MarbleIdentifier> GameState::isFieldOccupied(
   return std::nullopt;
 }
 
+// Get mask of blocked start fields
+uint64_t GameState::getBlockedStartMask() const {
+  uint64_t mask = 0;
+  for (const auto& playerOpt : players) {
+    if (playerOpt.has_value() && playerOpt->isStartBlocked()) {
+      mask |= uint64_t{1} << playerOpt->getStartField();
+    }
+  }
+  return mask;
+}
+
+// Get Zobrist hash
+uint64_t GameState::hash() const {
+  refreshDerived();
+  return zobristHash;
+}
+
+// Compute hash from scratch
+uint64_t GameState::rebuildHash() const {
+  uint64_t h = Zobrist::currentPlayerKey(currentPlayer) ^
+               Zobrist::roundCardCountKey(roundCardCount);
+  for (size_t pID = 0; pID < 4; ++pID) {
+    if (!players[pID].has_value()) {
+      continue;  // Skip absent players
+    }
+    for (size_t mIdx = 0; mIdx < 4; ++mIdx) {
+      h ^= Zobrist::marbleKey(pID, mIdx, players[pID]->getMarblePosition(mIdx));
+    }
+    if (players[pID]->isStartBlocked()) {
+      h ^= Zobrist::startBlockedKey(pID,
+                                    players[pID]->getStartBlocked().value());
+    }
+    h ^= handHash(pID);
+  }
+  return h;
+}
+
+// Get hash without the hands of the other players
+uint64_t GameState::moveHash() const {
+  uint64_t h = hash();
+  for (size_t pID = 0; pID < 4; ++pID) {
+    if (pID != currentPlayer && players[pID].has_value()) {
+      h ^= handHash(pID);
+    }
+  }
+  return h;
+}
+
+// Get track occupancy mask
+uint64_t GameState::getTrackMask() const { return getOccupancy().track; }
+
+// Get finish occupancy mask of a player
+uint8_t GameState::getFinishMask(size_t playerID) const {
+  return getOccupancy().finish[playerID];
+}
+
 // Check START
-std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
-GameState::checkStartMove(const Position& marblePos) const {
+bool GameState::checkStartMove(const Position& marblePos,
+                               MovementBuffer& out) const {
   return checkSimpleMove(
-      marblePos, 0);  // Start move indicated by int value 0 in SIMPLE move
+      marblePos, 0,
+      out);  // Start move indicated by int value 0 in SIMPLE move
 }
 
 // Check SIMPLE
-std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
-GameState::checkSimpleMove(const Position& marblePos, int moveValue) const {
+bool GameState::checkSimpleMove(const Position& marblePos, int moveValue,
+                                MovementBuffer& out) const {
   // ============================================================================
   // (Potential) END POSITION CALCULATION
   // - for current position, compute potential end position based on move value
   // ============================================================================
-  std::vector<Position> vectorPossibleEndPos;
+  std::array<Position, 2> possibleEndPositions;
+  size_t possibleEndCount = 0;
 
   // START move (zero moveValue) ///
   if (moveValue == 0) {
     Position possibleEndPos =
         Position(BoardLocation::TRACK, players[currentPlayer]->getStartField(),
                  currentPlayer);
-    vectorPossibleEndPos.push_back(possibleEndPos);
+    possibleEndPositions[possibleEndCount++] = possibleEndPos;
   }
 
   /// Regular walking move (non-zero moveValue) ///
@@ -360,26 +552,21 @@ GameState::checkSimpleMove(const Position& marblePos, int moveValue) const {
       int targetIndex = marblePos.index + moveValue;
 
       if (targetIndex < 0 || targetIndex > 3) {
-        return std::nullopt;  // Invalid move, outside finish area bounds
+        return false;  // Invalid move, outside finish area bounds
       }
 
       // Check path for own marbles - no jumping over own marbles allowed
-      int step = (moveValue > 0) ? 1 : -1;
-      for (int checkIdx = marblePos.index + step;
-           (step > 0 && checkIdx <= targetIndex) ||
-           (step < 0 && checkIdx >= targetIndex);
-           checkIdx += step) {
-        Position checkPos(BoardLocation::FINISH, checkIdx, currentPlayer);
-        auto occupant = isFieldOccupied(checkPos);
-        // If any position along the path contains own marble, move is blocked
-        if (occupant.has_value() && occupant->playerID == currentPlayer) {
-          return std::nullopt;
-        }
+      // (finish area only holds own marbles, so any occupied field blocks)
+      size_t pathFrom = (moveValue > 0) ? marblePos.index + 1 : targetIndex;
+      size_t pathTo = (moveValue > 0) ? targetIndex : marblePos.index - 1;
+      if (getOccupancy().isFinishRangeOccupied(currentPlayer, pathFrom,
+                                               pathTo)) {
+        return false;
       }
 
       Position possibleEndPos =
           Position(BoardLocation::FINISH, targetIndex, currentPlayer);
-      vectorPossibleEndPos.push_back(possibleEndPos);
+      possibleEndPositions[possibleEndCount++] = possibleEndPos;
     }
 
     /// TRACK area move (from TRACK to TRACK & from TRACK to FINISH) ///
@@ -413,7 +600,7 @@ GameState::checkSimpleMove(const Position& marblePos, int moveValue) const {
           marblePos.index == startFieldIdx) {
         Position possibleEndPos =
             Position(BoardLocation::TRACK, endIndex, currentPlayer);
-        vectorPossibleEndPos.push_back(possibleEndPos);
+        possibleEndPositions[possibleEndCount++] = possibleEndPos;
       }
       // Otherwise check for crossing blocked start fields
       else {
@@ -484,7 +671,7 @@ GameState::checkSimpleMove(const Position& marblePos, int moveValue) const {
           }
           // If we cross any blocked start, move is invalid
           if (crossesBlockedStart) {
-            return std::nullopt;
+            return false;
           }
         }
 
@@ -509,67 +696,51 @@ GameState::checkSimpleMove(const Position& marblePos, int moveValue) const {
           }
 
           if (finishIndex <= 3) {
-            bool enterfinishAllowed = true;
             // Check in finish area for own marbles blocking the path
-            for (int checkIdx = 0; checkIdx <= finishIndex; checkIdx++) {
-              Position checkPos(BoardLocation::FINISH, checkIdx, currentPlayer);
-              auto occupant = isFieldOccupied(checkPos);
-              // If any position along the path contains own marble, move is
-              // blocked
-              if (occupant.has_value() && occupant->playerID == currentPlayer) {
-                enterfinishAllowed = false;
-                break;
-              }
-            }
+            bool enterfinishAllowed = !getOccupancy().isFinishRangeOccupied(
+                currentPlayer, 0, finishIndex);
             if (enterfinishAllowed) {
               // additionally add finish position as possible end position
               Position possibleEndPos =
                   Position(BoardLocation::FINISH, finishIndex, currentPlayer);
-              vectorPossibleEndPos.push_back(possibleEndPos);
+              possibleEndPositions[possibleEndCount++] = possibleEndPos;
             }
           }
         }
         // anyways add the track end position as possible end position
         Position possibleEndPos =
             Position(BoardLocation::TRACK, endIndex, currentPlayer);
-        vectorPossibleEndPos.push_back(possibleEndPos);
+        possibleEndPositions[possibleEndCount++] = possibleEndPos;
       }
     }
   }
 
-  // Security checks
-  if (vectorPossibleEndPos.empty()) {
-    std::cerr << "Error: Should never reach here - no possible end positions "
-                 "but did not leave earlier."
-              << std::endl;
-    return std::nullopt;  // No possible end positions computed -> invalid move
-  } else if (vectorPossibleEndPos.size() > 2) {
-    std::cerr << "Error: Should never reach here - more than 2 possible end "
-                 "positions computed."
-              << std::endl;
-    return std::nullopt;  // More than 2 possible end positions computed ->
-                          // invalid move
+  // Security check
+  if (possibleEndCount == 0) {
+    BD_LOG_ERROR("Engine",
+                 "Should never reach here - no possible end positions but did "
+                 "not leave earlier.");
+    return false;  // No possible end positions computed -> invalid move
   }
 
   // ============================================================================
   // OCCUPATION TEST (after potential end position computed)
   // for all possible end positions, check if occupied and by whom
   // ============================================================================
-  std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
-      resultMoves = std::vector<std::pair<MarbleIdentifier, Position>>{};
+  size_t startSize = out.size();
+  MarbleIdentifier movingMarble(
+      currentPlayer,
+      players[currentPlayer]->getMarbleIndexByPos(marblePos).value());
 
   // For both possible end positions, check occupation
-  for (const Position& possibleEndPos : vectorPossibleEndPos) {
+  for (size_t i = 0; i < possibleEndCount; ++i) {
+    const Position& possibleEndPos = possibleEndPositions[i];
     std::optional<MarbleIdentifier> occupyingMarble =
         isFieldOccupied(possibleEndPos);
 
     // End field unoccupied -> valid move
     if (!occupyingMarble.has_value()) {
-      resultMoves->push_back(std::pair<MarbleIdentifier, Position>{
-          MarbleIdentifier(
-              currentPlayer,
-              players[currentPlayer]->getMarbleIndexByPos(marblePos).value()),
-          possibleEndPos});
+      out.push_back({movingMarble, possibleEndPos});
     }
     // End field occupied
     else {
@@ -580,13 +751,9 @@ GameState::checkSimpleMove(const Position& marblePos, int moveValue) const {
       // End field occupied by opponent marble -> valid move, send opponent home
       else {
         // Add: Moving marble to end pos
-        resultMoves->push_back(std::pair<MarbleIdentifier, Position>{
-            MarbleIdentifier(
-                currentPlayer,
-                players[currentPlayer]->getMarbleIndexByPos(marblePos).value()),
-            possibleEndPos});
+        out.push_back({movingMarble, possibleEndPos});
         // Add: opponent marble being sent home
-        resultMoves->push_back(
+        out.push_back(
             {occupyingMarble.value(),
              Position(BoardLocation::HOME,
                       occupyingMarble.value()
@@ -597,15 +764,12 @@ GameState::checkSimpleMove(const Position& marblePos, int moveValue) const {
     }
   }
   // If no valid moves found -> invalid move
-  if (!resultMoves.has_value() || resultMoves->empty()) {
-    return std::nullopt;
-  }
-  return resultMoves;
+  return out.size() > startSize;
 }
 
 // Check SWAP
-std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
-GameState::checkSwapMove(const Position& marblePos) const {
+bool GameState::checkSwapMove(const Position& marblePos,
+                              MovementBuffer& out) const {
   // Check all opponent marbles on track
   std::pair<MarbleIdentifier, Position> movingMarble(
       MarbleIdentifier(
@@ -617,10 +781,10 @@ GameState::checkSwapMove(const Position& marblePos) const {
   if (players[currentPlayer]->getStartBlocked().has_value() &&
       players[currentPlayer]->getStartBlocked().value() ==
           movingMarble.first.marbleIdx) {
-    return std::nullopt;  // Cannot swap if own marble is blocked on start
+    return false;  // Cannot swap if own marble is blocked on start
   }
 
-  std::vector<std::pair<MarbleIdentifier, Position>> swapMoves;
+  size_t startSize = out.size();
 
   for (size_t pID = 0; pID < 4; ++pID) {
     if (pID == currentPlayer) {
@@ -642,37 +806,38 @@ GameState::checkSwapMove(const Position& marblePos) const {
         // Valid swap candidate
         std::pair<MarbleIdentifier, Position> opponentMarble(
             MarbleIdentifier(pID, mIdx), opponentMarblePos);
-        swapMoves.push_back(
+        out.push_back(
             {movingMarble.first, opponentMarble.second});  // moving marble
-        swapMoves.push_back(
+        out.push_back(
             {opponentMarble.first,
              movingMarble.second});  // opponent marble to moving marble pos
       }
     }
   }
   // If no valid swap moves found -> invalid move
-  if (swapMoves.empty()) {
-    return std::nullopt;
-  }
-  // Return all possible swap moves
-  return swapMoves;
+  return out.size() > startSize;
 }
 
 // Check SEVEN
-std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
-GameState::checkSevenMove(const Position& marblePos, int moveValue) const {
+bool GameState::checkSevenMove(const Position& marblePos, int moveValue,
+                               MovementBuffer& out) const {
   // ============================================================================
   // (Potential) END POSITION CALCULATION
   // - for current position, compute potential end position based on move value
   // ============================================================================
-  std::vector<std::pair<MarbleIdentifier, Position>> walkingOptions;
+  size_t startSize = out.size();
 
   BraendiDog::MarbleIdentifier movingMarble(
       currentPlayer,
       players[currentPlayer]->getMarbleIndexByPos(marblePos).value());
 
-  std::vector<MarbleIdentifier> sentHomeMarbles =
-      std::vector<MarbleIdentifier>();
+  if (moveValue > 7) {
+    return false;  // Seven parts never exceed 7 steps
+  }
+
+  // At most one opponent marble can be passed per step
+  std::array<MarbleIdentifier, 7> sentHomeMarbles;
+  size_t sentHomeCount = 0;
 
   /// Regular walking move for all moveValue parts upto moveValue ///
   const auto& playerOpt = players[currentPlayer];
@@ -697,7 +862,7 @@ GameState::checkSevenMove(const Position& marblePos, int moveValue) const {
 
       Position possibleEndPos =
           Position(BoardLocation::FINISH, targetIndex, currentPlayer);
-      walkingOptions.push_back({movingMarble, possibleEndPos});
+      out.push_back({movingMarble, possibleEndPos});
     }
 
     /// TRACK area move (from TRACK to TRACK & from TRACK to FINISH) ///
@@ -763,7 +928,7 @@ GameState::checkSevenMove(const Position& marblePos, int moveValue) const {
           break;  // stop advancing further in this walking option
         }
         // add opponent MarbleIdentifier to sentHomeMarbles
-        sentHomeMarbles.push_back(occupant.value());
+        sentHomeMarbles[sentHomeCount++] = occupant.value();
       }
 
       // If we cross our start, check for finish entry
@@ -796,18 +961,21 @@ GameState::checkSevenMove(const Position& marblePos, int moveValue) const {
           // position
           Position possibleEndPos =
               Position(BoardLocation::FINISH, finishIndex, currentPlayer);
-          walkingOptions.push_back({movingMarble, possibleEndPos});
+          out.push_back({movingMarble, possibleEndPos});
 
           // Add sent home opponent marble as well
-          for (const MarbleIdentifier& oppMarble : sentHomeMarbles) {
+          for (size_t i = 0; i < sentHomeCount; ++i) {
+            const MarbleIdentifier& oppMarble = sentHomeMarbles[i];
             // access opponent player
             const auto& opponentPlayerOpt = players[oppMarble.playerID];
-            if (opponentPlayerOpt->getMarblePosition(oppMarble.marbleIdx)
-                    .index > ourStartIdx) {
+            size_t oppIdx =
+                opponentPlayerOpt->getMarblePosition(oppMarble.marbleIdx).index;
+            if ((oppIdx + 64 - marblePos.index) % 64 >
+                (ourStartIdx + 64 - marblePos.index) % 64) {
               continue;  // skip adding opponent marble if it is after our start
-                         // (for finish entry)
+                         // (for finish entry, also across the 63->0 wrap)
             }
-            walkingOptions.push_back(
+            out.push_back(
                 {oppMarble, Position(BoardLocation::HOME, oppMarble.marbleIdx,
                                      oppMarble.playerID)});
           }
@@ -822,11 +990,12 @@ GameState::checkSevenMove(const Position& marblePos, int moveValue) const {
       // Add track end position as possible end position
       Position possibleEndPos =
           Position(BoardLocation::TRACK, endIndex, currentPlayer);
-      walkingOptions.push_back({movingMarble, possibleEndPos});
+      out.push_back({movingMarble, possibleEndPos});
 
       // Add sent home opponent marble as well
-      for (const MarbleIdentifier& oppMarble : sentHomeMarbles) {
-        walkingOptions.push_back(
+      for (size_t i = 0; i < sentHomeCount; ++i) {
+        const MarbleIdentifier& oppMarble = sentHomeMarbles[i];
+        out.push_back(
             {oppMarble, Position(BoardLocation::HOME, oppMarble.marbleIdx,
                                  oppMarble.playerID)});
       }
@@ -834,12 +1003,7 @@ GameState::checkSevenMove(const Position& marblePos, int moveValue) const {
   }
 
   // If no valid moves found -> invalid move
-  if (walkingOptions.empty()) {
-    return std::nullopt;
-  }
-  std::cout << "SEVEN move options computed: " << walkingOptions.size()
-            << " parts." << std::endl;
-  return walkingOptions;
+  return out.size() > startSize;
 }
 
 // Check JOKER
@@ -849,10 +1013,9 @@ GameState::checkJokerMove() const {
 }
 
 // Validate Move
-std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
-GameState::validateMove(const Card& card, const Position& marblePos,
-                        const std::pair<MoveType, int>& moveRule,
-                        bool sevenCall) const {
+bool GameState::validateMove(const Card& card, const Position& marblePos,
+                             const std::pair<MoveType, int>& moveRule,
+                             bool sevenCall, MovementBuffer& out) const {
   MoveType moveType = moveRule.first;
   int moveValue = moveRule.second;
 
@@ -861,61 +1024,110 @@ GameState::validateMove(const Card& card, const Position& marblePos,
     case BoardLocation::HOME:
       switch (moveType) {
         case MoveType::START:
-          return checkStartMove(marblePos);
+          return checkStartMove(marblePos, out);
           break;
         default:
-          return std::nullopt;  // Invalid move
+          return false;  // Invalid move
       }
       break;
     case BoardLocation::FINISH:
       switch (moveType) {
         case MoveType::SIMPLE:
-          return checkSimpleMove(marblePos, moveValue);
+          return checkSimpleMove(marblePos, moveValue, out);
           break;
         case MoveType::SEVEN:
           if (sevenCall) {
             return checkSevenMove(
-                marblePos, moveValue);  // Adjusted walking logic for SEVEN call
+                marblePos, moveValue,
+                out);  // Adjusted walking logic for SEVEN call
           } else {
-            return std::nullopt;  // Ignore SEVEN card in non sevenCall context
+            return false;  // Ignore SEVEN card in non sevenCall context
           }
           break;
         default:
-          return std::nullopt;  // Invalid move
+          return false;  // Invalid move
       }
       break;
     case BoardLocation::TRACK:
       switch (moveType) {
         case MoveType::SIMPLE:
-          return checkSimpleMove(marblePos, moveValue);
+          return checkSimpleMove(marblePos, moveValue, out);
           break;
         case MoveType::SEVEN:
           if (sevenCall) {
             return checkSevenMove(
-                marblePos, moveValue);  // Adjusted walking logic for SEVEN call
+                marblePos, moveValue,
+                out);  // Adjusted walking logic for SEVEN call
           } else {
-            return std::nullopt;  // Ignore SEVEN card in non sevenCall context
+            return false;  // Ignore SEVEN card in non sevenCall context
           }
           break;
         case MoveType::SWAP:
-          return checkSwapMove(marblePos);
+          return checkSwapMove(marblePos, out);
           break;
         default:
-          return std::nullopt;  // Invalid move
+          return false;  // Invalid move
       }
       break;
     default:
-      std::cerr << "Invalid board location in validateMove" << std::endl;
-      return std::nullopt;  // Invalid location
+      BD_LOG_ERROR("Engine", "Invalid board location in validateMove");
+      return false;  // Invalid location
   }
 }
 
-// Compute all legal plays for the current player given their hand and marble
-// positions.
-std::vector<BraendiDog::Move> GameState::computeLegalMoves(
-    std::optional<std::array<size_t, 3>> Special, bool sevenCall) const {
-  std::vector<BraendiDog::Move> legalMoves;
+// Vector returning wrappers around the buffer based checks
+namespace {
+std::optional<std::vector<std::pair<MarbleIdentifier, Position>>> toOptional(
+    bool valid, const MovementBuffer& buffer) {
+  if (!valid) {
+    return std::nullopt;
+  }
+  return std::vector<std::pair<MarbleIdentifier, Position>>(buffer.begin(),
+                                                            buffer.end());
+}
+}  // namespace
 
+std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
+GameState::checkStartMove(const Position& marblePos) const {
+  MovementBuffer buffer;
+  bool valid = checkStartMove(marblePos, buffer);
+  return toOptional(valid, buffer);
+}
+
+std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
+GameState::checkSimpleMove(const Position& marblePos, int moveValue) const {
+  MovementBuffer buffer;
+  bool valid = checkSimpleMove(marblePos, moveValue, buffer);
+  return toOptional(valid, buffer);
+}
+
+std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
+GameState::checkSevenMove(const Position& marblePos, int moveValue) const {
+  MovementBuffer buffer;
+  bool valid = checkSevenMove(marblePos, moveValue, buffer);
+  return toOptional(valid, buffer);
+}
+
+std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
+GameState::checkSwapMove(const Position& marblePos) const {
+  MovementBuffer buffer;
+  bool valid = checkSwapMove(marblePos, buffer);
+  return toOptional(valid, buffer);
+}
+
+std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
+GameState::validateMove(const Card& card, const Position& marblePos,
+                        const std::pair<MoveType, int>& moveRule,
+                        bool sevenCall) const {
+  MovementBuffer buffer;
+  bool valid = validateMove(card, marblePos, moveRule, sevenCall, buffer);
+  return toOptional(valid, buffer);
+}
+
+// Generate all legal plays for the current player into a fixed-capacity list
+void GameState::generateLegalMoves(
+    MoveList& legalMoves, std::optional<std::array<size_t, 3>> Special,
+    bool sevenCall) const {
   bool jokerCall = false;
 
   // Access current players hand and marbles
@@ -923,10 +1135,12 @@ std::vector<BraendiDog::Move> GameState::computeLegalMoves(
   const std::array<Position, 4>& marbles = currentPlayerObj.getMarbles();
 
   // Make Function work for Special Cards as well
-  std::vector<size_t> hand;
+  std::array<size_t, 1> specialHand{};
+  std::span<const size_t> hand;
   if (Special.has_value()) {
     // Joker or Seven Computation
-    hand = std::vector<size_t>{Special.value()[0]};
+    specialHand[0] = Special.value()[0];
+    hand = specialHand;
     if (deck[Special.value()[2]].getRank() == Rank::JOKER) {
       jokerCall = true;
     }
@@ -934,6 +1148,9 @@ std::vector<BraendiDog::Move> GameState::computeLegalMoves(
     hand = currentPlayerObj.getHand();
   }
 
+  // Reused result buffer of the move checks
+  MovementBuffer movedMarbles;
+
   // For each card in hand
   for (size_t handIndex = 0; handIndex < hand.size(); ++handIndex) {
     size_t cardID = hand[handIndex];
@@ -974,43 +1191,40 @@ std::vector<BraendiDog::Move> GameState::computeLegalMoves(
         const Position& marblePos = marbles[mIdx];
 
         // validateMove
-        auto movedMarbles = validateMove(
+        movedMarbles.clear();
+        bool valid = validateMove(
             card, marblePos,
-            std::make_pair(effectiveMoveType, effectiveMoveValue), sevenCall);
+            std::make_pair(effectiveMoveType, effectiveMoveValue), sevenCall,
+            movedMarbles);
         // Add to legal moves if valid
-        if (movedMarbles.has_value()) {
+        if (valid) {
+          std::span<const Movement> movements = movedMarbles.view();
           // for START only one movement option for
           // card+cardRule+marble combination
           // for SIMPLE upto three movement options possible
           // (finish/track+capture)
           if (effectiveMoveType == MoveType::START ||
               effectiveMoveType == MoveType::SIMPLE) {
-            const auto& movements = movedMarbles.value();
-
             if (movements.size() >= 2 &&
                 movements[0].first.marbleIdx == movements[1].first.marbleIdx &&
                 movements[0].first.playerID == movements[1].first.playerID &&
                 movements[0].second.boardLocation !=
                     movements[1].second.boardLocation) {
               // Create finish option (never has captures)
-              std::vector<std::pair<MarbleIdentifier, Position>> finishOption;
-              finishOption.push_back(movements[0]);
-              legalMoves.push_back(
-                  Move(toSetCardID, toSetHandIndex, finishOption));
+              legalMoves.push_back(toSetCardID, toSetHandIndex,
+                                   movements.subspan(0, 1));
 
               // Create track option (may have capture at index 2)
-              std::vector<std::pair<MarbleIdentifier, Position>> trackOption;
-              trackOption.push_back(movements[1]);
+              size_t trackCount = 1;
               if (movements.size() >= 3 &&
                   movements[2].first.playerID != currentPlayer &&
                   movements[2].second.boardLocation == BoardLocation::HOME) {
-                trackOption.push_back(movements[2]);
+                trackCount = 2;
               }
-              legalMoves.push_back(
-                  Move(toSetCardID, toSetHandIndex, trackOption));
+              legalMoves.push_back(toSetCardID, toSetHandIndex,
+                                   movements.subspan(1, trackCount));
             } else {
-              Move move(toSetCardID, toSetHandIndex, movements);
-              legalMoves.push_back(move);
+              legalMoves.push_back(toSetCardID, toSetHandIndex, movements);
             }
           }
           // for SWAP multiple movement options possible (depending on opponent
@@ -1018,13 +1232,9 @@ std::vector<BraendiDog::Move> GameState::computeLegalMoves(
           else if (effectiveMoveType == MoveType::SWAP) {
             // one option will have 2 marbles moved (own current Player marble +
             // opponent marble)
-            for (size_t i = 0; i < movedMarbles->size(); i += 2) {
-              std::vector<std::pair<MarbleIdentifier, Position>> swapMoveVec;
-              swapMoveVec.push_back(movedMarbles->at(
-                  i));  // moving marble (all playerID = currentPlayer)
-              swapMoveVec.push_back(movedMarbles->at(i + 1));  //
-              Move move(toSetCardID, toSetHandIndex, swapMoveVec);
-              legalMoves.push_back(move);
+            for (size_t i = 0; i < movements.size(); i += 2) {
+              legalMoves.push_back(toSetCardID, toSetHandIndex,
+                                   movements.subspan(i, 2));
             }
           }
           // for SEVEN call multiple movement options possible
@@ -1034,19 +1244,17 @@ std::vector<BraendiDog::Move> GameState::computeLegalMoves(
             // one option will have 1 or more marbles moved (own current Player
             // marble + any optional opponent marble)
             // at own marble a new move starts
-            for (size_t i = 0; i < movedMarbles->size();) {
-              std::vector<std::pair<MarbleIdentifier, Position>> sevenMoveVec;
-              // Add own marble move
-              sevenMoveVec.push_back(movedMarbles->at(i));
+            for (size_t i = 0; i < movements.size();) {
+              size_t partStart = i;
+              // Own marble move
               i++;
-              // Add any opponent marbles sent home
-              while (i < movedMarbles->size() &&
-                     movedMarbles->at(i).first.playerID != currentPlayer) {
-                sevenMoveVec.push_back(movedMarbles->at(i));
+              // Any opponent marbles sent home
+              while (i < movements.size() &&
+                     movements[i].first.playerID != currentPlayer) {
                 i++;
               }
-              Move move(toSetCardID, toSetHandIndex, sevenMoveVec);
-              legalMoves.push_back(move);
+              legalMoves.push_back(toSetCardID, toSetHandIndex,
+                                   movements.subspan(partStart, i - partStart));
             }
           }
 
@@ -1058,21 +1266,15 @@ std::vector<BraendiDog::Move> GameState::computeLegalMoves(
             // duplicate moved Marbles with other marbles of same location
             mIdx++;
             while (mIdx < marbles.size()) {
-              if (players[currentPlayer]
-                      ->getMarblePosition(mIdx)
-                      .boardLocation != BraendiDog::BoardLocation::HOME) {
+              if (marbles[mIdx].boardLocation !=
+                  BraendiDog::BoardLocation::HOME) {
                 mIdx++;
                 continue;
               }
 
-              std::vector<std::pair<MarbleIdentifier, Position>> startMoveVec;
-              auto currMovedMarbles = movedMarbles->at(0);
-              currMovedMarbles.first.marbleIdx = mIdx;  // update marbleIdx
-              startMoveVec.push_back(
-                  currMovedMarbles);  // moving marble (all playerID =
-                                      // currentPlayer)
-              Move move(toSetCardID, toSetHandIndex, startMoveVec);
-              legalMoves.push_back(move);
+              std::array<Movement, 1> startMove = {movements[0]};
+              startMove[0].first.marbleIdx = mIdx;  // update marbleIdx
+              legalMoves.push_back(toSetCardID, toSetHandIndex, startMove);
 
               mIdx++;
             }
@@ -1084,31 +1286,23 @@ std::vector<BraendiDog::Move> GameState::computeLegalMoves(
             // duplicate moved Marbles with other marbles of same location
             mIdx++;
             while (mIdx < marbles.size()) {
-              if (players[currentPlayer]
-                      ->getMarblePosition(mIdx)
-                      .boardLocation != BraendiDog::BoardLocation::TRACK) {
+              if (marbles[mIdx].boardLocation !=
+                  BraendiDog::BoardLocation::TRACK) {
                 mIdx++;
                 continue;
               }
-              if (players[currentPlayer]->getStartBlocked().has_value() &&
-                  players[currentPlayer]->getStartBlocked().value() == mIdx) {
+              if (currentPlayerObj.getStartBlocked().has_value() &&
+                  currentPlayerObj.getStartBlocked().value() == mIdx) {
                 mIdx++;
                 continue;  // Skip blocked marble
               }
-              for (size_t i = 0; i < movedMarbles->size(); i += 2) {
-                std::vector<std::pair<MarbleIdentifier, Position>> swapMoveVec;
-                auto currMovedMarbles = movedMarbles->at(i);
-                currMovedMarbles.first.marbleIdx = mIdx;  // update marbleIdx
-                swapMoveVec.push_back(
-                    currMovedMarbles);  // moving marble (all playerID =
-                                        // currentPlayer)
-                auto opponentMovement = movedMarbles->at(i + 1);
-                opponentMovement.second =
-                    players[currentPlayer]->getMarblePosition(mIdx);
-                swapMoveVec.push_back(
-                    opponentMovement);  // swapped marble (opponent)
-                Move move(toSetCardID, toSetHandIndex, swapMoveVec);
-                legalMoves.push_back(move);
+              for (size_t i = 0; i < movements.size(); i += 2) {
+                std::array<Movement, 2> swapMove = {movements[i],
+                                                    movements[i + 1]};
+                swapMove[0].first.marbleIdx = mIdx;  // update marbleIdx
+                swapMove[1].second =
+                    marbles[mIdx];  // swapped marble (opponent)
+                legalMoves.push_back(toSetCardID, toSetHandIndex, swapMove);
               }
               mIdx++;
             }
@@ -1118,24 +1312,257 @@ std::vector<BraendiDog::Move> GameState::computeLegalMoves(
       }
     }
   }
-  std::cout << "Computed " << legalMoves.size() << " legal moves for player "
-            << currentPlayer << std::endl;
-  // cout legal moves for debugging
-  for (const auto& move : legalMoves) {
-    std::cout << "Move: CardID " << move.getCardID() << ", HandIndex "
-              << move.getHandIndex() << ", Movements: ";
-    for (const auto& movement : move.getMovements()) {
-      std::cout << "[Player " << movement.first.playerID << " Marble "
-                << movement.first.marbleIdx << " -> ("
-                << static_cast<int>(movement.second.boardLocation) << ", "
-                << movement.second.index << ")] ";
+}
+
+namespace {
+// Format the movements of a move for log output
+std::string formatMovements(const BraendiDog::Move& move) {
+  std::ostringstream out;
+  for (const auto& movement : move.getMovements()) {
+    out << "[Player " << movement.first.playerID << " Marble "
+        << movement.first.marbleIdx << " -> ("
+        << static_cast<int>(movement.second.boardLocation) << ", "
+        << movement.second.index << ")] ";
+  }
+  return out.str();
+}
+}  // namespace
+
+// Compute all legal plays for the current player given their hand and marble
+// positions.
+std::vector<BraendiDog::Move> GameState::computeLegalMoves(
+    std::optional<std::array<size_t, 3>> Special, bool sevenCall) const {
+  MoveList moveList;
+  generateLegalMoves(moveList, Special, sevenCall);
+  std::vector<BraendiDog::Move> legalMoves = moveList.toVector();
+
+  BD_LOG_DEBUG("Engine", "Computed " << legalMoves.size()
+                                     << " legal moves for player "
+                                     << currentPlayer);
+  // log legal moves for debugging
+  if (Log::enabled(Log::Level::TRACE)) {
+    for (const auto& move : legalMoves) {
+      BD_LOG_TRACE("Engine", "Move: CardID " << move.getCardID()
+                                             << ", HandIndex "
+                                             << move.getHandIndex()
+                                             << ", Movements: "
+                                             << formatMovements(move));
     }
-    std::cout << std::endl;
   }
   // return all legal moves
   return legalMoves;
 }
 
+namespace {
+// Movements of a (partial) Seven split and the hash of the state it leads to
+struct SevenSplit {
+  std::vector<Movement> movements;
+  uint64_t finalHash;
+};
+
+// Depth first Seven split enumeration on a scratch state, sub-splits are
+// memoized by (state hash, remaining steps)
+class SevenSplitter {
+ public:
+  SevenSplitter(GameState& state, size_t cardID, size_t handIndex)
+      : state(state), cardID(cardID), handIndex(handIndex), levels(7) {}
+
+  // All distinct splits using exactly `remaining` steps
+  const std::vector<SevenSplit>& splits(size_t remaining) {
+    uint64_t seed = state.hash() + remaining;
+    uint64_t key = Zobrist::splitmix64(seed);
+    auto it = memo.find(key);
+    if (it != memo.end()) {
+      return it->second;
+    }
+
+    // Parts of 1 to `remaining` steps (lower levels are free for recursion)
+    MoveList& parts = levels[remaining - 1];
+    parts.clear();
+    state.generateLegalMoves(
+        parts, std::array<size_t, 3>{remaining - 1, handIndex, cardID}, true);
+
+    std::vector<SevenSplit> result;
+    const GameState& view = state;
+    for (size_t i = 0; i < parts.size(); ++i) {
+      MoveView part = parts[i];
+      const Movement& own = part.movements[0];
+      const Position& from = view.getPlayerByIndex(own.first.playerID)
+                                 ->getMarblePosition(own.first.marbleIdx);
+      size_t steps = state.sevenSteps(from, own.second);
+      if (steps == 0 || steps > remaining) {
+        continue;
+      }
+
+      UndoRecord record = state.applyTempSevenMove(part.toMove());
+      if (steps == remaining) {
+        result.push_back({std::vector<Movement>(part.movements.begin(),
+                                                part.movements.end()),
+                          state.hash()});
+      } else {
+        for (const SevenSplit& rest : splits(remaining - steps)) {
+          SevenSplit split{std::vector<Movement>(part.movements.begin(),
+                                                 part.movements.end()),
+                           rest.finalHash};
+          split.movements.insert(split.movements.end(),
+                                 rest.movements.begin(), rest.movements.end());
+          result.push_back(std::move(split));
+        }
+      }
+      state.unmakeMove(record);
+    }
+
+    // Keep one split per final outcome (part order does not matter)
+    std::vector<SevenSplit> unique;
+    for (SevenSplit& split : result) {
+      bool seen = std::any_of(unique.begin(), unique.end(),
+                              [&split](const SevenSplit& other) {
+                                return other.finalHash == split.finalHash;
+                              });
+      if (!seen) {
+        unique.push_back(std::move(split));
+      }
+    }
+    return memo.emplace(key, std::move(unique)).first->second;
+  }
+
+ private:
+  GameState& state;
+  size_t cardID;
+  size_t handIndex;
+  std::vector<MoveList> levels;  // One part list per remaining step count
+  std::unordered_map<uint64_t, std::vector<SevenSplit>> memo;
+};
+}  // namespace
+
+// Enumerate all complete Seven splits
+std::vector<BraendiDog::Move> GameState::computeSevenSplits(
+    size_t handIndex) const {
+  const std::vector<size_t>& hand = players[currentPlayer]->getHand();
+  if (handIndex >= hand.size()) {
+    throw std::out_of_range("Hand index out of range");
+  }
+
+  GameState scratch = *this;
+  SevenSplitter splitter(scratch, hand[handIndex], handIndex);
+  std::vector<BraendiDog::Move> splits;
+  for (const SevenSplit& split : splitter.splits(7)) {
+    splits.emplace_back(hand[handIndex], handIndex, split.movements);
+  }
+  return splits;
+}
+
+// Count walked steps of a marble of the current player
+size_t GameState::sevenSteps(const Position& from, const Position& to) const {
+  // FINISH to FINISH
+  if (from.boardLocation == BoardLocation::FINISH &&
+      to.boardLocation == BoardLocation::FINISH) {
+    return to.index > from.index ? to.index - from.index : 0;
+  }
+  if (from.boardLocation != BoardLocation::TRACK) {
+    return 0;
+  }
+  // TRACK to FINISH (through own start field)
+  if (to.boardLocation == BoardLocation::FINISH) {
+    size_t startIdx = players[currentPlayer]->getStartField();
+    return (startIdx + 64 - from.index) % 64 + to.index + 1;
+  }
+  // TRACK to TRACK (with wrap-around)
+  if (to.boardLocation == BoardLocation::TRACK) {
+    return (to.index + 64 - from.index) % 64;
+  }
+  return 0;
+}
+
+// Compute all distinct legal plays including Joker ranks and Seven splits
+std::vector<BraendiDog::Move> GameState::computeAllLegalMoves() const {
+  MoveList moveList;
+  generateLegalMoves(moveList);
+  std::vector<BraendiDog::Move> legalMoves = moveList.toVector();
+
+  const std::vector<size_t>& hand = players[currentPlayer]->getHand();
+  for (size_t handIndex = 0; handIndex < hand.size(); ++handIndex) {
+    Rank rank = deck[hand[handIndex]].getRank();
+    if (rank == Rank::JOKER) {
+      // Every rank except Seven (handled by the splits below)
+      for (size_t rankCardID = 0; rankCardID < 13; ++rankCardID) {
+        if (deck[rankCardID].getRank() == Rank::SEVEN) {
+          continue;
+        }
+        moveList.clear();
+        generateLegalMoves(
+            moveList,
+            std::array<size_t, 3>{rankCardID, handIndex, hand[handIndex]});
+        std::vector<BraendiDog::Move> jokerMoves = moveList.toVector();
+        legalMoves.insert(legalMoves.end(), jokerMoves.begin(),
+                          jokerMoves.end());
+      }
+    }
+    if (rank == Rank::JOKER || rank == Rank::SEVEN) {
+      std::vector<BraendiDog::Move> splits = computeSevenSplits(handIndex);
+      legalMoves.insert(legalMoves.end(), splits.begin(), splits.end());
+    }
+  }
+
+  // Drop duplicates (e.g. Joker as Ace or King start)
+  std::unordered_set<uint64_t> seen;
+  std::erase_if(legalMoves, [this, &seen](const BraendiDog::Move& move) {
+    return !seen.insert(moveKey(move).value()).second;
+  });
+  return legalMoves;
+}
+
+// Canonical move key
+std::optional<uint64_t> GameState::moveKey(
+    const BraendiDog::Move& move) const {
+  // Final position of every touched marble (later movements win)
+  std::array<std::optional<Position>, 16> finals;
+  for (const auto& [marble, pos] : move.getMovements()) {
+    if (marble.playerID >= 4 || marble.marbleIdx >= 4 ||
+        !players[marble.playerID].has_value()) {
+      return std::nullopt;  // Unknown marble
+    }
+    bool onTrack = pos.boardLocation == BoardLocation::TRACK;
+    size_t maxIndex = onTrack ? 64 : 4;
+    if (static_cast<int>(pos.boardLocation) < 0 ||
+        static_cast<int>(pos.boardLocation) > 2 || pos.index >= maxIndex ||
+        (!onTrack && pos.playerID >= 4)) {
+      return std::nullopt;  // Position outside the board
+    }
+    // Track fields are shared, Position equality ignores their owner
+    Position finalPos = pos;
+    if (onTrack) {
+      finalPos.playerID = 0;
+    }
+    finals[marble.playerID * 4 + marble.marbleIdx] = finalPos;
+  }
+
+  // Order independent combination of the touched marbles
+  uint64_t header = (uint64_t{move.getCardID()} << 32) | move.getHandIndex();
+  uint64_t key = Zobrist::splitmix64(header);
+  for (size_t code = 0; code < finals.size(); ++code) {
+    if (!finals[code].has_value()) {
+      continue;
+    }
+    const Position& pos = finals[code].value();
+    uint64_t item =
+        (((code * 3 + static_cast<size_t>(pos.boardLocation)) * 64 +
+          pos.index) * 4 + pos.playerID) | (uint64_t{1} << 63);
+    key ^= Zobrist::splitmix64(item);
+  }
+  return key;
+}
+
+// Build legal move set
+LegalMoveSet GameState::buildLegalMoveSet() const {
+  LegalMoveSet legalMoves;
+  legalMoves.stateHash = hash();
+  for (const BraendiDog::Move& move : computeAllLegalMoves()) {
+    legalMoves.keys.insert(moveKey(move).value());
+  }
+  return legalMoves;
+}
+
 bool GameState::validJokerFold() const {
   // Valid Joker fold only if no marbles are available for swapping
   // AND each marble is instantly blocked by own marble, blocked start or inner
@@ -1148,16 +1575,7 @@ bool GameState::validJokerFold() const {
     return true;
   }
 
-  std::vector<size_t> blockedStarts;
-  for (size_t pIdx = 0; pIdx < 4; ++pIdx) {
-    const auto& playerOpt = players[pIdx];
-    if (!playerOpt.has_value() && pIdx == currentPlayer) {
-      continue;  // Skip absent players and self
-    }
-    if (playerOpt->isStartBlocked()) {
-      blockedStarts.push_back(playerOpt->getStartField());
-    }
-  }
+  uint64_t blockedStarts = getBlockedStartMask();
 
   for (size_t mIdx = 0; mIdx < marbles.size(); ++mIdx) {
     const Position& marblePos = marbles[mIdx];
@@ -1170,8 +1588,8 @@ bool GameState::validJokerFold() const {
 
     // Check SWAP move possibility
     if (marblePos.boardLocation == BoardLocation::TRACK) {
-      auto swapMoves = checkSwapMove(marblePos);
-      if (swapMoves.has_value()) {
+      MovementBuffer swapMoves;
+      if (checkSwapMove(marblePos, swapMoves)) {
         return false;  // Valid swap move found, cannot fold
       }
     }
@@ -1214,9 +1632,7 @@ bool GameState::validJokerFold() const {
     // If occupant is start blocked marble - valid for fold
     if (marblePos.boardLocation == BoardLocation::TRACK &&
         occupant.has_value()) {
-      if (blockedStarts.end() != std::find(blockedStarts.begin(),
-                                           blockedStarts.end(),
-                                           nextPos.index)) {
+      if ((blockedStarts >> nextPos.index) & uint64_t{1}) {
         continue;
       }
     }
@@ -1239,16 +1655,7 @@ bool GameState::validSevenFold() const {
     return true;
   }
 
-  std::vector<size_t> blockedStarts;
-  for (size_t pIdx = 0; pIdx < 4; ++pIdx) {
-    const auto& playerOpt = players[pIdx];
-    if (!playerOpt.has_value()) {
-      continue;  // Skip absent players and self
-    }
-    if (playerOpt->isStartBlocked()) {
-      blockedStarts.push_back(playerOpt->getStartField());
-    }
-  }
+  uint64_t blockedStarts = getBlockedStartMask();
 
   size_t unblockedFieldCount = 0;
   for (size_t mIdx = 0; mIdx < marbles.size(); ++mIdx) {
@@ -1287,9 +1694,7 @@ bool GameState::validSevenFold() const {
 
       // Check blocked start
       if (nextPos.boardLocation == BoardLocation::TRACK) {
-        if (blockedStarts.end() != std::find(blockedStarts.begin(),
-                                             blockedStarts.end(),
-                                             nextPos.index)) {
+        if ((blockedStarts >> nextPos.index) & uint64_t{1}) {
           unblockedFieldCount -= ownMarblesSkipped;
           break;  // Blocked start field blocks further movement
         }
@@ -1328,18 +1733,26 @@ std::pair<bool, bool> GameState::hasSpecialMoves() const {
 }
 
 bool GameState::hasLegalMoves() const {
-  auto legalMoves = computeLegalMoves();
+  MoveList legalMoves;
+  generateLegalMoves(legalMoves);
   bool hasNormalMoves = !legalMoves.empty();
+  if (hasNormalMoves) {
+    return true;  // No need to check the special cards
+  }
 
   auto [hasJokerMoves, hasSevenMoves] = hasSpecialMoves();
-  std::cout << "Player " << currentPlayer
-            << " has legal moves: " << (hasNormalMoves ? "Yes" : "No")
-            << ", Joker moves: " << (hasJokerMoves ? "Yes" : "No")
-            << ", Seven moves: " << (hasSevenMoves ? "Yes" : "No") << std::endl;
-  return hasNormalMoves || hasJokerMoves || hasSevenMoves;
+  BD_LOG_DEBUG("Engine", "Player " << currentPlayer
+                                   << " has legal moves: No, Joker moves: "
+                                   << (hasJokerMoves ? "Yes" : "No")
+                                   << ", Seven moves: "
+                                   << (hasSevenMoves ? "Yes" : "No"));
+  return hasJokerMoves || hasSevenMoves;
 }
 
-void GameState::applyTempSevenMove(const Move& move) {
+UndoRecord GameState::applyTempSevenMove(const Move& move) {
+  UndoRecord record = snapshot();
+  recordMarbles(record, move);
+
   // Apply each movement in the move
   for (const auto& movement : move.getMovements()) {
     const auto& marbleId = movement.first;
@@ -1347,166 +1760,76 @@ void GameState::applyTempSevenMove(const Move& move) {
 
     // Update marble position
     if (players[marbleId.playerID].has_value()) {
-      players[marbleId.playerID]->setMarblePosition(marbleId.marbleIdx, newPos);
+      moveMarble(marbleId.playerID, marbleId.marbleIdx, newPos);
 
       // Unblock if start-blocked marble moved
       if (players[marbleId.playerID]->isStartBlocked() &&
           players[marbleId.playerID]->getStartBlocked().value() ==
               marbleId.marbleIdx) {
         if (marbleId.playerID != currentPlayer) {
-          std::cerr << "Player " << marbleId.playerID
-                    << "'s start-blocked marble " << marbleId.marbleIdx
-                    << " has moved and is now unblocked -> This should not be "
-                       "allowed with Seven Move."
-                    << std::endl;
+          BD_LOG_WARN("Engine",
+                      "Player " << marbleId.playerID
+                                << "'s start-blocked marble "
+                                << marbleId.marbleIdx
+                                << " has moved and is now unblocked -> This "
+                                   "should not be allowed with Seven Move.");
         }
-        players[marbleId.playerID]->resetStartBlocked();
+        setStartBlocked(marbleId.playerID, std::nullopt);
       }
     }
   }
+  return record;
 }
 
 /// Server Game State Manipulation Methods ///
 
 // Server Validate Turn
 bool GameState::isValidTurn(const BraendiDog::Move& move) const {
+  return isValidTurn(move, buildLegalMoveSet());
+}
+
+// Server Validate Turn (prebuilt legal move set)
+bool GameState::isValidTurn(const BraendiDog::Move& move,
+                            const LegalMoveSet& legalMoves) const {
+  if (legalMoves.stateHash != hash()) {
+    BD_LOG_WARN("Engine", "Legal move set was built for a different state");
+    return false;
+  }
+
   // FOLD
-  // function called without passed move
+  // function called without passed move, valid exactly without legal moves
   if (move.getMovements().empty()) {
-    if (hasLegalMoves()) {
-      std::cerr
-          << "Error: executeFold called when legal moves exist for player "
-          << currentPlayer << std::endl;
+    if (!legalMoves.keys.empty()) {
+      BD_LOG_DEBUG("Engine",
+                   "Rejected fold, legal moves exist for player "
+                       << currentPlayer);
       return false;
     }
     return true;
   }
 
   // MOVE
-  // function called with passed move
-  // translate passed move to arguments for validateMove
-  size_t cardID = move.getCardID();
-  size_t handIndex = move.getHandIndex();
-  const Card& card = deck[cardID];
-  const auto& movements = move.getMovements();
-
   // actively moved marble is the first in movements
-  MarbleIdentifier activeMarbleID = movements[0].first;
+  MarbleIdentifier activeMarbleID = move.getMovements()[0].first;
 
   // Current player validation - must be current player's turn
   if (activeMarbleID.playerID != currentPlayer) {
-    std::cerr << "Error: executeMove called for non-current player "
-              << activeMarbleID.playerID << " (current player is "
-              << currentPlayer << ")" << std::endl;
+    BD_LOG_DEBUG("Engine", "Rejected move of non-current player "
+                               << activeMarbleID.playerID
+                               << " (current player is " << currentPlayer
+                               << ")");
     return false;
   }
 
-  if (card.getRank() == Rank::JOKER) {
-    // Joker move validation not yet implemented
-    // Move follows same logic as normal move so lets assume joker moves are not
-    // cheated ;)
-    // TODO: implement proper joker move validation
-    return true;
-  }
-  if (card.getRank() == Rank::SEVEN) {
-    // Seven move validation not yet implemented
-    // Move follows same logic as normal move so lets assume seven moves are not
-    // cheated ;)
-    // TODO: implement proper seven move validation
-    return true;
-  }
-
-  Position activeMarblePos =
-      players[activeMarbleID.playerID]->getMarblePosition(
-          activeMarbleID.marbleIdx);
-
-  // check all moverules of the card for one valid match
-  for (const auto& moveRule : card.getMoveRules()) {
-    auto validatedMovements = validateMove(card, activeMarblePos, moveRule);
-
-    // if valid check if movements match
-    if (validatedMovements.has_value()) {
-      const auto& valMoves = validatedMovements.value();
-
-      // For multi-option moves (SWAP, finish/track alternatives),
-      // client sends one choice but validateMove returns all options
-      // Skip size check in these cases - matching logic below will verify
-      if (movements.size() < valMoves.size()) {
-        // Multi-option case - continue to matching logic
-      } else if (valMoves.size() != movements.size()) {
-        std::cerr << "Error: Movement count mismatch for player "
-                  << currentPlayer << " - expected " << valMoves.size()
-                  << " movements, got " << movements.size() << std::endl;
-        continue;  // try next moverule
-      }
-
-      // Check if movements match
-      bool allMatch = true;
-
-      if (movements.size() < valMoves.size()) {
-        // Multi-option case: verify client's movements are a valid subset of
-        // valMoves Client picks one option (e.g., finish or track), we verify
-        // it's valid
-        for (const auto& clientMove : movements) {
-          bool matchFound = false;
-          for (const auto& validMove : valMoves) {
-            if (validMove.first.playerID == clientMove.first.playerID &&
-                validMove.first.marbleIdx == clientMove.first.marbleIdx &&
-                validMove.second.boardLocation ==
-                    clientMove.second.boardLocation &&
-                validMove.second.index == clientMove.second.index) {
-              matchFound = true;
-              break;
-            }
-          }
-          if (!matchFound) {
-            allMatch = false;
-            std::cerr << "Error: Movement mismatch for player " << currentPlayer
-                      << " - marble " << clientMove.first.marbleIdx
-                      << " move to position ("
-                      << static_cast<int>(clientMove.second.boardLocation)
-                      << ", " << clientMove.second.index
-                      << ") not found in valid options" << std::endl;
-            break;
-          }
-        }
-      } else {
-        // Normal case: all server movements must be in client's move
-        for (const auto& valMove : valMoves) {
-          bool matchFound = false;
-          for (const auto& moveMovement : movements) {
-            if (valMove.first.playerID == moveMovement.first.playerID &&
-                valMove.first.marbleIdx == moveMovement.first.marbleIdx &&
-                valMove.second.boardLocation ==
-                    moveMovement.second.boardLocation &&
-                valMove.second.index == moveMovement.second.index) {
-              matchFound = true;
-              break;
-            }
-          }
-          if (!matchFound) {
-            allMatch = false;
-            std::cerr << "Error: Movement mismatch for player " << currentPlayer
-                      << " - marble " << valMove.first.marbleIdx
-                      << " expected at position ("
-                      << static_cast<int>(valMove.second.boardLocation) << ", "
-                      << valMove.second.index << ")" << std::endl;
-            break;
-          }
-        }
-      }
-
-      if (allMatch) {
-        return true;  // valid move found
-      }
-    }
+  // Look up canonical move in the legal move set
+  std::optional<uint64_t> key = moveKey(move);
+  if (!key.has_value() || !legalMoves.keys.contains(key.value())) {
+    BD_LOG_DEBUG("Engine", "Rejected move of player "
+                               << activeMarbleID.playerID
+                               << " - no matching legal move found");
+    return false;
   }
-
-  // no valid moverule match found
-  std::cerr << "Error: executeMove called with invalid move for player "
-            << activeMarbleID.playerID << " - no matching move rule found"
-            << std::endl;
-  return false;
+  return true;
 }
 
 // Turn end check and procedures
@@ -1546,7 +1869,7 @@ std::pair<bool, bool> GameState::endTurn() {
 // Execute Fold
 void GameState::executeFold() {
   // Remove all cards from player's hand
-  players[currentPlayer]->setHand(std::vector<size_t>());
+  setHand(currentPlayer, {});
 
   // Check if players round ended
   // Update player status accordingly
@@ -1556,7 +1879,7 @@ void GameState::executeFold() {
 }
 
 // Execute Move
-bool GameState::executeMove(BraendiDog::Move move) {
+bool GameState::executeMove(const BraendiDog::Move& move) {
   // Update marble positions
   for (const auto& movement : move.getMovements()) {
     size_t pID = movement.first.playerID;
@@ -1566,7 +1889,7 @@ bool GameState::executeMove(BraendiDog::Move move) {
                         BoardLocation::HOME;
 
     // Update marble position
-    players[pID]->setMarblePosition(mIdx, newPos);
+    moveMarble(pID, mIdx, newPos);
 
     // Update start blockage status
     // Check if current player marble moved from start field for the first time
@@ -1575,11 +1898,11 @@ bool GameState::executeMove(BraendiDog::Move move) {
       std::optional<size_t> startBlocked =
           players[currentPlayer]->getStartBlocked();
       if (startBlocked.has_value() && startBlocked.value() == mIdx) {
-        players[currentPlayer]->resetStartBlocked();
+        setStartBlocked(currentPlayer, std::nullopt);
       }
       // Block start field if marble moves to start field from home
       else if (moveFromHome) {
-        players[currentPlayer]->setStartBlocked(mIdx);
+        setStartBlocked(currentPlayer, mIdx);
       }
     }
   }
@@ -1587,7 +1910,7 @@ bool GameState::executeMove(BraendiDog::Move move) {
   // Remove card from player's hand
   // Update last played card
   size_t handIndex = move.getHandIndex();
-  lastPlayedCard = players[currentPlayer]->popCardFromHand(handIndex);
+  lastPlayedCard = popCardFromHand(currentPlayer, handIndex);
 
   // Check if players round ended
   // Update player status accordingly
@@ -1598,8 +1921,7 @@ bool GameState::executeMove(BraendiDog::Move move) {
   // Check if player has finished
   // Update status & leaderboard accordingly
   if (players[currentPlayer]->checkFinished()) {
-    players[currentPlayer]->setHand(
-        std::vector<size_t>());  // remove any remaining cards
+    setHand(currentPlayer, {});  // remove any remaining cards
     players[currentPlayer]->setActiveInRound(false);
     players[currentPlayer]->setActiveInGame(false);
     addLeaderBoardFinished(currentPlayer);
@@ -1609,4 +1931,180 @@ bool GameState::executeMove(BraendiDog::Move move) {
   return false;
 }
 
+/// Make/Unmake Methods ///
+
+// Record all non-marble attributes touched by a move and the following endTurn
+UndoRecord GameState::snapshot() const {
+  UndoRecord record;
+  record.handPlayer = currentPlayer;
+  const std::vector<size_t>& hand = players[currentPlayer]->getHand();
+  if (hand.size() > record.hand.size()) {
+    throw std::length_error("Hand too large for UndoRecord");
+  }
+  std::copy(hand.begin(), hand.end(), record.hand.begin());
+  record.handSize = hand.size();
+
+  for (size_t pID = 0; pID < 4; ++pID) {
+    if (!players[pID].has_value()) {
+      continue;  // Skip absent players
+    }
+    record.startBlocked[pID] = players[pID]->getStartBlocked();
+    record.activeInRound[pID] = players[pID]->isActiveInRound();
+    record.activeInGame[pID] = players[pID]->isActiveInGame();
+  }
+
+  record.currentPlayer = currentPlayer;
+  record.roundStartPlayer = roundStartPlayer;
+  record.roundCardCount = roundCardCount;
+  record.lastPlayedCard = lastPlayedCard;
+  record.leaderBoard = leaderBoard;
+  record.hash = hash();
+  return record;
+}
+
+// Record previous positions of all marbles moved by a move
+void GameState::recordMarbles(UndoRecord& record, const Move& move) const {
+  for (const auto& movement : move.getMovements()) {
+    if (record.marbleCount == record.marbles.size()) {
+      throw std::length_error("Too many movements for UndoRecord");
+    }
+    size_t pID = movement.first.playerID;
+    size_t mIdx = movement.first.marbleIdx;
+    if (!players[pID].has_value()) {
+      continue;  // Absent players are never moved
+    }
+    record.marbles[record.marbleCount++] = {
+        pID, mIdx, players[pID]->getMarblePosition(mIdx)};
+  }
+}
+
+// Execute move with undo information
+UndoRecord GameState::makeMove(const BraendiDog::Move& move) {
+  UndoRecord record = snapshot();
+  recordMarbles(record, move);
+  record.finished = executeMove(move);
+  return record;
+}
+
+// Execute fold with undo information
+UndoRecord GameState::makeFold() {
+  UndoRecord record = snapshot();
+  executeFold();
+  return record;
+}
+
+// Revert a made move
+void GameState::unmakeMove(const UndoRecord& record) {
+  // Restore marbles in reverse order so swaps and captures resolve correctly
+  for (size_t i = record.marbleCount; i-- > 0;) {
+    const UndoRecord::MarbleChange& change = record.marbles[i];
+    moveMarble(change.playerID, change.marbleIdx, change.oldPos);
+  }
+
+  players[record.handPlayer]->restoreHand(
+      std::span<const size_t>(record.hand.data(), record.handSize));
+
+  for (size_t pID = 0; pID < 4; ++pID) {
+    if (!players[pID].has_value()) {
+      continue;  // Skip absent players
+    }
+    if (record.startBlocked[pID].has_value()) {
+      players[pID]->setStartBlocked(record.startBlocked[pID].value());
+    } else {
+      players[pID]->resetStartBlocked();
+    }
+    players[pID]->setActiveInRound(record.activeInRound[pID]);
+    players[pID]->setActiveInGame(record.activeInGame[pID]);
+  }
+
+  currentPlayer = record.currentPlayer;
+  roundStartPlayer = record.roundStartPlayer;
+  roundCardCount = record.roundCardCount;
+  lastPlayedCard = record.lastPlayedCard;
+  leaderBoard = record.leaderBoard;
+  zobristHash = record.hash;
+}
+
+//// Delta Updates ////
+
+// Changes since an earlier state of the same game
+GameStateDelta GameState::diff(const GameState& previous) const {
+  GameStateDelta delta;
+  for (size_t pID = 0; pID < 4; ++pID) {
+    const auto& now = players[pID];
+    const auto& before = previous.players[pID];
+    if (now.has_value() != before.has_value()) {
+      throw std::invalid_argument("Player slots differ");
+    }
+    if (!now.has_value()) {
+      continue;  // Skip absent players
+    }
+    for (size_t mIdx = 0; mIdx < 4; ++mIdx) {
+      const Position& pos = now->getMarblePosition(mIdx);
+      if (pos != before->getMarblePosition(mIdx)) {
+        delta.marbles.push_back({pID, mIdx, pos});
+      }
+    }
+    if (now->getStartBlocked() != before->getStartBlocked() ||
+        now->isActiveInRound() != before->isActiveInRound() ||
+        now->isActiveInGame() != before->isActiveInGame()) {
+      delta.players.push_back({pID, now->getStartBlocked(),
+                               now->isActiveInRound(), now->isActiveInGame()});
+    }
+  }
+
+  delta.currentPlayer = currentPlayer;
+  delta.roundStartPlayer = roundStartPlayer;
+  delta.roundCardCount = roundCardCount;
+  delta.lastPlayedCard = lastPlayedCard;
+  if (leaderBoard != previous.leaderBoard) {
+    delta.leaderBoard = leaderBoard;
+  }
+  return delta;
+}
+
+// Apply changes computed by diff
+void GameState::applyDelta(const GameStateDelta& delta) {
+  auto present = [this](size_t pID) {
+    return pID < 4 && players[pID].has_value();
+  };
+  // Check everything first so a bad delta leaves the state untouched
+  for (const auto& marble : delta.marbles) {
+    if (!present(marble.playerID) || marble.marbleIdx >= 4) {
+      throw std::invalid_argument("Delta moves an invalid marble");
+    }
+  }
+  for (const auto& player : delta.players) {
+    if (!present(player.playerID) ||
+        player.startBlocked.value_or(0) >= 4) {
+      throw std::invalid_argument("Delta updates an invalid player");
+    }
+  }
+  if (delta.currentPlayer >= 4 || delta.roundStartPlayer >= 4) {
+    throw std::invalid_argument("Delta has an invalid current player");
+  }
+
+  for (const auto& marble : delta.marbles) {
+    players[marble.playerID]->setMarblePosition(marble.marbleIdx, marble.pos);
+  }
+  for (const auto& player : delta.players) {
+    auto& target = players[player.playerID];
+    if (player.startBlocked.has_value()) {
+      target->setStartBlocked(player.startBlocked.value());
+    } else {
+      target->resetStartBlocked();
+    }
+    target->setActiveInRound(player.activeInRound);
+    target->setActiveInGame(player.activeInGame);
+  }
+  currentPlayer = delta.currentPlayer;
+  roundStartPlayer = delta.roundStartPlayer;
+  roundCardCount = delta.roundCardCount;
+  lastPlayedCard = delta.lastPlayedCard;
+  if (delta.leaderBoard.has_value()) {
+    leaderBoard = delta.leaderBoard.value();
+  }
+  derivedStale = true;
+}
+
 }  // namespace BraendiDog
@@ -7,12 +7,18 @@
 
 #include <array>
 #include <cstddef>
+#include <map>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "shared/game_objects.hpp"
 #include "shared/game_types.hpp"
+#include "shared/move_list.hpp"
+#include "shared/occupancy.hpp"
+#include "shared/rng.hpp"
+#include "shared/zobrist.hpp"
 
 /**
  * @namespace BraendiDog
@@ -23,6 +29,101 @@
  */
 namespace BraendiDog {
 
+/**
+ * @brief Canonical keys of all legal moves of one game state.
+ *
+ * Built by GameState::buildLegalMoveSet and reused for all validations of
+ * the same state (e.g. retries of a rejected move).
+ */
+struct LegalMoveSet {
+  uint64_t stateHash = 0;              ///< GameState::hash() of the state.
+  std::unordered_set<uint64_t> keys;  ///< GameState::moveKey() of each move.
+};
+
+/**
+ * @brief Snapshot of the GameState attributes changed by GameState::makeMove.
+ *
+ * Restored by GameState::unmakeMove. Also covers the changes of a following
+ * GameState::endTurn call.
+ */
+struct UndoRecord {
+  /**
+   * @brief Previous position of one moved marble.
+   */
+  struct MarbleChange {
+    size_t playerID;   ///< ID of the player owning the marble.
+    size_t marbleIdx;  ///< Index of the marble.
+    Position oldPos;   ///< Position before the move.
+  };
+
+  std::array<MarbleChange, 16> marbles;  ///< Moved marbles in move order.
+  size_t marbleCount = 0;                ///< Number of recorded marbles.
+
+  size_t handPlayer = 0;        ///< Player whose hand was changed.
+  std::array<size_t, 6> hand;   ///< Hand of handPlayer before the move.
+  size_t handSize = 0;          ///< Number of cards in hand.
+
+  std::array<std::optional<size_t>, 4>
+      startBlocked;  ///< Start blocked status of all players.
+  std::array<bool, 4> activeInRound{};  ///< Active in round of all players.
+  std::array<bool, 4> activeInGame{};   ///< Active in game of all players.
+
+  size_t currentPlayer = 0;     ///< Current player before the move.
+  size_t roundStartPlayer = 0;  ///< Round start player before the move.
+  size_t roundCardCount = 0;    ///< Round card count before the move.
+  std::optional<size_t> lastPlayedCard;  ///< Last played card before the move.
+  uint64_t hash = 0;  ///< Zobrist hash before the move.
+  std::array<std::optional<int>, 4> leaderBoard;  ///< Leaderboard before the
+                                                  ///< move.
+
+  bool finished = false;  ///< True if the move was the players finish move.
+};
+
+/**
+ * @brief Changes between two broadcast states of the same game.
+ *
+ * Built by GameState::diff on the server and applied with
+ * GameState::applyDelta by the clients. Deck, names and start fields never
+ * change during a game and hands are not broadcast, so they are not covered.
+ */
+struct GameStateDelta {
+  /**
+   * @brief New position of one moved marble.
+   */
+  struct MarbleUpdate {
+    size_t playerID = 0;   ///< ID of the player owning the marble.
+    size_t marbleIdx = 0;  ///< Index of the marble.
+    Position pos;          ///< Position after the change.
+  };
+
+  /**
+   * @brief New status of one player.
+   */
+  struct PlayerUpdate {
+    size_t playerID = 0;                 ///< ID of the player.
+    std::optional<size_t> startBlocked;  ///< Start blocked status.
+    bool activeInRound = false;          ///< Active in round status.
+    bool activeInGame = false;           ///< Active in game status.
+  };
+
+  std::vector<MarbleUpdate> marbles;  ///< Marbles that moved.
+  std::vector<PlayerUpdate> players;  ///< Players whose status changed.
+  size_t currentPlayer = 0;           ///< Current player.
+  size_t roundStartPlayer = 0;        ///< Round start player.
+  size_t roundCardCount = 6;          ///< Round card count.
+  std::optional<size_t> lastPlayedCard;  ///< Last played card.
+  std::optional<std::array<std::optional<int>, 4>>
+      leaderBoard;  ///< New leaderboard, nullopt if unchanged.
+};
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(GameStateDelta::MarbleUpdate, playerID,
+                                   marbleIdx, pos)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(GameStateDelta::PlayerUpdate, playerID,
+                                   startBlocked, activeInRound, activeInGame)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(GameStateDelta, marbles, players,
+                                   currentPlayer, roundStartPlayer,
+                                   roundCardCount, lastPlayedCard, leaderBoard)
+
 /**
  * @brief GameState implementation holding the full state of a BraendiDog game.
  *
@@ -37,14 +138,63 @@ class GameState {
   std::array<std::optional<Player>, 4>
       players;  ///< Array of all player slots holding optional present player
                 ///< instances.
-  size_t currentPlayer;  ///< Index of the current player (who's turn it is).
-  size_t
-      roundStartPlayer;  ///< Index of the player who started the current round.
-  size_t roundCardCount;  ///< Number of cards dealt in the current round.
+  size_t currentPlayer =
+      0;  ///< Index of the current player (who's turn it is).
+  size_t roundStartPlayer =
+      0;  ///< Index of the player who started the current round.
+  size_t roundCardCount = 6;  ///< Number of cards dealt in the current round.
   std::optional<size_t>
       lastPlayedCard;  ///< ID of the last played card for display.
   std::array<std::optional<int>, 4>
       leaderBoard;  ///< Player IDs in finishing order.
+  Xoshiro256 rng;  ///< Per-game generator used for dealing.
+
+  mutable OccupancyIndex
+      occupancy;  ///< Bitboard index of the marble positions of all players.
+  mutable uint64_t zobristHash = 0;  ///< Zobrist hash of the state.
+  mutable bool derivedStale =
+      true;  ///< True if players may have changed outside of the occupancy
+             ///< index and hash.
+
+  /**
+   * @brief Rebuild the occupancy index and hash from scratch if stale.
+   */
+  void refreshDerived() const;
+
+  /**
+   * @brief Get the occupancy index, rebuilding it from the players if stale.
+   * @return Constant reference to the up to date occupancy index.
+   */
+  const OccupancyIndex& getOccupancy() const;
+
+  /**
+   * @brief Compute the hash contribution of a player's hand.
+   * @param playerID ID of the player.
+   * @return XOR of the hand keys of all cards in hand.
+   */
+  uint64_t handHash(size_t playerID) const;
+
+  /**
+   * @brief Move a marble and keep the occupancy index in sync.
+   * @param playerID ID of the player owning the marble.
+   * @param marbleIdx Index of the marble.
+   * @param newPos New position of the marble.
+   * @note Does not handle captures, the target field has to be vacated first.
+   */
+  void moveMarble(size_t playerID, size_t marbleIdx, const Position& newPos);
+
+  /**
+   * @brief Record all attributes except marble positions for an UndoRecord.
+   * @return UndoRecord without marble changes.
+   */
+  UndoRecord snapshot() const;
+
+  /**
+   * @brief Record the previous positions of the marbles moved by a move.
+   * @param record UndoRecord to append to.
+   * @param move Move whose marbles are recorded.
+   */
+  void recordMarbles(UndoRecord& record, const Move& move) const;
 
  public:
   // Constructors
@@ -56,12 +206,14 @@ class GameState {
    * @brief Constructor for GameState initializing players.
    * @param gamePlayers Array of optional player names for each of the 4 player
    * slots.
+   * @param seed Optional seed of the deal generator, random if not given.
    * @note Present players need a name, absent players are represented by
    * std::nullopt.
    */
-  GameState(const std::array<std::optional<std::string>, 4>&
-                gamePlayers);  // takes player names in array representing 4
-                               // players and IDs as indices
+  GameState(const std::array<std::optional<std::string>, 4>& gamePlayers,
+            std::optional<uint64_t> seed =
+                std::nullopt);  // takes player names in array representing 4
+                                // players and IDs as indices
 
   // Friend declaration for JSON serialization
   /**
@@ -76,6 +228,12 @@ class GameState {
    * @param gs Reference to a GameState instance.
    */
   friend void from_json(const nlohmann::json& j, GameState& gs);
+  /**
+   * @brief Friend declaration for binary deserialization (wire_format.hpp).
+   * @param reader Reader positioned at the game state.
+   * @param gs Reference to a GameState instance.
+   */
+  friend void readBinary(BinaryReader& reader, GameState& gs);
 
   // Getters
   /**
@@ -86,7 +244,9 @@ class GameState {
   /**
    * @brief Get the array of players.
    * @return Reference to the array of optional Player instances.
-   * @note const and non-const versions provided.
+   * @note const and non-const versions provided. The non-const versions mark
+   * the occupancy index stale, so fetch them again before moving marbles
+   * after any query. The setters below keep it in sync instead.
    */
   const std::array<std::optional<Player>, 4>& getPlayers() const;
   std::array<std::optional<BraendiDog::Player>, 4>& getPlayers();
@@ -119,6 +279,25 @@ class GameState {
    * @note Nullopt at round start.
    */
   std::optional<size_t> getLastPlayedCard() const;
+  /**
+   * @brief Get the Zobrist hash of the state.
+   * @return 64-bit hash of marble positions, startBlocked, currentPlayer,
+   * roundCardCount and hand contents (in hand order).
+   * @note Updated incrementally by the state manipulation methods.
+   */
+  uint64_t hash() const;
+  /**
+   * @brief Compute the Zobrist hash from scratch, ignoring the incrementally
+   * updated one.
+   * @return Value hash() has to match (for verification).
+   */
+  uint64_t rebuildHash() const;
+  /**
+   * @brief Get the hash of what the current player's legal moves depend on.
+   * @return hash() without the hands of the other players.
+   * @note Determinizations that only differ in hidden hands share this hash.
+   */
+  uint64_t moveHash() const;
   /**
    * @brief Get the leaderboard of finished players.
    * @return Constant reference to the array of player IDs in finishing order.
@@ -165,6 +344,47 @@ class GameState {
    * TODO: Possibly handle disconect after finish differently.
    */
   void addLeaderBoardDisconnected(size_t playerID);
+  /**
+   * @brief Replace the hand of a player and keep the hash in sync.
+   * @param playerID ID of the player.
+   * @param hand Card IDs of the new hand.
+   */
+  void setHand(size_t playerID, const std::vector<size_t>& hand);
+  /**
+   * @brief Remove a card from the hand of a player and keep the hash in sync.
+   * @param playerID ID of the player.
+   * @param handIndex Index of the card in the hand.
+   * @return ID of the removed card.
+   */
+  size_t popCardFromHand(size_t playerID, size_t handIndex);
+  /**
+   * @brief Place a marble and keep the occupancy index and hash in sync.
+   * @param playerID ID of the player owning the marble.
+   * @param marbleIdx Index of the marble.
+   * @param pos New position of the marble.
+   * @note Sets up positions, does not capture. Placing a marble onto an
+   * occupied field rebuilds the index on the next query.
+   */
+  void setMarblePosition(size_t playerID, size_t marbleIdx,
+                         const Position& pos);
+  /**
+   * @brief Set or reset the start blocked marble and keep the hash in sync.
+   * @param playerID ID of the player.
+   * @param marbleIdx Optional index of the blocking marble, nullopt to reset.
+   */
+  void setStartBlocked(size_t playerID, std::optional<size_t> marbleIdx);
+  /**
+   * @brief Set whether a player still plays in the current round.
+   * @param playerID ID of the player.
+   * @param isActive True if the player is active in the round.
+   */
+  void setActiveInRound(size_t playerID, bool isActive);
+  /**
+   * @brief Set whether a player still plays in the game.
+   * @param playerID ID of the player.
+   * @param isActive True if the player is active in the game.
+   */
+  void setActiveInGame(size_t playerID, bool isActive);
 
   // Methods
   /**
@@ -204,10 +424,26 @@ class GameState {
   std::vector<size_t> getActivePlayerIndices() const;
 
   /**
-   * @brief Deal cards to players.
+   * @brief Deal cards to players using the game's own generator.
    * @return A map of active player IDs to a vector of their dealt card IDs.
    */
-  std::map<size_t, std::vector<size_t>> dealCards() const;
+  std::map<size_t, std::vector<size_t>> dealCards();
+  /**
+   * @brief Deal cards to players with a caller provided generator.
+   * @param generator Random generator used for shuffling.
+   * @return A map of active player IDs to a vector of their dealt card IDs.
+   */
+  std::map<size_t, std::vector<size_t>> dealCards(Xoshiro256& generator) const;
+  /**
+   * @brief Reseed the deal generator (e.g. to replay a game).
+   * @param seed New seed.
+   */
+  void reseed(uint64_t seed);
+  /**
+   * @brief Get the deal generator.
+   * @return Constant reference to the generator.
+   */
+  const Xoshiro256& getRng() const;
 
   /// Move Validation and Computation ///
 
@@ -220,29 +456,70 @@ class GameState {
   std::optional<BraendiDog::MarbleIdentifier> isFieldOccupied(
       const Position& pos) const;
 
+  /**
+   * @brief Get the bitmask of occupied track fields.
+   * @return 64-bit mask with bit i set if track field i is occupied.
+   */
+  uint64_t getTrackMask() const;
+
+  /**
+   * @brief Get the bitmask of occupied finish fields of a player.
+   * @param playerID ID of the player owning the finish area.
+   * @return 4-bit mask with bit i set if finish field i is occupied.
+   */
+  uint8_t getFinishMask(size_t playerID) const;
+
+  /**
+   * @brief Get the bitmask of start fields blocked by a marble.
+   * @return 64-bit mask with bit i set if track field i is a blocked start.
+   */
+  uint64_t getBlockedStartMask() const;
+
   /**
    * @brief Check Start Move validity and end position.
    */
   std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
   checkStartMove(const Position& marblePos) const;
+  /**
+   * @brief Check Start Move validity, appending the movements to a buffer.
+   * @return True if at least one movement was appended.
+   */
+  bool checkStartMove(const Position& marblePos, MovementBuffer& out) const;
 
   /**
    * @brief Check Simple Move validity and end position.
    */
   std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
   checkSimpleMove(const Position& marblePos, int moveValue) const;
+  /**
+   * @brief Check Simple Move validity, appending the movements to a buffer.
+   * @return True if at least one movement was appended.
+   */
+  bool checkSimpleMove(const Position& marblePos, int moveValue,
+                       MovementBuffer& out) const;
 
   /**
    * @brief Check Seven Move validity and end position(s).
    */
   std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
   checkSevenMove(const Position& marblePos, int moveValue) const;
+  /**
+   * @brief Check Seven Move validity, appending the movements to a buffer.
+   * @return True if at least one movement was appended.
+   */
+  bool checkSevenMove(const Position& marblePos, int moveValue,
+                      MovementBuffer& out) const;
 
   /**
    * @brief Check Swap Move validity and end position(s).
    */
   std::optional<std::vector<std::pair<MarbleIdentifier, Position>>>
   checkSwapMove(const Position& marblePos) const;
+  /**
+   * @brief Check Swap Move validity, appending the movements to a buffer.
+   * @return True if at least one movement was appended.
+   */
+  bool checkSwapMove(const Position& marblePos, MovementBuffer& out) const;
 
   /**
    * @brief Check Joker Move validity and end position(s).
@@ -261,15 +538,53 @@ class GameState {
   validateMove(const Card& card, const Position& marblePos,
                const std::pair<MoveType, int>& moveRule,
                bool sevenCall = false) const;
+  /**
+   * @brief Validate a proposed move, appending the movements to a buffer.
+   * @return True if at least one movement was appended.
+   */
+  bool validateMove(const Card& card, const Position& marblePos,
+                    const std::pair<MoveType, int>& moveRule, bool sevenCall,
+                    MovementBuffer& out) const;
 
   /**
    * @brief Compute all legal plays for the current player given their hand and
    * marble positions.
+   * @note Thin wrapper around generateLegalMoves().
    */
   std::vector<BraendiDog::Move> computeLegalMoves(
       std::optional<std::array<size_t, 3>> Special = std::nullopt,
       bool sevenCall = false) const;
 
+  /**
+   * @brief Generate all legal plays for the current player without heap
+   * allocations.
+   * @param legalMoves Move list the legal moves are appended to.
+   * @param Special Optional {rule card ID, hand index, played card ID} for
+   * Joker and Seven computations.
+   * @param sevenCall True if computing the parts of a Seven move.
+   */
+  void generateLegalMoves(
+      MoveList& legalMoves,
+      std::optional<std::array<size_t, 3>> Special = std::nullopt,
+      bool sevenCall = false) const;
+
+  /**
+   * @brief Enumerate every complete Seven split of the current player.
+   * @param handIndex Index of the Seven (or Joker played as Seven) in hand.
+   * @return One composite move per distinct outcome, using all 7 steps.
+   * Captures are included right after the part that causes them.
+   * @throws std::out_of_range if the hand index is invalid.
+   */
+  std::vector<BraendiDog::Move> computeSevenSplits(size_t handIndex) const;
+
+  /**
+   * @brief Count the steps of a walking movement of the current player.
+   * @param from Start position of the marble (TRACK or FINISH).
+   * @param to End position of the marble.
+   * @return Number of steps walked, 0 if not a forward walk.
+   */
+  size_t sevenSteps(const Position& from, const Position& to) const;
+
   /**
    * @brief Check if folding with a Joker in Hand is valid for the current
    * player.
@@ -297,15 +612,50 @@ class GameState {
   /**
    * @brief Apply a move to update marble positions (client-side preview)
    * @param move The move to apply
+   * @return UndoRecord to revert the move with unmakeMove().
    * @note This does not validate the move, only updates positions
    */
-  void applyTempSevenMove(const Move& move);
+  UndoRecord applyTempSevenMove(const Move& move);
+
+  /**
+   * @brief Compute all legal plays of the current player including every
+   * Joker rank and every complete Seven split.
+   * @note Moves with the same moveKey() (same outcome) are listed once.
+   */
+  std::vector<BraendiDog::Move> computeAllLegalMoves() const;
 
-  /// Server Game State Manipulation Methods ///
   /**
+   * @brief Build the canonical key of a move.
+   *
+   * The key covers card, hand index and the final position of every touched
+   * marble, so Seven parts in a different order map to the same key. Like
+   * Position equality, it ignores the player ID of track positions.
+   * @return Key of the move, nullopt if the move references invalid marbles or
+   * positions.
+   */
+  std::optional<uint64_t> moveKey(const BraendiDog::Move& move) const;
+
+  /**
+   * @brief Build the legal move set of the current state.
+   */
+  LegalMoveSet buildLegalMoveSet() const;
 
+  /// Server Game State Manipulation Methods ///
+  /**
+   * @brief Validate a move (or fold if no movements are passed).
+   *
+   * A fold is valid exactly when the legal move set is empty.
+   * @note Builds the legal move set on each call, prefer the overload taking a
+   * prebuilt set when validating repeatedly.
    */
   bool isValidTurn(const BraendiDog::Move& move = Move()) const;
+  /**
+   * @brief Validate a move against a prebuilt legal move set.
+   * @param move Move to validate (fold if no movements).
+   * @param legalMoves Legal move set built for this state.
+   */
+  bool isValidTurn(const BraendiDog::Move& move,
+                   const LegalMoveSet& legalMoves) const;
 
   /**
    * @brief Perform all Turn-Round-Game logic checks and GameState updates.
@@ -325,13 +675,51 @@ class GameState {
    * @param move Move to execute.
    * @return True if the move was the players finish move, false otherwise.
    */
-  bool executeMove(BraendiDog::Move move);
+  bool executeMove(const BraendiDog::Move& move);
+
+  /**
+   * @brief Execute a move and record how to revert it.
+   * @param move Move to execute (not validated).
+   * @return UndoRecord to pass to unmakeMove().
+   * @note A following endTurn() is reverted by unmakeMove() as well.
+   */
+  UndoRecord makeMove(const BraendiDog::Move& move);
+
+  /**
+   * @brief Execute a fold and record how to revert it.
+   * @return UndoRecord to pass to unmakeMove().
+   */
+  UndoRecord makeFold();
+
+  /**
+   * @brief Revert a move made with makeMove() or makeFold().
+   * @param record UndoRecord returned by the matching make call.
+   * @note Records have to be unmade in reverse order of making.
+   */
+  void unmakeMove(const UndoRecord& record);
 
   /**
    * @brief Update a players attributes if disconnected.
    * @param playerIndex Index of the player to disconnect.
    */
   void disconnectPlayer(size_t playerIndex);
+
+  /// Delta Updates ///
+  /**
+   * @brief Compute the changes from an earlier state of the same game.
+   * @param previous Earlier state with the same players.
+   * @return Delta turning previous into this state (except hands).
+   * @throws std::invalid_argument if the player slots differ.
+   */
+  GameStateDelta diff(const GameState& previous) const;
+
+  /**
+   * @brief Apply changes computed by diff() to the earlier state.
+   * @param delta Changes to apply.
+   * @throws std::invalid_argument if the delta references absent players or
+   * invalid indices, the state is left unchanged then.
+   */
+  void applyDelta(const GameStateDelta& delta);
 };
 
 // Inline Serialization of GameState to JSON.
@@ -348,6 +736,7 @@ inline void to_json(nlohmann::json& j, const GameState& gs) {
   j["roundCardCount"] = gs.getRoundCardCount();
   j["lastPlayedCard"] = gs.getLastPlayedCard();
   j["leaderBoard"] = gs.getLeaderBoard();
+  j["rng"] = gs.getRng();
 };
 
 // Inline Deserialization of GameState from JSON.
@@ -364,6 +753,10 @@ inline void from_json(const nlohmann::json& j, GameState& gs) {
   gs.roundCardCount = j.at("roundCardCount").get<size_t>();
   gs.lastPlayedCard = j.at("lastPlayedCard").get<std::optional<size_t>>();
   gs.leaderBoard = j.at("leaderBoard").get<std::array<std::optional<int>, 4>>();
+  if (j.contains("rng")) {  // Not sent to clients
+    gs.rng = j.at("rng").get<Xoshiro256>();
+  }
+  gs.derivedStale = true;
 };
 
 }  // namespace BraendiDog
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <nlohmann/json.hpp>
+#include <stdexcept>
 #include <utility>
 #include <vector>
 
@@ -11,55 +12,8 @@ namespace BraendiDog {
 
 // Card Constructor
 Card::Card(Rank r, Suit s) : rank(r), suit(s) {
-  switch (r) {
-    case Rank::ACE:
-      moveRules.emplace_back(MoveType::SIMPLE, 1);
-      moveRules.emplace_back(MoveType::SIMPLE, 11);
-      moveRules.emplace_back(MoveType::START, 0);
-      break;
-    case Rank::TWO:
-      moveRules.emplace_back(MoveType::SIMPLE, 2);
-      break;
-    case Rank::THREE:
-      moveRules.emplace_back(MoveType::SIMPLE, 3);
-      break;
-    case Rank::FOUR:
-      moveRules.emplace_back(MoveType::SIMPLE, 4);
-      moveRules.emplace_back(MoveType::SIMPLE, -4);
-      break;
-    case Rank::FIVE:
-      moveRules.emplace_back(MoveType::SIMPLE, 5);
-      break;
-    case Rank::SIX:
-      moveRules.emplace_back(MoveType::SIMPLE, 6);
-      break;
-    case Rank::SEVEN:
-      moveRules.emplace_back(MoveType::SEVEN, 7);
-      break;
-    case Rank::EIGHT:
-      moveRules.emplace_back(MoveType::SIMPLE, 8);
-      break;
-    case Rank::NINE:
-      moveRules.emplace_back(MoveType::SIMPLE, 9);
-      break;
-    case Rank::TEN:
-      moveRules.emplace_back(MoveType::SIMPLE, 10);
-      break;
-    case Rank::JACK:
-      moveRules.emplace_back(MoveType::SWAP, 0);
-      break;
-    case Rank::QUEEN:
-      moveRules.emplace_back(MoveType::SIMPLE, 12);
-      break;
-    case Rank::KING:
-      moveRules.emplace_back(MoveType::SIMPLE, 13);
-      moveRules.emplace_back(MoveType::START, 0);
-      break;
-    case Rank::JOKER:
-      moveRules.emplace_back(MoveType::JOKER, 0);
-      break;
-    default:
-      throw std::invalid_argument("Invalid card rank");
+  if (static_cast<size_t>(r) >= CardRules::ruleCounts.size()) {
+    throw std::invalid_argument("Invalid card rank");
   }
 }
 
@@ -69,11 +23,6 @@ Rank Card::getRank() const { return rank; }
 // Get Card Suit
 Suit Card::getSuit() const { return suit; }
 
-// Get Card Move Rules
-const std::vector<std::pair<MoveType, int>>& Card::getMoveRules() const {
-  return moveRules;
-}
-
 // Player Methods
 
 // Player Constructor
@@ -183,6 +132,11 @@ void Player::resetStartBlocked() { startBlocked = std::nullopt; }
 // Set Player Hand
 void Player::setHand(const std::vector<size_t>& cardIds) { hand = cardIds; }
 
+// Restore Player Hand
+void Player::restoreHand(std::span<const size_t> cardIds) {
+  hand.assign(cardIds.begin(), cardIds.end());
+}
+
 // Pop Card From Hand
 size_t Player::popCardFromHand(size_t handIndex) {
   if (handIndex >= hand.size()) {
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <nlohmann/json.hpp>
+#include <span>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -15,15 +18,74 @@
 
 namespace BraendiDog {
 
+class BinaryReader;  // Binary wire format, see wire_format.hpp
+
+/**
+ * @brief Move rule of a card (move type and value).
+ */
+using MoveRule = std::pair<MoveType, int>;
+
+/**
+ * @brief Compile time move rule tables shared by all cards.
+ */
+namespace CardRules {
+
+/// All move rules, grouped by rank in Rank order.
+inline constexpr std::array<MoveRule, 18> rules = {{
+    {MoveType::SIMPLE, 1},  {MoveType::SIMPLE, 11}, {MoveType::START, 0},  // A
+    {MoveType::SIMPLE, 2},                                                 // 2
+    {MoveType::SIMPLE, 3},                                                 // 3
+    {MoveType::SIMPLE, 4},  {MoveType::SIMPLE, -4},                        // 4
+    {MoveType::SIMPLE, 5},                                                 // 5
+    {MoveType::SIMPLE, 6},                                                 // 6
+    {MoveType::SEVEN, 7},                                                  // 7
+    {MoveType::SIMPLE, 8},                                                 // 8
+    {MoveType::SIMPLE, 9},                                                 // 9
+    {MoveType::SIMPLE, 10},                                                // 10
+    {MoveType::SWAP, 0},                                                   // J
+    {MoveType::SIMPLE, 12},                                                // Q
+    {MoveType::SIMPLE, 13}, {MoveType::START, 0},                          // K
+    {MoveType::JOKER, 0},                                                  // Joker
+}};
+
+/// Number of rules per rank, in Rank order.
+inline constexpr std::array<size_t, 14> ruleCounts = {3, 1, 1, 2, 1, 1, 1,
+                                                      1, 1, 1, 1, 1, 2, 1};
+
+/// Offset of the first rule of each rank into rules.
+inline constexpr std::array<size_t, 14> ruleOffsets = [] {
+  std::array<size_t, 14> offsets{};
+  size_t offset = 0;
+  for (size_t i = 0; i < ruleCounts.size(); ++i) {
+    offsets[i] = offset;
+    offset += ruleCounts[i];
+  }
+  return offsets;
+}();
+
+static_assert(ruleOffsets.back() + ruleCounts.back() == rules.size(),
+              "Rule counts do not match the rule table");
+
+/**
+ * @brief Get the move rules of a rank.
+ * @param rank Rank of the card.
+ * @return View into the static rule table.
+ */
+constexpr std::span<const MoveRule> forRank(Rank rank) {
+  size_t r = static_cast<size_t>(rank);
+  return {rules.data() + ruleOffsets[r], ruleCounts[r]};
+}
+
+}  // namespace CardRules
+
 /**
  * @brief Card objects.
+ * @note Trivially copyable, the move rules live in CardRules.
  */
 class Card {
  private:
   Rank rank;  ///< Rank of the card.
   Suit suit;  ///< Suit of the card.
-  std::vector<std::pair<MoveType, int>>
-      moveRules;  ///< Move rules associated with the card.
 
  public:
   // Constructors and Methods
@@ -35,7 +97,7 @@ class Card {
    * @brief Constructor for Card initializing rank and suit.
    * @param r Rank of the card.
    * @param s Suit of the card.
-   * @note Move rules are set based on rank and suit.
+   * @throws std::invalid_argument if the rank is invalid.
    */
   Card(Rank r, Suit s);
 
@@ -52,9 +114,11 @@ class Card {
   Suit getSuit() const;
   /**
    * @brief Get the move rules associated with the card.
-   * @return Vector of move type and value pairs.
+   * @return View of move type and value pairs in static storage.
    */
-  const std::vector<std::pair<MoveType, int>>& getMoveRules() const;
+  std::span<const MoveRule> getMoveRules() const {
+    return CardRules::forRank(rank);
+  }
 
   // Operator Overloads (Needed for testing)
   /**
@@ -87,6 +151,9 @@ class Card {
   friend void from_json(const nlohmann::json& j, Card& card);
 };
 
+static_assert(std::is_trivially_copyable_v<Card>,
+              "Card must stay a plain (rank, suit) pair");
+
 /**
  * @brief Inline Serialization of Card to JSON.
  * @param j Reference to a JSON object.
@@ -95,29 +162,17 @@ class Card {
 inline void to_json(nlohmann::json& j, const Card& card) {
   j["rank"] = static_cast<int>(card.getRank());
   j["suit"] = static_cast<int>(card.getSuit());
-  j["moveRules"] = nlohmann::json::array();
-  for (const auto& rule : card.getMoveRules()) {
-    nlohmann::json ruleJson;
-    ruleJson["type"] = static_cast<int>(rule.first);
-    ruleJson["value"] = rule.second;
-    j["moveRules"].push_back(ruleJson);
-  }
 };
 
 /**
  * @brief Inline Deserialization of Card from JSON.
  * @param j Constant reference to a JSON object.
  * @param card Reference to a Card instance.
+ * @note Move rules follow from the rank, a legacy "moveRules" field is ignored.
  */
 inline void from_json(const nlohmann::json& j, Card& card) {
-  card.rank = static_cast<Rank>(j.at("rank").get<int>());
-  card.suit = static_cast<Suit>(j.at("suit").get<int>());
-  card.moveRules.clear();
-  for (const auto& ruleJson : j.at("moveRules")) {
-    card.moveRules.emplace_back(
-        static_cast<MoveType>(ruleJson.at("type").get<int>()),
-        ruleJson.at("value").get<int>());
-  };
+  card = Card(static_cast<Rank>(j.at("rank").get<int>()),
+              static_cast<Suit>(j.at("suit").get<int>()));
 };
 
 /**
@@ -243,6 +298,11 @@ class Player {
    * @param cardIds Vector of card IDs to set as the player's hand.
    */
   void setHand(const std::vector<size_t>& cardIds);
+  /**
+   * @brief Restore the player's hand, reusing the existing hand storage.
+   * @param cardIds Card IDs to set as the player's hand.
+   */
+  void restoreHand(std::span<const size_t> cardIds);
   /**
    * @brief Set the start blocked status of the player.
    * @param blocked Optional index of blocked marble at start.
@@ -291,6 +351,12 @@ class Player {
    * @param player Reference to a Player instance.
    */
   friend void from_json(const nlohmann::json& j, Player& player);
+  /**
+   * @brief Friend declaration for binary deserialization (wire_format.hpp).
+   * @param reader Reader positioned at the player.
+   * @param player Reference to a Player instance.
+   */
+  friend void readBinary(BinaryReader& reader, Player& player);
 };
 
 /**
@@ -0,0 +1,395 @@
+#include "shared/ismcts.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include "shared/logging.hpp"
+#include "shared/zobrist.hpp"
+
+namespace BraendiDog {
+
+namespace {
+constexpr size_t deckSize = 54;
+constexpr double progressSlots = 69.0;  ///< Home + 64 track + 4 finish.
+const std::vector<Move> foldOnly(1);   ///< Plays without a legal move.
+
+// Edge identity shared by all determinizations: card rank and marble outcome,
+// not card ID or hand slot which depend on the sampled hands
+uint64_t edgeKey(const GameState& state, const Move& move) {
+  if (move.getMovements().empty()) {
+    return 0;  // Fold
+  }
+  uint64_t seed =
+      static_cast<uint64_t>(state.getDeck()[move.getCardID()].getRank()) + 1;
+  uint64_t key = Zobrist::splitmix64(seed);
+  for (const auto& [marble, pos] : move.getMovements()) {
+    uint64_t code = static_cast<uint64_t>(marble.playerID) << 48 |
+                    static_cast<uint64_t>(marble.marbleIdx) << 40 |
+                    static_cast<uint64_t>(pos.boardLocation) << 32 |
+                    static_cast<uint64_t>(pos.playerID) << 16 | pos.index;
+    key ^= Zobrist::splitmix64(code);
+  }
+  return key;
+}
+
+// Progress of a player's marbles in [0, 1)
+double marbleProgress(const Player& player) {
+  double progress = 0.0;
+  for (const Position& pos : player.getMarbles()) {
+    if (pos.boardLocation == BoardLocation::TRACK) {
+      size_t steps = (pos.index + 64 - player.getStartField()) % 64;
+      progress += (1 + steps) / progressSlots;
+    } else if (pos.boardLocation == BoardLocation::FINISH) {
+      progress += (65 + pos.index) / progressSlots;
+    }
+  }
+  return progress / 4;
+}
+
+// Play a move (fold if empty) and advance the turn, dealing a new round like
+// the server does. Returns true if the game ended.
+bool playTurn(GameState& state, const Move& move, Xoshiro256& rng) {
+  if (move.getMovements().empty()) {
+    state.executeFold();
+  } else {
+    state.executeMove(move);
+  }
+  auto [gameEnded, roundEnded] = state.endTurn();
+  if (!gameEnded && roundEnded) {
+    for (const auto& [id, hand] : state.dealCards(rng)) {
+      state.setHand(id, hand);
+    }
+  }
+  return gameEnded;
+}
+
+/**
+ * @brief Node of the search tree, reached by one edge key.
+ */
+struct Node {
+  uint64_t key = 0;       ///< Edge key of the move leading here.
+  size_t player = 0;      ///< Player who made that move.
+  uint32_t visits = 0;    ///< Iterations through this node.
+  uint32_t available = 0;  ///< Iterations in which the move was legal.
+  double reward = 0.0;    ///< Sum of rewards for player.
+  std::vector<std::unique_ptr<Node>> children;
+
+  Node* child(uint64_t childKey) const {
+    for (const auto& node : children) {
+      if (node->key == childKey) {
+        return node.get();
+      }
+    }
+    return nullptr;
+  }
+
+  Node* addChild(uint64_t childKey, size_t mover) {
+    children.push_back(std::make_unique<Node>());
+    children.back()->key = childKey;
+    children.back()->player = mover;
+    return children.back().get();
+  }
+};
+
+/**
+ * @brief Single threaded ISMCTS worker growing one tree.
+ */
+class Searcher {
+ public:
+  Searcher(const GameState& root, std::span<const size_t> seenCards,
+           const IsmctsConfig& config, TranspositionTable& moveCache,
+           uint64_t seed)
+      : root(root),
+        seenCards(seenCards),
+        config(config),
+        moveCache(moveCache),
+        rng(seed),
+        observer(root.getCurrentPlayer()) {}
+
+  // One determinize, select, expand, rollout and backpropagate pass
+  void iterate() {
+    GameState state = determinize(root, observer, seenCards, rng);
+    path.assign(1, &tree);
+    Node* node = &tree;
+    bool gameEnded = false;
+    bool expanded = false;
+
+    // Selection and expansion
+    while (!gameEnded && !expanded) {
+      // Tree positions recur across iterations: the root always, deeper ones
+      // whenever the mover's sampled hand does
+      std::shared_ptr<const std::vector<Move>> legal =
+          moveCache.allLegalMoves(state);
+      const std::vector<Move>& moves = legal->empty() ? foldOnly : *legal;
+      size_t mover = state.getCurrentPlayer();
+
+      // Distinct edges of this determinization
+      edges.clear();
+      untried.clear();
+      for (size_t i = 0; i < moves.size(); ++i) {
+        uint64_t key = edgeKey(state, moves[i]);
+        if (std::any_of(edges.begin(), edges.end(),
+                        [key](const auto& edge) { return edge.first == key; })) {
+          continue;
+        }
+        Node* child = node->child(key);
+        edges.emplace_back(key, i);
+        if (child == nullptr) {
+          untried.push_back(edges.size() - 1);
+        } else {
+          ++child->available;
+        }
+      }
+
+      size_t choice;
+      Node* next;
+      if (!untried.empty()) {
+        size_t edge = untried[rng.below(untried.size())];
+        choice = edges[edge].second;
+        next = node->addChild(edges[edge].first, mover);
+        expanded = true;
+      } else {
+        // UCB over the available children
+        double best = -std::numeric_limits<double>::infinity();
+        choice = 0;
+        next = nullptr;
+        for (const auto& [key, index] : edges) {
+          Node* child = node->child(key);
+          double score =
+              child->reward / child->visits +
+              config.exploration *
+                  std::sqrt(std::log(static_cast<double>(child->available)) /
+                            child->visits);
+          if (score > best) {
+            best = score;
+            choice = index;
+            next = child;
+          }
+        }
+      }
+
+      gameEnded = playTurn(state, moves[choice], rng);
+      node = next;
+      path.push_back(node);
+    }
+
+    // Random rollout, its positions are rarely revisited and not cached
+    for (size_t turn = 0; !gameEnded && turn < config.rolloutTurns; ++turn) {
+      rolloutMoves = state.computeAllLegalMoves();
+      gameEnded = playTurn(state,
+                           rolloutMoves.empty()
+                               ? Move()
+                               : rolloutMoves[rng.below(rolloutMoves.size())],
+                           rng);
+    }
+
+    // Backpropagation
+    std::array<double, 4> rewards = evaluateState(state);
+    for (Node* visited : path) {
+      ++visited->visits;
+      if (visited != &tree) {
+        visited->reward += rewards[visited->player];
+      }
+    }
+  }
+
+  const Node& getTree() const { return tree; }
+
+ private:
+  const GameState& root;
+  std::span<const size_t> seenCards;
+  const IsmctsConfig& config;
+  TranspositionTable& moveCache;
+  Xoshiro256 rng;
+  size_t observer;
+  Node tree;
+
+  // Scratch buffers reused across iterations
+  std::vector<Node*> path;
+  std::vector<Move> rolloutMoves;
+  std::vector<std::pair<uint64_t, size_t>> edges;  ///< Edge key, move index.
+  std::vector<size_t> untried;                     ///< Indices into edges.
+};
+}  // namespace
+
+// Sample opponent hands
+GameState determinize(const GameState& state, size_t observer,
+                      std::span<const size_t> seenCards, Xoshiro256& rng) {
+  GameState sample = state;
+
+  // Cards the observer knows are not in an opponent's hand
+  std::array<bool, deckSize> known{};
+  for (size_t cardID : state.getPlayerByIndex(observer)->getHand()) {
+    known.at(cardID) = true;
+  }
+  for (size_t cardID : seenCards) {
+    known.at(cardID) = true;
+  }
+  if (state.getLastPlayedCard().has_value()) {
+    known.at(state.getLastPlayedCard().value()) = true;
+  }
+
+  std::vector<size_t> pool;
+  pool.reserve(deckSize);
+  for (size_t cardID = 0; cardID < deckSize; ++cardID) {
+    if (!known[cardID]) {
+      pool.push_back(cardID);
+    }
+  }
+
+  // Deal the unknown cards by the known hand sizes (partial Fisher-Yates)
+  size_t next = 0;
+  for (size_t pID = 0; pID < 4; ++pID) {
+    const auto& player = state.getPlayerByIndex(pID);
+    if (pID == observer || !player.has_value() || player->isHandEmpty()) {
+      continue;
+    }
+    size_t count = player->getHand().size();
+    if (next + count > pool.size()) {
+      throw std::invalid_argument("Not enough unknown cards to determinize");
+    }
+    for (size_t i = next; i < next + count; ++i) {
+      std::swap(pool[i], pool[i + rng.below(pool.size() - i)]);
+    }
+    sample.setHand(pID, std::vector<size_t>(pool.begin() + next,
+                                            pool.begin() + next + count));
+    next += count;
+  }
+
+  // Future deals are unknown as well
+  sample.reseed(rng());
+  return sample;
+}
+
+// Evaluate state per player
+std::array<double, 4> evaluateState(const GameState& state) {
+  std::array<double, 4> rewards{};
+  std::array<double, 4> progress{};
+  double totalProgress = 0.0;
+  size_t present = 0;
+  for (size_t pID = 0; pID < 4; ++pID) {
+    const auto& player = state.getPlayerByIndex(pID);
+    if (player.has_value()) {
+      ++present;
+      progress[pID] = marbleProgress(player.value());
+      totalProgress += progress[pID];
+    }
+  }
+
+  for (size_t pID = 0; pID < 4; ++pID) {
+    if (!state.getPlayerByIndex(pID).has_value()) {
+      continue;
+    }
+    const std::optional<int>& rank = state.getLeaderBoard()[pID];
+    if (rank.has_value()) {
+      // Finished by rank, unfinished (0) and disconnected (-1) lose
+      rewards[pID] = rank.value() > 0 && present > 1
+                         ? (static_cast<double>(present) - rank.value()) /
+                               (present - 1)
+                         : 0.0;
+    } else {
+      double others =
+          present > 1 ? (totalProgress - progress[pID]) / (present - 1) : 0.0;
+      rewards[pID] = std::clamp(0.5 + 0.5 * (progress[pID] - others), 0.0, 1.0);
+    }
+  }
+  return rewards;
+}
+
+// Constructor
+Ismcts::Ismcts(IsmctsConfig config)
+    : config(config),
+      moveCache(std::make_shared<TranspositionTable>(config.cacheMemory)) {
+  if (config.iterations == 0 && config.timeBudget.count() <= 0) {
+    throw std::invalid_argument("ISMCTS needs an iteration or time budget");
+  }
+}
+
+// Get configuration
+const IsmctsConfig& Ismcts::getConfig() const { return config; }
+
+// Search
+IsmctsResult Ismcts::search(const GameState& state,
+                            std::span<const size_t> seenCards) const {
+  IsmctsResult result;
+  std::shared_ptr<const std::vector<Move>> rootLegal =
+      moveCache->allLegalMoves(state);
+  const std::vector<Move>& rootMoves = *rootLegal;
+  if (rootMoves.empty()) {
+    return result;  // Fold
+  }
+  if (rootMoves.size() == 1) {
+    result.move = rootMoves.front();  // Nothing to decide
+    return result;
+  }
+
+  size_t threadCount = config.threads > 0
+                           ? config.threads
+                           : std::max(1u, std::thread::hardware_concurrency());
+  auto deadline = std::chrono::steady_clock::now() + config.timeBudget;
+  std::atomic<size_t> started{0};
+
+  // Root parallelism: independent trees, merged at the root (no virtual loss
+  // needed, nothing below the root is shared)
+  std::vector<std::unique_ptr<Searcher>> searchers;
+  uint64_t seedState = config.seed;
+  for (size_t t = 0; t < threadCount; ++t) {
+    searchers.push_back(std::make_unique<Searcher>(
+        state, seenCards, config, *moveCache, Zobrist::splitmix64(seedState)));
+  }
+  auto work = [&](Searcher& searcher) {
+    while (config.iterations == 0 || started++ < config.iterations) {
+      if (config.timeBudget.count() > 0 &&
+          std::chrono::steady_clock::now() >= deadline) {
+        break;
+      }
+      searcher.iterate();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t t = 1; t < threadCount; ++t) {
+    threads.emplace_back(work, std::ref(*searchers[t]));
+  }
+  work(*searchers[0]);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Merge root statistics
+  std::unordered_map<uint64_t, std::pair<size_t, double>> stats;
+  for (const auto& searcher : searchers) {
+    result.iterations += searcher->getTree().visits;
+    for (const auto& child : searcher->getTree().children) {
+      auto& [visits, reward] = stats[child->key];
+      visits += child->visits;
+      reward += child->reward;
+    }
+  }
+
+  // Most visited root move
+  result.move = rootMoves.front();
+  for (const Move& move : rootMoves) {
+    auto it = stats.find(edgeKey(state, move));
+    if (it != stats.end() && it->second.first > result.visits) {
+      result.move = move;
+      result.visits = it->second.first;
+      result.value = it->second.second / it->second.first;
+    }
+  }
+
+  BD_LOG_DEBUG("ISMCTS", "Player " << state.getCurrentPlayer() << " searched "
+                                   << result.iterations << " iterations on "
+                                   << threadCount << " threads, best move "
+                                   << result.visits << " visits, value "
+                                   << result.value);
+  return result;
+}
+
+}  // namespace BraendiDog
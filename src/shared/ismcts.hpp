@@ -0,0 +1,112 @@
+/**
+ * @file ismcts.hpp
+ * @brief Information set Monte Carlo tree search (ISMCTS) move selection.
+ *
+ * The searcher only uses what the current player can know: its own hand, the
+ * cards seen this round and the hand sizes of the opponents. Every iteration
+ * samples the hidden hands anew (determinization) and walks one shared tree
+ * whose edges are identified by card rank and marble outcome.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "shared/game.hpp"
+#include "shared/rng.hpp"
+#include "shared/transposition_table.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief Search budget and tuning of the ISMCTS player.
+ * @note The search stops at whichever of the two budgets runs out first, at
+ * least one of them has to be set.
+ */
+struct IsmctsConfig {
+  size_t iterations = 0;  ///< Total iterations over all threads, 0 = unlimited.
+  std::chrono::milliseconds timeBudget{200};  ///< Per move, 0 = unlimited.
+  size_t threads = 0;          ///< Search threads, 0 = hardware concurrency.
+  double exploration = 0.7;    ///< UCB exploration constant.
+  size_t rolloutTurns = 24;    ///< Random turns played after expansion.
+  uint64_t seed = 0;           ///< Seed of the search (determinizations).
+  size_t cacheMemory = TranspositionTable::defaultMemory;  ///< Move cache.
+};
+
+/**
+ * @brief Outcome of one search.
+ */
+struct IsmctsResult {
+  Move move;              ///< Chosen move (no movements for a fold).
+  size_t iterations = 0;  ///< Iterations run over all threads.
+  size_t visits = 0;      ///< Root visits of the chosen move.
+  double value = 0.0;     ///< Mean reward of the chosen move in [0, 1].
+};
+
+/**
+ * @brief Sample the hidden hands of the opponents of a player.
+ * @param state State as seen by the observer.
+ * @param observer ID of the player whose hand is known.
+ * @param seenCards Card IDs known to be out of play (e.g. played this round).
+ * @param rng Random generator used for sampling.
+ * @return Copy of state with the opponents' hands replaced by a sample that
+ * keeps every hand size and avoids all known cards.
+ * @throws std::invalid_argument if too few unknown cards remain.
+ */
+GameState determinize(const GameState& state, size_t observer,
+                      std::span<const size_t> seenCards, Xoshiro256& rng);
+
+/**
+ * @brief Evaluate a state for every player.
+ * @param state State to evaluate.
+ * @return Reward in [0, 1] per player slot, finished players by rank and the
+ * others by marble progress relative to the field.
+ */
+std::array<double, 4> evaluateState(const GameState& state);
+
+/**
+ * @brief ISMCTS player using root parallelism over all cores.
+ *
+ * Root parallelism is chosen over a shared tree with virtual loss: every
+ * iteration already samples its own determinization, so independent trees
+ * explore different hands without a penalty to spread the threads, and
+ * selection never waits on a lock. Only the legal move cache is shared. The
+ * cost is that nodes below the root only see one thread's iterations, while
+ * the move choice depends on the merged root statistics alone.
+ */
+class Ismcts {
+ public:
+  /**
+   * @brief Constructor.
+   * @param config Search budget and tuning.
+   */
+  explicit Ismcts(IsmctsConfig config = IsmctsConfig());
+
+  /**
+   * @brief Pick a move for the current player.
+   * @param state Current state, only the current player's hand is trusted.
+   * @param seenCards Card IDs already played this round.
+   * @return Chosen move and search statistics.
+   * @note Each thread grows its own tree, the root statistics are merged.
+   */
+  IsmctsResult search(const GameState& state,
+                      std::span<const size_t> seenCards = {}) const;
+
+  /**
+   * @brief Get the configuration.
+   */
+  const IsmctsConfig& getConfig() const;
+
+ private:
+  IsmctsConfig config;  ///< Search budget and tuning.
+  std::shared_ptr<TranspositionTable>
+      moveCache;  ///< Legal moves of tree positions, kept across searches.
+};
+
+}  // namespace BraendiDog
@@ -0,0 +1,552 @@
+#include "shared/logging.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace BraendiDog {
+namespace Log {
+
+namespace {
+// Initial level from the environment, INFO otherwise
+int initialLevel() {
+  const char* env = std::getenv("BRAENDI_LOG_LEVEL");
+  if (env != nullptr) {
+    if (auto level = parseLevel(env)) {
+      return static_cast<int>(level.value());
+    }
+  }
+  return static_cast<int>(Level::INFO);
+}
+
+const char* levelName(Level level) {
+  switch (level) {
+    case Level::TRACE:
+      return "TRACE";
+    case Level::DEBUG:
+      return "DEBUG";
+    case Level::INFO:
+      return "INFO";
+    case Level::WARN:
+      return "WARN";
+    case Level::ERR:
+      return "ERROR";
+    default:
+      return "OFF";
+  }
+}
+
+// Magic at the start of a binary log, followed by the records
+constexpr std::string_view binaryMagic = "BDLOG1\n";
+
+void putU32(std::string& out, uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out.push_back(static_cast<char>(value >> shift));
+  }
+}
+
+void putU64(std::string& out, uint64_t value) {
+  for (int shift = 0; shift < 64; shift += 8) {
+    out.push_back(static_cast<char>(value >> shift));
+  }
+}
+
+// Reads little-endian fields of a binary log
+class RecordReader {
+ public:
+  explicit RecordReader(std::string_view in) : in_(in) {}
+
+  bool done() const { return pos_ == in_.size(); }
+
+  uint64_t uint(size_t bytes) {
+    need(bytes);
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+      value |= static_cast<uint64_t>(static_cast<unsigned char>(in_[pos_++]))
+               << (8 * i);
+    }
+    return value;
+  }
+
+  std::string string(size_t sizeBytes) {
+    const size_t size = static_cast<size_t>(uint(sizeBytes));
+    need(size);
+    std::string value(in_.substr(pos_, size));
+    pos_ += size;
+    return value;
+  }
+
+ private:
+  std::string_view in_;
+  size_t pos_ = 0;
+
+  void need(size_t bytes) const {
+    if (in_.size() - pos_ < bytes) {
+      throw std::runtime_error("Truncated log record");
+    }
+  }
+};
+
+// Tag of the lines logged by this thread
+thread_local Tag* currentTag = nullptr;
+// Lines dropped by rate limits or a full ring
+std::atomic<size_t> droppedCount{0};
+
+int64_t currentSecond(std::chrono::system_clock::time_point time) {
+  return std::chrono::duration_cast<std::chrono::seconds>(
+             time.time_since_epoch())
+      .count();
+}
+
+/**
+ * Bounded multi-producer, single-consumer queue of records. Producers claim a
+ * slot by advancing head_ and publish it through the slot's sequence number,
+ * so neither side ever waits for the other; a full ring refuses the record.
+ */
+class RecordRing {
+ public:
+  explicit RecordRing(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    slots_ = std::make_unique<Slot[]>(size);
+    mask_ = size - 1;
+    for (size_t i = 0; i < size; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+  // Approximate number of queued records
+  size_t size() const {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    return head_.load(std::memory_order_relaxed) - tail;
+  }
+
+  bool push(Record& record) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Slot& slot = slots_[pos & mask_];
+      const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          slot.record = std::move(record);
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;  // The consumer has not freed the slot yet
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Consumer only
+  bool pop(Record& record) {
+    const size_t pos = tail_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[pos & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+      return false;
+    }
+    record = std::move(slot.record);
+    slot.sequence.store(pos + mask_ + 1, std::memory_order_release);
+    tail_.store(pos + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<size_t> sequence{0};
+    Record record;
+  };
+
+  std::unique_ptr<Slot[]> slots_;
+  size_t mask_ = 0;
+  alignas(64) std::atomic<size_t> head_{0};  ///< Next slot to claim.
+  alignas(64) std::atomic<size_t> tail_{0};  ///< Next slot to consume.
+};
+
+/**
+ * Ring buffer and the thread writing it to the sink.
+ */
+class AsyncWriter {
+ public:
+  explicit AsyncWriter(const AsyncOptions& options)
+      : options_(options), ring_(options.capacity) {
+    if (!options_.path.empty()) {
+      file_ = std::fopen(options_.path.c_str(),
+                         options_.format == Format::BINARY ? "ab" : "a");
+      if (file_ == nullptr) {
+        throw std::runtime_error("Cannot open log file " + options_.path +
+                                 ": " + std::strerror(errno));
+      }
+    }
+    if (options_.format == Format::BINARY && file_ != nullptr &&
+        std::fseek(file_, 0, SEEK_END) == 0 && std::ftell(file_) == 0) {
+      std::fwrite(binaryMagic.data(), 1, binaryMagic.size(), file_);
+    }
+    thread_ = std::thread(&AsyncWriter::run, this);
+  }
+
+  ~AsyncWriter() { stop(); }
+
+  AsyncWriter(const AsyncWriter&) = delete;
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+  size_t getLimit() const { return options_.linesPerSecond; }
+
+  void push(Record& record) {
+    // Either stop() waits for this push and writes the line, or the push
+    // sees the writer closed and counts the line as dropped
+    pushers_.fetch_add(1);
+    if (closed_.load()) {
+      pushers_.fetch_sub(1);
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    const bool error = record.level >= Level::ERR;
+    const bool queued = ring_.push(record);
+    pushers_.fetch_sub(1);
+    if (!queued) {
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Otherwise the writer picks the line up on its next tick
+    if (!queued || error || ring_.size() >= ring_.capacity() / 2) {
+      wake_.notify_one();
+    }
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopping_) {
+        return;
+      }
+      stopping_ = true;
+    }
+    wake_.notify_one();
+    thread_.join();
+
+    // Producers that loaded this writer before it was replaced may still
+    // push, write what they queued on this thread
+    closed_.store(true);
+    while (pushers_.load() != 0) {
+      std::this_thread::yield();
+    }
+    std::string batch;
+    Record record;
+    while (ring_.pop(record)) {
+      append(batch, record);
+    }
+    flush(batch);
+    if (file_ != nullptr) {
+      std::fclose(file_);
+      file_ = nullptr;
+    }
+  }
+
+ private:
+  /// Longest time a line waits in the ring
+  static constexpr std::chrono::milliseconds tick{20};
+  /// Bytes collected before they are written
+  static constexpr size_t batchBytes = 64 * 1024;
+
+  AsyncOptions options_;
+  RecordRing ring_;
+  std::FILE* file_ = nullptr;  ///< Null for stderr.
+  std::mutex mutex_;  ///< Protects stopping_, guards the wait.
+  std::condition_variable wake_;
+  bool stopping_ = false;
+  std::thread thread_;
+  std::atomic<bool> closed_{false};  ///< Set once stop() drains the ring.
+  std::atomic<size_t> pushers_{0};   ///< Producers inside push().
+
+  void run() {
+    std::string batch;
+    size_t reported = droppedLines();
+    auto lastReport = std::chrono::steady_clock::now();
+    Record record;
+    for (;;) {
+      while (ring_.pop(record)) {
+        append(batch, record);
+        if (batch.size() >= batchBytes) {
+          flush(batch);
+        }
+      }
+
+      // Dropped lines are summed up, at most once per second
+      const auto now = std::chrono::steady_clock::now();
+      const size_t dropped = droppedLines();
+      if (dropped != reported && now - lastReport >= std::chrono::seconds(1)) {
+        Record warning{std::chrono::system_clock::now(), Level::WARN, "Log",
+                       "",
+                       "Dropped " + std::to_string(dropped - reported) +
+                           " lines over rate limits or a full buffer"};
+        append(batch, warning);
+        reported = dropped;
+        lastReport = now;
+      }
+      flush(batch);
+
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (stopping_ && ring_.size() == 0) {
+        return;
+      }
+      wake_.wait_for(lock, tick);
+    }
+  }
+
+  void append(std::string& batch, const Record& record) const {
+    if (options_.format == Format::BINARY) {
+      writeBinary(batch, record);
+    } else {
+      batch += formatText(record);
+      batch += '\n';
+    }
+  }
+
+  void flush(std::string& batch) {
+    if (batch.empty()) {
+      return;
+    }
+    if (file_ != nullptr) {
+      std::fwrite(batch.data(), 1, batch.size(), file_);
+      std::fflush(file_);
+    } else {
+      std::clog.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+      std::clog.flush();
+    }
+    batch.clear();
+  }
+};
+
+// Writer of the running asynchronous log, null while lines are written
+// synchronously
+std::atomic<AsyncWriter*> asyncWriter{nullptr};
+// Budget of untagged lines
+RateLimit untaggedLimit;
+
+std::mutex writersMutex;
+// Stopped writers stay alive, a producer may still hold a pointer
+std::vector<std::unique_ptr<AsyncWriter>>& writers() {
+  static std::vector<std::unique_ptr<AsyncWriter>> all;
+  return all;
+}
+}  // namespace
+
+// Runtime level
+std::atomic<int>& runtimeLevel() {
+  static std::atomic<int> level{initialLevel()};
+  return level;
+}
+
+// Parse level name
+std::optional<Level> parseLevel(std::string_view name) {
+  std::string upper(name);
+  std::transform(upper.begin(), upper.end(), upper.begin(),
+                 [](unsigned char c) { return std::toupper(c); });
+  for (Level level : {Level::TRACE, Level::DEBUG, Level::INFO, Level::WARN,
+                      Level::ERR, Level::OFF}) {
+    if (upper == levelName(level)) {
+      return level;
+    }
+  }
+  return std::nullopt;
+}
+
+bool RateLimit::admit(size_t limit) {
+  if (limit == 0) {
+    return true;
+  }
+  const int64_t second = currentSecond(std::chrono::system_clock::now());
+  int64_t current = second_.load(std::memory_order_relaxed);
+  if (current != second &&
+      second_.compare_exchange_strong(current, second,
+                                      std::memory_order_relaxed)) {
+    count_.store(0, std::memory_order_relaxed);
+  }
+  return count_.fetch_add(1, std::memory_order_relaxed) < limit;
+}
+
+// Constructor
+Tag::Tag(std::string name, size_t linesPerSecond)
+    : name_(std::move(name)), limit_(linesPerSecond) {}
+
+const std::string& Tag::getName() const { return name_; }
+
+size_t Tag::getLimit() const { return limit_; }
+
+RateLimit& Tag::getRateLimit() { return rateLimit_; }
+
+// Constructor
+ScopedTag::ScopedTag(Tag& tag) : previous_(currentTag) { currentTag = &tag; }
+
+// Destructor
+ScopedTag::~ScopedTag() { currentTag = previous_; }
+
+AsyncOptions AsyncOptions::fromEnvironment() {
+  AsyncOptions options;
+  if (const char* path = std::getenv("BRAENDI_LOG_FILE")) {
+    options.path = path;
+  }
+  if (const char* format = std::getenv("BRAENDI_LOG_FORMAT")) {
+    if (std::string_view(format) == "binary") {
+      options.format = Format::BINARY;
+    }
+  }
+  if (const char* rate = std::getenv("BRAENDI_LOG_RATE")) {
+    options.linesPerSecond = std::strtoul(rate, nullptr, 10);
+  }
+  return options;
+}
+
+void startAsync(const AsyncOptions& options) {
+  std::lock_guard<std::mutex> lock(writersMutex);
+  auto writer = std::make_unique<AsyncWriter>(options);
+  AsyncWriter* previous = asyncWriter.exchange(writer.get());
+  writers().push_back(std::move(writer));
+  if (previous != nullptr) {
+    previous->stop();
+  }
+}
+
+void stopAsync() {
+  std::lock_guard<std::mutex> lock(writersMutex);
+  if (AsyncWriter* writer = asyncWriter.exchange(nullptr)) {
+    writer->stop();
+  }
+}
+
+size_t droppedLines() {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+std::string formatText(const Record& record) {
+  const auto sinceEpoch = record.time.time_since_epoch();
+  const std::time_t seconds = static_cast<std::time_t>(
+      std::chrono::duration_cast<std::chrono::seconds>(sinceEpoch).count());
+  const auto millis =
+      std::chrono::duration_cast<std::chrono::milliseconds>(sinceEpoch)
+          .count() %
+      1000;
+  std::tm utc{};
+#ifdef _WIN32
+  gmtime_s(&utc, &seconds);
+#else
+  gmtime_r(&seconds, &utc);
+#endif
+  char time[32];
+  const size_t length = std::strftime(time, sizeof(time), "%FT%T", &utc);
+  std::snprintf(time + length, sizeof(time) - length, ".%03dZ",
+                static_cast<int>(millis));
+
+  std::string line = time;
+  line += " [";
+  line += levelName(record.level);
+  line += "][";
+  line += record.component;
+  line += ']';
+  if (!record.tag.empty()) {
+    line += '[';
+    line += record.tag;
+    line += ']';
+  }
+  line += ' ';
+  line += record.message;
+  return line;
+}
+
+void writeBinary(std::string& out, const Record& record) {
+  const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      record.time.time_since_epoch());
+  const std::string_view component =
+      std::string_view(record.component).substr(0, 0xff);
+  const std::string_view tag = std::string_view(record.tag).substr(0, 0xff);
+
+  putU64(out, static_cast<uint64_t>(nanos.count()));
+  out.push_back(static_cast<char>(record.level));
+  out.push_back(static_cast<char>(component.size()));
+  out.append(component);
+  out.push_back(static_cast<char>(tag.size()));
+  out.append(tag);
+  putU32(out, static_cast<uint32_t>(record.message.size()));
+  out.append(record.message);
+}
+
+std::vector<Record> readBinary(std::string_view data) {
+  if (data.substr(0, binaryMagic.size()) != binaryMagic) {
+    throw std::runtime_error("Not a binary log");
+  }
+  RecordReader reader(data.substr(binaryMagic.size()));
+  std::vector<Record> records;
+  while (!reader.done()) {
+    Record record;
+    record.time = std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(static_cast<int64_t>(reader.uint(8)))));
+    const uint64_t level = reader.uint(1);
+    if (level > static_cast<uint64_t>(Level::OFF)) {
+      throw std::runtime_error("Invalid log level " + std::to_string(level));
+    }
+    record.level = static_cast<Level>(level);
+    record.component = reader.string(1);
+    record.tag = reader.string(1);
+    record.message = reader.string(4);
+    records.push_back(std::move(record));
+  }
+  return records;
+}
+
+// Write log line: queued if the asynchronous log runs, otherwise written to
+// stderr right away (flushed only for errors)
+void write(Level level, std::string_view component, std::string message) {
+  AsyncWriter* writer = asyncWriter.load(std::memory_order_acquire);
+  if (level < Level::ERR) {
+    const size_t limit = writer != nullptr ? writer->getLimit() : 0;
+    const bool admitted =
+        currentTag != nullptr
+            ? currentTag->getRateLimit().admit(
+                  currentTag->getLimit() != 0 ? currentTag->getLimit() : limit)
+            : untaggedLimit.admit(limit);
+    if (!admitted) {
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+
+  Record record{std::chrono::system_clock::now(), level,
+                std::string(component),
+                currentTag != nullptr ? currentTag->getName() : std::string(),
+                std::move(message)};
+  if (writer != nullptr) {
+    writer->push(record);
+    return;
+  }
+
+  static std::mutex writeMutex;
+  const std::string line = formatText(record);
+  std::lock_guard<std::mutex> lock(writeMutex);
+  std::clog << line << '\n';
+  if (level >= Level::ERR) {
+    std::clog.flush();
+  }
+}
+
+}  // namespace Log
+}  // namespace BraendiDog
@@ -0,0 +1,242 @@
+/**
+ * @file logging.hpp
+ * @brief Level gated logging for engine, server and client.
+ *
+ * Log statements below BRAENDI_LOG_MIN_LEVEL are compiled out, statements
+ * below the runtime level cost a single atomic load. Stream arguments are only
+ * formatted if the statement is enabled.
+ *
+ * Lines are written to stderr on the calling thread until startAsync() is
+ * called (the server does at startup). From then on a line is only queued in
+ * a lock-free ring buffer and a background thread writes it to the sink, so
+ * logging never blocks the game or IO threads; lines that find the buffer
+ * full or exceed a rate limit are dropped and counted instead.
+ *
+ * Usage: BD_LOG_DEBUG("Engine", "Computed " << moves.size() << " moves");
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Lowest level compiled in (0 = TRACE ... 5 = OFF).
+#ifndef BRAENDI_LOG_MIN_LEVEL
+#define BRAENDI_LOG_MIN_LEVEL 0
+#endif
+
+namespace BraendiDog {
+namespace Log {
+
+/**
+ * @brief Log severity levels.
+ */
+enum class Level : int {
+  TRACE = 0,  ///< Per move / per message details
+  DEBUG = 1,  ///< Developer diagnostics
+  INFO = 2,   ///< Operational messages (default)
+  WARN = 3,   ///< Unexpected but recoverable situations
+  ERR = 4,    ///< Failures (not ERROR, clashes with a Windows macro)
+  OFF = 5     ///< Logging disabled
+};
+
+/**
+ * @brief Runtime level storage, initialised from BRAENDI_LOG_LEVEL.
+ */
+std::atomic<int>& runtimeLevel();
+
+/**
+ * @brief Set the runtime log level.
+ */
+inline void setLevel(Level level) {
+  runtimeLevel().store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Get the runtime log level.
+ */
+inline Level getLevel() {
+  return static_cast<Level>(runtimeLevel().load(std::memory_order_relaxed));
+}
+
+/**
+ * @brief Check if a level is compiled in and enabled at runtime.
+ */
+inline bool enabled(Level level) {
+  return static_cast<int>(level) >= BRAENDI_LOG_MIN_LEVEL &&
+         static_cast<int>(level) >=
+             runtimeLevel().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Parse a level name (e.g. "debug", "WARN").
+ * @return Parsed level, nullopt for unknown names.
+ */
+std::optional<Level> parseLevel(std::string_view name);
+
+/**
+ * @brief Lines per second admitted by a tag or the whole log.
+ */
+class RateLimit {
+ public:
+  /**
+   * @brief Takes a line from the budget of the current second.
+   * @param limit Lines per second, 0 for no limit.
+   * @return False if the budget is used up.
+   */
+  bool admit(size_t limit);
+
+ private:
+  std::atomic<int64_t> second_{-1};  ///< Second the count belongs to.
+  std::atomic<size_t> count_{0};     ///< Lines admitted in that second.
+};
+
+/**
+ * @brief Name of the game (or other unit) log lines belong to, with its own
+ * rate limit.
+ */
+class Tag {
+ public:
+  /**
+   * @brief Constructor.
+   * @param name Written with every line of the tag, e.g. "room 3".
+   * @param linesPerSecond Limit of the tag, 0 for the limit of the log.
+   */
+  explicit Tag(std::string name, size_t linesPerSecond = 0);
+
+  Tag(const Tag&) = delete;
+  Tag& operator=(const Tag&) = delete;
+
+  const std::string& getName() const;
+  size_t getLimit() const;
+  RateLimit& getRateLimit();
+
+ private:
+  std::string name_;
+  size_t limit_;
+  RateLimit rateLimit_;
+};
+
+/**
+ * @brief Tags the lines logged by the current thread while in scope.
+ */
+class ScopedTag {
+ public:
+  explicit ScopedTag(Tag& tag);
+  ~ScopedTag();
+
+  ScopedTag(const ScopedTag&) = delete;
+  ScopedTag& operator=(const ScopedTag&) = delete;
+
+ private:
+  Tag* previous_;  ///< Restored when leaving the scope.
+};
+
+/**
+ * @brief One log line as handed to the sinks.
+ */
+struct Record {
+  std::chrono::system_clock::time_point time;
+  Level level = Level::INFO;
+  std::string component;
+  std::string tag;  ///< Empty for untagged lines.
+  std::string message;
+};
+
+/**
+ * @brief Encodings of a log sink.
+ */
+enum class Format {
+  TEXT,    ///< One line per record: time, level, component, tag, message.
+  BINARY,  ///< Length-prefixed records, read back with readBinary().
+};
+
+/**
+ * @brief Configuration of the asynchronous log.
+ */
+struct AsyncOptions {
+  std::string path;              ///< Log file (appended), empty for stderr.
+  Format format = Format::TEXT;  ///< Encoding of the sink.
+  size_t capacity = 8192;        ///< Lines buffered before new ones drop.
+  size_t linesPerSecond = 0;     ///< Limit per tag and for untagged lines
+                                 ///< below ERROR, 0 for no limit.
+
+  /**
+   * @brief Reads BRAENDI_LOG_FILE, BRAENDI_LOG_FORMAT ("text" or "binary")
+   * and BRAENDI_LOG_RATE, defaults for unset variables.
+   */
+  static AsyncOptions fromEnvironment();
+};
+
+/**
+ * @brief Starts the background writer; later lines are only queued.
+ * @throws std::runtime_error if the log file cannot be opened.
+ */
+void startAsync(const AsyncOptions& options = {});
+
+/**
+ * @brief Writes the queued lines and stops the background writer; later
+ * lines are written on the calling thread again.
+ */
+void stopAsync();
+
+/**
+ * @brief Gets the number of lines dropped by rate limits or a full buffer.
+ */
+size_t droppedLines();
+
+/**
+ * @brief Formats a record as one text line (without newline).
+ */
+std::string formatText(const Record& record);
+
+/**
+ * @brief Appends a record in the binary sink format.
+ */
+void writeBinary(std::string& out, const Record& record);
+
+/**
+ * @brief Decodes the records of a binary log.
+ * @throws std::runtime_error if the data is not a complete binary log.
+ */
+std::vector<Record> readBinary(std::string_view data);
+
+/**
+ * @brief Write a formatted log line.
+ * @param level Severity of the message.
+ * @param component Emitting component (e.g. "Server").
+ * @param message Formatted message.
+ */
+void write(Level level, std::string_view component, std::string message);
+
+}  // namespace Log
+}  // namespace BraendiDog
+
+/// Log a stream expression if the level is enabled.
+#define BD_LOG(level, component, expr)                                  \
+  do {                                                                  \
+    if (static_cast<int>(level) >= BRAENDI_LOG_MIN_LEVEL &&             \
+        ::BraendiDog::Log::enabled(level)) {                            \
+      std::ostringstream bdLogStream;                                   \
+      bdLogStream << expr;                                              \
+      ::BraendiDog::Log::write(level, component, bdLogStream.str());    \
+    }                                                                   \
+  } while (false)
+
+#define BD_LOG_TRACE(component, expr) \
+  BD_LOG(::BraendiDog::Log::Level::TRACE, component, expr)
+#define BD_LOG_DEBUG(component, expr) \
+  BD_LOG(::BraendiDog::Log::Level::DEBUG, component, expr)
+#define BD_LOG_INFO(component, expr) \
+  BD_LOG(::BraendiDog::Log::Level::INFO, component, expr)
+#define BD_LOG_WARN(component, expr) \
+  BD_LOG(::BraendiDog::Log::Level::WARN, component, expr)
+#define BD_LOG_ERROR(component, expr) \
+  BD_LOG(::BraendiDog::Log::Level::ERR, component, expr)
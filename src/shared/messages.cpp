@@ -62,6 +62,26 @@ std::unique_ptr<Message> Message::fromJson(const nlohmann::json& json) {
       // Server private messages
       case MessageType::PRIV_CARDS_DEALT:
         return Message::fromJsonImpl<CardsDealtMessage>(json);
+
+      // Room management
+      case MessageType::REQ_LIST_ROOMS:
+        return Message::fromJsonImpl<ListRoomsRequestMessage>(json);
+      case MessageType::REQ_CREATE_ROOM:
+        return Message::fromJsonImpl<CreateRoomRequestMessage>(json);
+      case MessageType::REQ_JOIN_ROOM:
+        return Message::fromJsonImpl<JoinRoomRequestMessage>(json);
+      case MessageType::RESP_LIST_ROOMS:
+        return Message::fromJsonImpl<ListRoomsResponseMessage>(json);
+      case MessageType::RESP_CREATE_ROOM:
+        return Message::fromJsonImpl<CreateRoomResponseMessage>(json);
+      case MessageType::RESP_JOIN_ROOM:
+        return Message::fromJsonImpl<JoinRoomResponseMessage>(json);
+
+      // Game state deltas
+      case MessageType::BRDC_GAMESTATE_DELTA:
+        return Message::fromJsonImpl<GameStateDeltaMessage>(json);
+      case MessageType::REQ_GAMESTATE:
+        return Message::fromJsonImpl<GameStateRequestMessage>(json);
     }
 
     // This should never be reached - all enum values are handled above
@@ -39,6 +39,19 @@ enum class MessageType {
   REQ_START_GAME,  ///< Start game request --MessageType 15
   REQ_PLAY_CARD,   ///< Game move request --MessageType 16
   REQ_SKIP_TURN,   ///< Forced fold request --MessageType 17
+
+  // Room management
+  REQ_LIST_ROOMS,    ///< Room list request --MessageType 18
+  REQ_CREATE_ROOM,   ///< Create and join a room --MessageType 19
+  REQ_JOIN_ROOM,     ///< Join an existing room --MessageType 20
+  RESP_LIST_ROOMS,   ///< Response with the room list --MessageType 21
+  RESP_CREATE_ROOM,  ///< Response to create room request --MessageType 22
+  RESP_JOIN_ROOM,    ///< Response to join room request --MessageType 23
+
+  // Game state deltas
+  BRDC_GAMESTATE_DELTA,  ///< Changes since the last game state update
+                         ///< --MessageType 24
+  REQ_GAMESTATE,         ///< Request for a full game state --MessageType 25
 };
 
 /**
@@ -85,6 +98,24 @@ inline std::string messageTypeToString(MessageType type) {
       return "REQ_PLAY_CARD";
     case MessageType::REQ_SKIP_TURN:
       return "REQ_SKIP_TURN";
+
+    case MessageType::REQ_LIST_ROOMS:
+      return "REQ_LIST_ROOMS";
+    case MessageType::REQ_CREATE_ROOM:
+      return "REQ_CREATE_ROOM";
+    case MessageType::REQ_JOIN_ROOM:
+      return "REQ_JOIN_ROOM";
+    case MessageType::RESP_LIST_ROOMS:
+      return "RESP_LIST_ROOMS";
+    case MessageType::RESP_CREATE_ROOM:
+      return "RESP_CREATE_ROOM";
+    case MessageType::RESP_JOIN_ROOM:
+      return "RESP_JOIN_ROOM";
+
+    case MessageType::BRDC_GAMESTATE_DELTA:
+      return "BRDC_GAMESTATE_DELTA";
+    case MessageType::REQ_GAMESTATE:
+      return "REQ_GAMESTATE";
   }
   std::cerr << "Unknown MessageType: " << static_cast<int>(type) << std::endl;
   std::abort();
@@ -136,6 +167,24 @@ inline MessageType stringToMessageType(const std::string& s) {
   else if (s == "REQ_SKIP_TURN")
     return MessageType::REQ_SKIP_TURN;
 
+  else if (s == "REQ_LIST_ROOMS")
+    return MessageType::REQ_LIST_ROOMS;
+  else if (s == "REQ_CREATE_ROOM")
+    return MessageType::REQ_CREATE_ROOM;
+  else if (s == "REQ_JOIN_ROOM")
+    return MessageType::REQ_JOIN_ROOM;
+  else if (s == "RESP_LIST_ROOMS")
+    return MessageType::RESP_LIST_ROOMS;
+  else if (s == "RESP_CREATE_ROOM")
+    return MessageType::RESP_CREATE_ROOM;
+  else if (s == "RESP_JOIN_ROOM")
+    return MessageType::RESP_JOIN_ROOM;
+
+  else if (s == "BRDC_GAMESTATE_DELTA")
+    return MessageType::BRDC_GAMESTATE_DELTA;
+  else if (s == "REQ_GAMESTATE")
+    return MessageType::REQ_GAMESTATE;
+
   // Unknown string - crash with informative message
   std::cerr << "FATAL ERROR in stringToMessageType(): Unknown msgType string: '"
             << s << "'" << std::endl;
@@ -396,9 +445,11 @@ class PrivateMessage : public Message {
  */
 class ConnectionRequestMessage : public Message {
  public:
-  std::string name;  ///< Player's display name
+  std::string name;       ///< Player's display name
+  size_t wireFormat = 0;  ///< Newest wire format offered (0 = JSON only)
 
-  ConnectionRequestMessage(std::string name) : name(std::move(name)) {}
+  ConnectionRequestMessage(std::string name, size_t wireFormat = 0)
+      : name(std::move(name)), wireFormat(wireFormat) {}
   ConnectionRequestMessage() = default;
 
   MessageType getMessageType() const override {
@@ -406,7 +457,8 @@ class ConnectionRequestMessage : public Message {
   }
 
   IMPLEMENT_MESSAGE_TOJSON()
-  NLOHMANN_DEFINE_TYPE_INTRUSIVE(ConnectionRequestMessage, name)
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ConnectionRequestMessage, name,
+                                              wireFormat)
 };
 
 /**
@@ -458,10 +510,13 @@ struct PlayerInfo {
  */
 class ConnectionResponseMessage : public ServerResponse {
  public:
-  size_t playerId;  ///< Assigned player ID (only if success is true)
-  ConnectionResponseMessage(bool success, std::string err, size_t id)
+  size_t playerId = 0;    ///< Assigned player ID (only if success is true)
+  size_t wireFormat = 0;  ///< Wire format of all following messages
+  ConnectionResponseMessage(bool success, std::string err, size_t id,
+                            size_t wireFormat = 0)
       : ServerResponse(MessageType::RESP_CONNECT, success, std::move(err)),
-        playerId(id) {}
+        playerId(id),
+        wireFormat(wireFormat) {}
   ConnectionResponseMessage() = default;
 
   MessageType getMessageType() const override {
@@ -469,8 +524,9 @@ class ConnectionResponseMessage : public ServerResponse {
   }
 
   IMPLEMENT_MESSAGE_TOJSON()
-  NLOHMANN_DEFINE_TYPE_INTRUSIVE(ConnectionResponseMessage, success_, errorMsg_,
-                                 playerId)
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(ConnectionResponseMessage,
+                                              success_, errorMsg_, playerId,
+                                              wireFormat)
 };
 
 /**
@@ -646,24 +702,82 @@ class SkipTurnResponseMessage : public ServerResponse {
 };
 
 /**
- * @brief Broadcast containing updated game state.
+ * @brief Broadcast containing the full game state.
+ *
+ * Sent when a game starts, on request and periodically; all other updates
+ * are GameStateDeltaMessages.
  */
 class GameStateUpdateMessage : public BroadcastMessage {
  public:
   BraendiDog::GameState gameState;
+  size_t sequence = 0;  ///< Number of the update within the game
 
   GameStateUpdateMessage() = default;
 
-  GameStateUpdateMessage(const BraendiDog::GameState& state)
+  GameStateUpdateMessage(const BraendiDog::GameState& state,
+                         size_t sequence = 0)
       : BroadcastMessage(MessageType::BRDC_GAMESTATE_UPDATE),
-        gameState(state) {}
+        gameState(state),
+        sequence(sequence) {}
 
   MessageType getMessageType() const override {
     return MessageType::BRDC_GAMESTATE_UPDATE;
   }
 
+  nlohmann::json toJson() const override {
+    nlohmann::json json;
+    addMessageType(json, getMessageType());
+    nlohmann::json data = *this;
+    data["gameState"].erase("rng");  // Future deals stay on the server
+    json.update(data);
+    return json;
+  }
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(GameStateUpdateMessage, gameState,
+                                              sequence)
+};
+
+/**
+ * @brief Broadcast with the changes since the previous game state update.
+ *
+ * Applies to the state of update sequence - 1. A client that missed an
+ * update requests the full state with REQ_GAMESTATE.
+ */
+class GameStateDeltaMessage : public BroadcastMessage {
+ public:
+  size_t sequence = 0;  ///< Number of the update within the game
+  BraendiDog::GameStateDelta delta;
+
+  GameStateDeltaMessage() = default;
+
+  GameStateDeltaMessage(size_t sequence, BraendiDog::GameStateDelta delta)
+      : BroadcastMessage(MessageType::BRDC_GAMESTATE_DELTA),
+        sequence(sequence),
+        delta(std::move(delta)) {}
+
+  MessageType getMessageType() const override {
+    return MessageType::BRDC_GAMESTATE_DELTA;
+  }
+
+  IMPLEMENT_MESSAGE_TOJSON()
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE(GameStateDeltaMessage, sequence, delta)
+};
+
+/**
+ * @brief Client request for the full game state (answered with
+ * BRDC_GAMESTATE_UPDATE to the requesting player only).
+ */
+class GameStateRequestMessage : public ClientRequest {
+ public:
+  GameStateRequestMessage(size_t id)
+      : ClientRequest(MessageType::REQ_GAMESTATE, id) {}
+  GameStateRequestMessage() = default;
+
+  MessageType getMessageType() const override {
+    return MessageType::REQ_GAMESTATE;
+  }
+
   IMPLEMENT_MESSAGE_TOJSON()
-  NLOHMANN_DEFINE_TYPE_INTRUSIVE(GameStateUpdateMessage, gameState)
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE(GameStateRequestMessage, playerId_)
 };
 
 /**
@@ -723,3 +837,161 @@ class CardsDealtMessage : public PrivateMessage {
   IMPLEMENT_MESSAGE_TOJSON()
   NLOHMANN_DEFINE_TYPE_INTRUSIVE(CardsDealtMessage, playerId_, cards)
 };
+
+// ==================== ROOM MANAGEMENT MESSAGES ====================
+
+/**
+ * @brief Summary of a room for room lists.
+ */
+struct RoomInfo {
+  size_t id;
+  std::string name;
+  size_t players = 0;   ///< Seated players (at most 4)
+  bool inGame = false;  ///< Whether a game is running in the room
+
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE(RoomInfo, id, name, players, inGame)
+};
+
+/**
+ * @brief Client request for the list of rooms.
+ *
+ * Note: Like REQ_CONNECT this has no playerId, it may be sent before joining a
+ * room.
+ */
+class ListRoomsRequestMessage : public Message {
+ public:
+  bool openOnly = false;  ///< Only list rooms that can be joined
+
+  ListRoomsRequestMessage(bool openOnly) : openOnly(openOnly) {}
+  ListRoomsRequestMessage() = default;
+
+  MessageType getMessageType() const override {
+    return MessageType::REQ_LIST_ROOMS;
+  }
+
+  IMPLEMENT_MESSAGE_TOJSON()
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE(ListRoomsRequestMessage, openOnly)
+};
+
+/**
+ * @brief Client request to create a new room and take its first seat.
+ */
+class CreateRoomRequestMessage : public Message {
+ public:
+  std::string name;       ///< Player's display name
+  std::string roomName;   ///< Display name of the room
+  size_t wireFormat = 0;  ///< Newest wire format offered (0 = JSON only)
+
+  CreateRoomRequestMessage(std::string name, std::string roomName,
+                           size_t wireFormat = 0)
+      : name(std::move(name)),
+        roomName(std::move(roomName)),
+        wireFormat(wireFormat) {}
+  CreateRoomRequestMessage() = default;
+
+  MessageType getMessageType() const override {
+    return MessageType::REQ_CREATE_ROOM;
+  }
+
+  IMPLEMENT_MESSAGE_TOJSON()
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(CreateRoomRequestMessage, name,
+                                              roomName, wireFormat)
+};
+
+/**
+ * @brief Client request to join an existing room.
+ */
+class JoinRoomRequestMessage : public Message {
+ public:
+  std::string name;       ///< Player's display name
+  size_t roomId = 0;      ///< ID of the room to join
+  size_t wireFormat = 0;  ///< Newest wire format offered (0 = JSON only)
+
+  JoinRoomRequestMessage(std::string name, size_t roomId,
+                         size_t wireFormat = 0)
+      : name(std::move(name)), roomId(roomId), wireFormat(wireFormat) {}
+  JoinRoomRequestMessage() = default;
+
+  MessageType getMessageType() const override {
+    return MessageType::REQ_JOIN_ROOM;
+  }
+
+  IMPLEMENT_MESSAGE_TOJSON()
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(JoinRoomRequestMessage, name,
+                                              roomId, wireFormat)
+};
+
+/**
+ * @brief Server response with the list of rooms.
+ */
+class ListRoomsResponseMessage : public ServerResponse {
+ public:
+  std::vector<RoomInfo> rooms;
+
+  ListRoomsResponseMessage(std::vector<RoomInfo> rooms)
+      : ServerResponse(MessageType::RESP_LIST_ROOMS, true),
+        rooms(std::move(rooms)) {}
+  ListRoomsResponseMessage() = default;
+
+  MessageType getMessageType() const override {
+    return MessageType::RESP_LIST_ROOMS;
+  }
+
+  IMPLEMENT_MESSAGE_TOJSON()
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE(ListRoomsResponseMessage, success_, errorMsg_,
+                                 rooms)
+};
+
+/**
+ * @brief Server response to a create room request.
+ */
+class CreateRoomResponseMessage : public ServerResponse {
+ public:
+  size_t roomId = 0;      ///< ID of the new room (only if success is true)
+  size_t playerId = 0;    ///< Assigned player ID (only if success is true)
+  size_t wireFormat = 0;  ///< Wire format of all following messages
+
+  CreateRoomResponseMessage(bool success, std::string err, size_t roomId,
+                            size_t playerId, size_t wireFormat = 0)
+      : ServerResponse(MessageType::RESP_CREATE_ROOM, success, std::move(err)),
+        roomId(roomId),
+        playerId(playerId),
+        wireFormat(wireFormat) {}
+  CreateRoomResponseMessage() = default;
+
+  MessageType getMessageType() const override {
+    return MessageType::RESP_CREATE_ROOM;
+  }
+
+  IMPLEMENT_MESSAGE_TOJSON()
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(CreateRoomResponseMessage,
+                                              success_, errorMsg_, roomId,
+                                              playerId, wireFormat)
+};
+
+/**
+ * @brief Server response to a join room request.
+ */
+class JoinRoomResponseMessage : public ServerResponse {
+ public:
+  size_t roomId = 0;      ///< ID of the joined room
+  size_t playerId = 0;    ///< Assigned player ID (only if success is true)
+  size_t wireFormat = 0;  ///< Wire format of all following messages
+
+  JoinRoomResponseMessage(bool success, std::string err, size_t roomId,
+                          size_t playerId, size_t wireFormat = 0)
+      : ServerResponse(MessageType::RESP_JOIN_ROOM, success, std::move(err)),
+        roomId(roomId),
+        playerId(playerId),
+        wireFormat(wireFormat) {}
+  JoinRoomResponseMessage() = default;
+
+  MessageType getMessageType() const override {
+    return MessageType::RESP_JOIN_ROOM;
+  }
+
+  IMPLEMENT_MESSAGE_TOJSON()
+  NLOHMANN_DEFINE_TYPE_INTRUSIVE_WITH_DEFAULT(JoinRoomResponseMessage,
+                                              success_, errorMsg_, roomId,
+                                              playerId, wireFormat)
+};
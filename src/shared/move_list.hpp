@@ -0,0 +1,192 @@
+/**
+ * @file move_list.hpp
+ * @brief Fixed-capacity containers for allocation free move generation.
+ */
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "shared/game_types.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief A single marble movement (marble and its target position).
+ */
+using Movement = std::pair<MarbleIdentifier, Position>;
+
+/**
+ * @brief Fixed-capacity buffer of marble movements with inline storage.
+ *
+ * Used for the flattened results of the check*Move helpers, which check one
+ * marble at a time. The largest result is a Seven walk: at most 7 parts, each
+ * on the track and into the finish, with up to 7 opponents sent home (70
+ * movements). A Jack swaps with at most 12 opponent marbles (24 movements).
+ */
+class MovementBuffer {
+ public:
+  static constexpr size_t capacity = 128;  ///< Maximum number of movements.
+
+  /**
+   * @brief Append a movement.
+   * @param movement Movement to append.
+   * @pre The buffer is not full (guaranteed by the bound above).
+   */
+  void push_back(const Movement& movement) {
+    assert(count < capacity && "MovementBuffer capacity exceeded");
+    items[count++] = movement;
+  }
+
+  /**
+   * @brief Remove all movements.
+   */
+  void clear() { count = 0; }
+
+  /**
+   * @brief Shrink the buffer back to a previous size.
+   * @param newSize Number of movements to keep.
+   */
+  void resize(size_t newSize) {
+    if (newSize < count) {
+      count = newSize;
+    }
+  }
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  const Movement& operator[](size_t i) const { return items[i]; }
+  const Movement* begin() const { return items.data(); }
+  const Movement* end() const { return items.data() + count; }
+
+  /**
+   * @brief View of the stored movements.
+   */
+  std::span<const Movement> view() const { return {items.data(), count}; }
+
+ private:
+  std::array<Movement, capacity> items;  ///< Inline movement storage.
+  size_t count = 0;                       ///< Number of stored movements.
+};
+
+/**
+ * @brief Non-owning view of one move stored in a MoveList.
+ * @note Mirrors the getters of Move. Invalidated when the list is cleared.
+ */
+struct MoveView {
+  size_t cardID;     ///< The card used for the move.
+  size_t handIndex;  ///< The index of the card in the player's hand.
+  std::span<const Movement> movements;  ///< The marble movements of the move.
+
+  size_t getCardID() const { return cardID; }
+  size_t getHandIndex() const { return handIndex; }
+  std::span<const Movement> getMovements() const { return movements; }
+
+  /**
+   * @brief Convert to an owning Move.
+   * @return Move holding a copy of the movements.
+   */
+  Move toMove() const {
+    return Move(cardID, handIndex,
+                std::vector<Movement>(movements.begin(), movements.end()));
+  }
+};
+
+/**
+ * @brief Fixed-capacity list of moves with inline movement storage.
+ *
+ * Filled by GameState::generateLegalMoves without any heap allocation. The
+ * list is meant to be reused across calls (generation appends, call clear()
+ * before reuse).
+ *
+ * The largest list is one call for a full hand of 6 cards. A Jack swaps each
+ * of the 4 own marbles with up to 12 opponent marbles (48 moves, 96
+ * movements). Any other card gives at most 4 moves per marble (two step
+ * rules, each with a track and a finish option, at most 6 movements). With
+ * all 4 Jacks in hand that is 4 * 48 + 2 * 16 = 224 moves and
+ * 4 * 96 + 2 * 24 = 432 movements. Joker ranks and Seven split levels are
+ * generated one card per list: at most 48 moves, or 4 marbles with 70
+ * movements each.
+ */
+class MoveList {
+ public:
+  static constexpr size_t maxMoves = 256;  ///< Maximum number of moves.
+  static constexpr size_t maxMovements =
+      768;  ///< Maximum number of movements over all moves.
+
+  /**
+   * @brief Append a move.
+   * @param cardID Card ID used for the move.
+   * @param handIndex Index of the card in the player's hand.
+   * @param movements Marble movements of the move.
+   * @pre The list has room (guaranteed by the bound above).
+   */
+  void push_back(size_t cardID, size_t handIndex,
+                 std::span<const Movement> movements) {
+    assert(moveCount < maxMoves &&
+           movementCount + movements.size() <= maxMovements &&
+           "MoveList capacity exceeded");
+    entries[moveCount++] = {cardID, handIndex, movementCount,
+                            movements.size()};
+    for (const Movement& movement : movements) {
+      pool[movementCount++] = movement;
+    }
+  }
+
+  /**
+   * @brief Remove all moves.
+   */
+  void clear() {
+    moveCount = 0;
+    movementCount = 0;
+  }
+
+  size_t size() const { return moveCount; }
+  bool empty() const { return moveCount == 0; }
+
+  /**
+   * @brief Access a stored move.
+   * @param i Index of the move.
+   * @return View of the move.
+   */
+  MoveView operator[](size_t i) const {
+    const Entry& e = entries[i];
+    return {e.cardID, e.handIndex, {pool.data() + e.first, e.count}};
+  }
+
+  /**
+   * @brief Copy all moves into owning Move objects.
+   * @return Vector of moves.
+   */
+  std::vector<Move> toVector() const {
+    std::vector<Move> moves;
+    moves.reserve(moveCount);
+    for (size_t i = 0; i < moveCount; ++i) {
+      moves.push_back((*this)[i].toMove());
+    }
+    return moves;
+  }
+
+ private:
+  /**
+   * @brief Move header referencing a range of the movement pool.
+   */
+  struct Entry {
+    size_t cardID;
+    size_t handIndex;
+    size_t first;
+    size_t count;
+  };
+
+  std::array<Entry, maxMoves> entries;      ///< Move headers.
+  std::array<Movement, maxMovements> pool;  ///< Shared movement storage.
+  size_t moveCount = 0;      ///< Number of stored moves.
+  size_t movementCount = 0;  ///< Number of used pool slots.
+};
+
+}  // namespace BraendiDog
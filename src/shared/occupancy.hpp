@@ -0,0 +1,123 @@
+/**
+ * @file occupancy.hpp
+ * @brief Bitboard occupancy index for the Brändi Dog board.
+ *
+ * Mirrors the marble positions held by the players of a GameState so that
+ * occupancy and path-blocking checks are constant time bit operations instead
+ * of scans over all marbles.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "shared/game_types.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief Occupancy index of all marbles on TRACK and FINISH fields.
+ *
+ * Marbles are stored in the lookup tables as a compact code
+ * (playerID * 4 + marbleIdx). HOME fields are not indexed, every marble owns
+ * exactly one home field.
+ */
+struct OccupancyIndex {
+  static constexpr uint8_t emptyField =
+      0xFF;  ///< Lookup value of a free field.
+
+  uint64_t track = 0;  ///< Bit i set if track field i is occupied.
+  std::array<uint8_t, 4> finish{};  ///< Per player 4-bit mask of occupied
+                                    ///< finish fields.
+  std::array<uint8_t, 64> trackOccupant{};   ///< Marble code per track field.
+  std::array<uint8_t, 16> finishOccupant{};  ///< Marble code per finish field
+                                             ///< (playerID * 4 + index).
+
+  /**
+   * @brief Remove all marbles from the index.
+   */
+  void clear() {
+    track = 0;
+    finish.fill(0);
+    trackOccupant.fill(emptyField);
+    finishOccupant.fill(emptyField);
+  }
+
+  /**
+   * @brief Register a marble at the given position.
+   * @param pID Player ID owning the marble.
+   * @param mIdx Index of the marble.
+   * @param pos Position of the marble.
+   */
+  void add(size_t pID, size_t mIdx, const Position& pos) {
+    uint8_t code = static_cast<uint8_t>(pID * 4 + mIdx);
+    if (pos.boardLocation == BoardLocation::TRACK) {
+      track |= uint64_t{1} << pos.index;
+      trackOccupant[pos.index] = code;
+    } else if (pos.boardLocation == BoardLocation::FINISH) {
+      finish[pos.playerID] |= static_cast<uint8_t>(1u << pos.index);
+      finishOccupant[pos.playerID * 4 + pos.index] = code;
+    }
+  }
+
+  /**
+   * @brief Unregister whatever marble sits at the given position.
+   * @param pos Position to clear.
+   */
+  void remove(const Position& pos) {
+    if (pos.boardLocation == BoardLocation::TRACK) {
+      track &= ~(uint64_t{1} << pos.index);
+      trackOccupant[pos.index] = emptyField;
+    } else if (pos.boardLocation == BoardLocation::FINISH) {
+      finish[pos.playerID] &= static_cast<uint8_t>(~(1u << pos.index));
+      finishOccupant[pos.playerID * 4 + pos.index] = emptyField;
+    }
+  }
+
+  /**
+   * @brief Check if a track field is occupied.
+   * @param index Track index (0-63).
+   */
+  bool isTrackOccupied(size_t index) const {
+    return (track >> index) & uint64_t{1};
+  }
+
+  /**
+   * @brief Check if any of the finish fields lo..hi (inclusive) of a player is
+   * occupied.
+   * @param pID Player ID owning the finish area.
+   * @param lo First finish index to check.
+   * @param hi Last finish index to check.
+   */
+  bool isFinishRangeOccupied(size_t pID, size_t lo, size_t hi) const {
+    if (lo > hi) {
+      return false;
+    }
+    uint8_t range = static_cast<uint8_t>(((1u << (hi + 1)) - 1) &
+                                         ~((1u << lo) - 1));
+    return (finish[pID] & range) != 0;
+  }
+
+  /**
+   * @brief Look up the marble sitting on a TRACK or FINISH field.
+   * @param pos Position to look up (HOME positions always return nullopt).
+   * @return Optional MarbleIdentifier of the occupying marble.
+   */
+  std::optional<MarbleIdentifier> occupant(const Position& pos) const {
+    uint8_t code = emptyField;
+    if (pos.boardLocation == BoardLocation::TRACK) {
+      code = trackOccupant[pos.index];
+    } else if (pos.boardLocation == BoardLocation::FINISH) {
+      code = finishOccupant[pos.playerID * 4 + pos.index];
+    }
+    if (code == emptyField) {
+      return std::nullopt;
+    }
+    return MarbleIdentifier(code >> 2, code & 3);
+  }
+};
+
+}  // namespace BraendiDog
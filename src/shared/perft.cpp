@@ -0,0 +1,99 @@
+#include "shared/perft.hpp"
+
+#include <vector>
+
+namespace BraendiDog {
+
+// Move kind names
+std::string_view moveKindName(MoveKind kind) {
+  switch (kind) {
+    case MoveKind::START:
+      return "START";
+    case MoveKind::SIMPLE:
+      return "SIMPLE";
+    case MoveKind::SWAP:
+      return "SWAP";
+    case MoveKind::SEVEN:
+      return "SEVEN";
+    case MoveKind::JOKER:
+      return "JOKER";
+    default:
+      return "FOLD";
+  }
+}
+
+// Classify move
+MoveKind classifyMove(const GameState& state, const Move& move) {
+  if (move.getMovements().empty()) {
+    return MoveKind::FOLD;
+  }
+  Rank rank = state.getDeck()[move.getCardID()].getRank();
+  if (rank == Rank::JOKER) {
+    return MoveKind::JOKER;
+  }
+  if (rank == Rank::SEVEN) {
+    return MoveKind::SEVEN;
+  }
+  const MarbleIdentifier& marble = move.getMovements()[0].first;
+  if (state.getPlayerByIndex(marble.playerID)
+          ->getMarblePosition(marble.marbleIdx)
+          .boardLocation == BoardLocation::HOME) {
+    return MoveKind::START;
+  }
+  if (rank == Rank::JACK) {
+    return MoveKind::SWAP;
+  }
+  return MoveKind::SIMPLE;
+}
+
+namespace {
+// Recursive perft walk
+void perftWalk(GameState& state, size_t depth, bool verify,
+               PerftResult& result) {
+  std::vector<Move> moves = state.computeAllLegalMoves();
+  if (moves.empty()) {
+    moves.emplace_back();  // Fold
+  }
+
+  // Bulk count the last ply
+  if (depth == 1) {
+    result.nodes += moves.size();
+    for (const Move& move : moves) {
+      ++result.kinds[static_cast<size_t>(classifyMove(state, move))];
+    }
+    return;
+  }
+
+  for (const Move& move : moves) {
+    UndoRecord record =
+        move.getMovements().empty() ? state.makeFold() : state.makeMove(move);
+    auto [gameEnded, roundEnded] = state.endTurn();
+    if (verify && state.hash() != state.rebuildHash()) {
+      ++result.hashMismatches;
+    }
+    if (gameEnded || roundEnded) {
+      ++result.nodes;
+      ++result.terminal;
+    } else {
+      perftWalk(state, depth - 1, verify, result);
+    }
+    state.unmakeMove(record);
+    if (verify && state.hash() != state.rebuildHash()) {
+      ++result.hashMismatches;
+    }
+  }
+}
+}  // namespace
+
+// Perft
+PerftResult perft(GameState& state, size_t depth, bool verify) {
+  PerftResult result;
+  if (depth == 0) {
+    result.nodes = 1;
+    return result;
+  }
+  perftWalk(state, depth, verify, result);
+  return result;
+}
+
+}  // namespace BraendiDog
@@ -0,0 +1,66 @@
+/**
+ * @file perft.hpp
+ * @brief Game tree node counting (perft) for move generator verification.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "shared/game.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief Kind of a move for perft breakdowns.
+ */
+enum class MoveKind {
+  START,   ///< Marble leaves home
+  SIMPLE,  ///< Walking move
+  SWAP,    ///< Jack swap
+  SEVEN,   ///< Complete Seven split
+  JOKER,   ///< Joker played as any rank
+  FOLD     ///< No legal move, hand is discarded
+};
+
+constexpr size_t moveKindCount = 6;  ///< Number of MoveKind values.
+
+/**
+ * @brief Name of a move kind.
+ */
+std::string_view moveKindName(MoveKind kind);
+
+/**
+ * @brief Classify a legal move of the current player.
+ * @param state State the move is played in.
+ * @param move Move to classify (empty movements for a fold).
+ */
+MoveKind classifyMove(const GameState& state, const Move& move);
+
+/**
+ * @brief Result of a perft run.
+ */
+struct PerftResult {
+  uint64_t nodes = 0;     ///< Leaf nodes at the requested depth.
+  uint64_t terminal = 0;  ///< Leaves reached early by a round or game end.
+  std::array<uint64_t, moveKindCount> kinds{};  ///< Last ply moves by kind.
+  uint64_t hashMismatches = 0;  ///< Incremental hashes differing from a
+                                ///< rebuild (verify mode only).
+};
+
+/**
+ * @brief Count the leaf nodes of the game tree below a state.
+ *
+ * Walks computeAllLegalMoves() (fold if empty), makeMove()/makeFold() and
+ * endTurn(), reverting with unmakeMove(). A round or game end is counted as a
+ * leaf since the following deal is random.
+ * @param state State to search, restored on return.
+ * @param depth Number of plies.
+ * @param verify Compare the incremental hash with a rebuild at every node.
+ */
+PerftResult perft(GameState& state, size_t depth, bool verify = false);
+
+}  // namespace BraendiDog
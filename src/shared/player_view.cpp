@@ -0,0 +1,124 @@
+#include "shared/player_view.hpp"
+
+#include <stdexcept>
+
+namespace BraendiDog {
+
+// Constructor
+PlayerView::PlayerView(size_t self) : self(self) {}
+
+// Full state broadcast
+void PlayerView::applyGameState(GameState state, size_t sequence) {
+  this->sequence = sequence;
+  merge(std::move(state));
+}
+
+// Delta broadcast, only on top of the previous update
+bool PlayerView::applyGameStateDelta(const GameStateDelta& delta,
+                                     size_t sequence) {
+  if (!game.has_value() || sequence != this->sequence + 1) {
+    return false;
+  }
+  GameState next = game.value();
+  try {
+    next.applyDelta(delta);
+  } catch (const std::invalid_argument&) {
+    return false;
+  }
+  this->sequence = sequence;
+  merge(std::move(next));
+  return true;
+}
+
+// Merge a new state with the hands only we track
+void PlayerView::merge(GameState state) {
+  // A new card on the table was played by the previous current player
+  std::optional<size_t> played = state.getLastPlayedCard();
+  if (played.has_value() && played != lastSeen) {
+    seenCards.push_back(played.value());
+    lastSeen = played;
+    if (game.has_value()) {
+      size_t mover = game->getCurrentPlayer();
+      if (mover != self && handSizes[mover] > 0) {
+        --handSizes[mover];
+      }
+    }
+  }
+
+  // Broadcasts carry no hands: ours is known, the others only by size
+  for (const auto& player : state.getPlayers()) {
+    if (!player.has_value()) {
+      continue;
+    }
+    size_t pID = player->getId();
+    if (!player->isActiveInRound()) {
+      handSizes[pID] = 0;
+    }
+    if (pID == self) {
+      state.setHand(pID, player->isActiveInRound() ? hand
+                                                   : std::vector<size_t>());
+    } else {
+      state.setHand(pID, std::vector<size_t>(handSizes[pID], 0));
+    }
+  }
+  game = std::move(state);
+}
+
+// New round
+bool PlayerView::applyCardsDealt(std::vector<size_t> cards) {
+  if (!game.has_value()) {
+    return false;
+  }
+
+  // Every player in the game holds as many cards as we do
+  hand = std::move(cards);
+  seenCards.clear();
+  lastSeen = game->getLastPlayedCard();
+  for (size_t pID = 0; pID < 4; ++pID) {
+    const auto& player = game->getPlayerByIndex(pID);
+    handSizes[pID] =
+        player.has_value() && player->isActiveInGame() ? hand.size() : 0;
+  }
+  merge(game.value());
+  return true;
+}
+
+// Remember which card left the hand
+void PlayerView::moveSent(const Move& move) {
+  sentHandIndex.reset();
+  if (!move.getMovements().empty()) {
+    sentHandIndex = move.getHandIndex();
+  }
+}
+
+// The card leaves our hand, a fold discards it
+void PlayerView::turnAccepted(bool folded) {
+  if (folded) {
+    hand.clear();
+  } else if (sentHandIndex.has_value() && sentHandIndex.value() < hand.size()) {
+    hand.erase(hand.begin() + sentHandIndex.value());
+  }
+  sentHandIndex.reset();
+}
+
+// Check turn
+bool PlayerView::isOwnTurn() const {
+  if (!game.has_value()) {
+    return false;
+  }
+  const auto& player = game->getPlayerByIndex(self);
+  return game->getCurrentPlayer() == self && player.has_value() &&
+         player->isActiveInRound() && !player->isHandEmpty() &&
+         !game->checkGameEnd();
+}
+
+// Get player ID
+size_t PlayerView::getSelf() const { return self; }
+
+// Get state
+const std::optional<GameState>& PlayerView::getState() const { return game; }
+
+// Get seen cards
+std::span<const size_t> PlayerView::getSeenCards() const { return seenCards; }
+
+}  // namespace BraendiDog
@@ -0,0 +1,106 @@
+/**
+ * @file player_view.hpp
+ * @brief A player's view of a game built from the server's messages.
+ *
+ * Game state broadcasts carry no hands. The view keeps the player's own hand
+ * from the dealt cards and tracks the opponents' hand sizes and the cards
+ * played this round, like the GUI client does for its game panel.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "shared/game.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief Local game state of one connected player.
+ */
+class PlayerView {
+ public:
+  /**
+   * @brief Constructor.
+   * @param self ID of the player assigned by the server.
+   */
+  explicit PlayerView(size_t self);
+
+  /**
+   * @brief Merge a game state broadcast into the view.
+   * @param state Broadcast state (carries no hands).
+   * @param sequence Sequence number of the update.
+   */
+  void applyGameState(GameState state, size_t sequence = 0);
+
+  /**
+   * @brief Apply the changes of a delta broadcast to the view.
+   * @param delta Changes since the previous update.
+   * @param sequence Sequence number of the update.
+   * @return False if the delta does not follow the last applied update (the
+   * view is unchanged and needs the full state).
+   */
+  bool applyGameStateDelta(const GameStateDelta& delta, size_t sequence);
+
+  /**
+   * @brief Start a new round with the dealt cards.
+   * @param cards Card IDs dealt to the player.
+   * @return False if no game state was received yet (cards are ignored).
+   */
+  bool applyCardsDealt(std::vector<size_t> cards);
+
+  /**
+   * @brief Record the hand index of a move sent to the server.
+   * @param move Sent move, no movements for a fold.
+   */
+  void moveSent(const Move& move);
+
+  /**
+   * @brief Remove the sent card from the hand after the server accepted it.
+   * @param folded True if the accepted turn was a fold.
+   */
+  void turnAccepted(bool folded);
+
+  /**
+   * @brief Check if the player has to play now.
+   * @return True if it is the player's turn, with cards and the game running.
+   */
+  bool isOwnTurn() const;
+
+  /**
+   * @brief Get the player's ID.
+   */
+  size_t getSelf() const;
+
+  /**
+   * @brief Get the local state, std::nullopt before the first broadcast.
+   * @note Opponent hands hold placeholder card IDs of the tracked sizes.
+   */
+  const std::optional<GameState>& getState() const;
+
+  /**
+   * @brief Get the cards played this round.
+   */
+  std::span<const size_t> getSeenCards() const;
+
+ private:
+  size_t self;                           ///< ID of the player.
+  std::optional<GameState> game;         ///< Local state.
+  std::vector<size_t> hand;              ///< Own hand.
+  std::array<size_t, 4> handSizes{};     ///< Cards left per player.
+  std::optional<size_t> sentHandIndex;   ///< Hand index of the sent card.
+  std::vector<size_t> seenCards;         ///< Cards played this round.
+  std::optional<size_t> lastSeen;        ///< Last played card recorded.
+  size_t sequence = 0;                   ///< Last applied update.
+
+  /**
+   * @brief Merge a new local state with the tracked hands.
+   */
+  void merge(GameState state);
+};
+
+}  // namespace BraendiDog
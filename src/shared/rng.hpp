@@ -0,0 +1,124 @@
+/**
+ * @file rng.hpp
+ * @brief Small fast seedable random generator (xoshiro256**) for game deals.
+ *
+ * Each GameState owns one generator, so games never share random state and a
+ * deal can be reproduced from the seed.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+#include "shared/zobrist.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief xoshiro256** generator satisfying UniformRandomBitGenerator.
+ */
+class Xoshiro256 {
+ public:
+  using result_type = uint64_t;
+
+  /**
+   * @brief Construct a generator from a 64-bit seed.
+   * @param seed Seed expanded to the full state with splitmix64.
+   */
+  explicit constexpr Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+  /**
+   * @brief Reset the state from a 64-bit seed.
+   * @param seed Seed expanded to the full state with splitmix64.
+   */
+  constexpr void reseed(uint64_t seed) {
+    for (auto& word : s_) {
+      word = Zobrist::splitmix64(seed);
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /**
+   * @brief Advance the generator.
+   * @return Next pseudo random 64-bit value.
+   */
+  constexpr result_type operator()() {
+    const uint64_t result = rotl(s_[1] * 5, 7) * 9;
+    const uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = rotl(s_[3], 45);
+    return result;
+  }
+
+  /**
+   * @brief Draw an unbiased value in [0, bound) (Lemire's method).
+   * @param bound Exclusive upper bound, must be positive.
+   * @return Uniformly distributed value below bound.
+   */
+  uint64_t below(uint64_t bound) {
+    unsigned __int128 product =
+        static_cast<unsigned __int128>((*this)()) * bound;
+    uint64_t low = static_cast<uint64_t>(product);
+    if (low < bound) {
+      const uint64_t threshold = -bound % bound;
+      while (low < threshold) {
+        product = static_cast<unsigned __int128>((*this)()) * bound;
+        low = static_cast<uint64_t>(product);
+      }
+    }
+    return static_cast<uint64_t>(product >> 64);
+  }
+
+  /**
+   * @brief Get the raw state (for serialization).
+   */
+  const std::array<uint64_t, 4>& state() const { return s_; }
+
+  /**
+   * @brief Restore a raw state (for deserialization).
+   * @throws std::invalid_argument if the state is all zero.
+   */
+  void setState(const std::array<uint64_t, 4>& state) {
+    if (state == std::array<uint64_t, 4>{}) {
+      throw std::invalid_argument("xoshiro256 state must not be all zero");
+    }
+    s_ = state;
+  }
+
+  bool operator==(const Xoshiro256& other) const = default;
+
+ private:
+  static constexpr uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  std::array<uint64_t, 4> s_{};
+};
+
+/**
+ * @brief Serialize the generator state.
+ */
+inline void to_json(nlohmann::json& j, const Xoshiro256& rng) {
+  j = rng.state();
+}
+
+/**
+ * @brief Deserialize the generator state.
+ */
+inline void from_json(const nlohmann::json& j, Xoshiro256& rng) {
+  rng.setState(j.get<std::array<uint64_t, 4>>());
+}
+
+}  // namespace BraendiDog
@@ -0,0 +1,67 @@
+#include "shared/simulation.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <tuple>
+
+namespace BraendiDog {
+
+// Uniformly random move
+size_t randomPolicy(const GameState&, const std::vector<Move>& moves,
+                    Xoshiro256& rng) {
+  return rng.below(moves.size());
+}
+
+// Play a complete game
+GameSummary playGame(size_t playerCount, uint64_t seed,
+                     const MovePolicy& policy, size_t maxTurns) {
+  if (playerCount < 2 || playerCount > 4) {
+    throw std::invalid_argument("Player count must be between 2 and 4");
+  }
+
+  std::array<std::optional<std::string>, 4> names;
+  for (size_t i = 0; i < playerCount; ++i) {
+    names[i] = "Bot" + std::to_string(i);
+  }
+  GameState state(names, seed);
+  Xoshiro256 rng(~seed);  // Policy stream, independent of the deals
+  GameSummary summary;
+
+  // Deal like Server::newRound
+  auto deal = [&state, &summary]() {
+    for (const auto& [id, hand] : state.dealCards()) {
+      state.setHand(id, hand);
+    }
+    ++summary.rounds;
+  };
+  deal();
+
+  while (summary.turns < maxTurns) {
+    std::vector<Move> moves = state.computeAllLegalMoves();
+    bool roundEnded;
+    bool gameEnded;
+    if (moves.empty()) {
+      state.executeFold();
+      ++summary.folds;
+    } else {
+      size_t choice =
+          policy ? policy(state, moves, rng) : randomPolicy(state, moves, rng);
+      state.executeMove(moves.at(choice));
+    }
+    ++summary.turns;
+    std::tie(gameEnded, roundEnded) = state.endTurn();
+
+    if (gameEnded) {
+      summary.finished = true;
+      break;
+    }
+    if (roundEnded) {
+      deal();
+    }
+  }
+
+  summary.leaderBoard = state.getLeaderBoard();
+  return summary;
+}
+
+}  // namespace BraendiDog
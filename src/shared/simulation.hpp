@@ -0,0 +1,55 @@
+/**
+ * @file simulation.hpp
+ * @brief Headless self-play of complete games (no sockets, no GUI).
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "shared/game.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief Policy choosing a move for the current player.
+ * @return Index into the legal moves (never called without legal moves).
+ */
+using MovePolicy = std::function<size_t(
+    const GameState&, const std::vector<Move>&, Xoshiro256&)>;
+
+/**
+ * @brief Policy picking a uniformly random legal move.
+ */
+size_t randomPolicy(const GameState& state, const std::vector<Move>& moves,
+                    Xoshiro256& rng);
+
+/**
+ * @brief Summary of one simulated game.
+ */
+struct GameSummary {
+  size_t turns = 0;        ///< Turns played (moves and folds).
+  size_t folds = 0;        ///< Turns without a legal move.
+  size_t rounds = 0;       ///< Rounds dealt.
+  bool finished = false;   ///< False if the turn limit was reached.
+  std::array<std::optional<int>, 4> leaderBoard;  ///< Final leaderboard.
+};
+
+/**
+ * @brief Play a complete game like the server does (deal, turns, rounds).
+ * @param playerCount Number of players (2-4).
+ * @param seed Seed of the game's deals and move policy.
+ * @param policy Move policy, randomPolicy if empty.
+ * @param maxTurns Turn limit guarding against endless games.
+ * @return Summary of the game.
+ */
+GameSummary playGame(size_t playerCount, uint64_t seed,
+                     const MovePolicy& policy = MovePolicy(),
+                     size_t maxTurns = 100000);
+
+}  // namespace BraendiDog
@@ -0,0 +1,182 @@
+#include "shared/transposition_table.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "shared/move_list.hpp"
+#include "shared/zobrist.hpp"
+
+namespace BraendiDog {
+
+namespace {
+// Largest power of two not above value (at least minimum)
+size_t floorPow2(size_t value, size_t minimum) {
+  return std::max(std::bit_floor(value), minimum);
+}
+
+// Set apart the keys of computeAllLegalMoves() from computeLegalMoves()
+constexpr uint64_t allMovesTag = 0xA11D0661E5ull;
+}  // namespace
+
+// Constructor
+TranspositionTable::TranspositionTable(size_t memoryBytes, size_t numStripes)
+    : stripeCount(std::max<size_t>(numStripes, 1)) {
+  // Split budget evenly between legal moves and evaluations
+  size_t half = memoryBytes / 2;
+  size_t moveSlotCount =
+      floorPow2(half / (sizeof(MoveSlot) + approxMoveListBytes), 2);
+  size_t evalSlotCount = floorPow2(half / sizeof(EvalSlot), 1);
+
+  moveSlots.resize(moveSlotCount);
+  evalSlots.resize(evalSlotCount);
+  moveBucketMask = moveSlotCount / 2 - 1;
+  evalMask = evalSlotCount - 1;
+  stripes = std::make_unique<std::mutex[]>(stripeCount);
+}
+
+// Build legal move key
+uint64_t TranspositionTable::legalMovesKey(
+    uint64_t stateHash, const std::optional<std::array<size_t, 3>>& Special,
+    bool sevenCall) {
+  uint64_t key = stateHash ^ (sevenCall ? 0x5EC0FFEEull : 0);
+  if (Special.has_value()) {
+    for (size_t value : Special.value()) {
+      uint64_t state = key ^ (value + 1);
+      key = Zobrist::splitmix64(state);
+    }
+  }
+  return key;
+}
+
+// Get legal moves (cached)
+std::shared_ptr<const std::vector<Move>> TranspositionTable::legalMoves(
+    const GameState& state, std::optional<std::array<size_t, 3>> Special,
+    bool sevenCall) {
+  uint64_t key = legalMovesKey(state.moveHash(), Special, sevenCall);
+  if (auto cached = findLegalMoves(key)) {
+    return cached;
+  }
+  MoveList moveList;
+  state.generateLegalMoves(moveList, Special, sevenCall);
+  auto moves = std::make_shared<const std::vector<Move>>(moveList.toVector());
+  storeLegalMoves(key, moves);
+  return moves;
+}
+
+// Get all legal plays (cached)
+std::shared_ptr<const std::vector<Move>> TranspositionTable::allLegalMoves(
+    const GameState& state) {
+  uint64_t key = legalMovesKey(state.moveHash()) ^ allMovesTag;
+  if (auto cached = findLegalMoves(key)) {
+    return cached;
+  }
+  auto moves =
+      std::make_shared<const std::vector<Move>>(state.computeAllLegalMoves());
+  storeLegalMoves(key, moves);
+  return moves;
+}
+
+// Find legal moves
+std::shared_ptr<const std::vector<Move>> TranspositionTable::findLegalMoves(
+    uint64_t key) {
+  size_t bucket = key & moveBucketMask;
+  std::lock_guard<std::mutex> lock(stripeFor(bucket));
+  for (size_t i = 2 * bucket; i < 2 * bucket + 2; ++i) {
+    MoveSlot& slot = moveSlots[i];
+    if (slot.moves && slot.key == key) {
+      slot.lastUse = ++useTick;
+      ++hitCount;
+      return slot.moves;
+    }
+  }
+  ++missCount;
+  return nullptr;
+}
+
+// Store legal moves
+void TranspositionTable::storeLegalMoves(
+    uint64_t key, std::shared_ptr<const std::vector<Move>> moves) {
+  size_t bucket = key & moveBucketMask;
+  std::lock_guard<std::mutex> lock(stripeFor(bucket));
+  MoveSlot* victim = &moveSlots[2 * bucket];
+  for (size_t i = 2 * bucket; i < 2 * bucket + 2; ++i) {
+    MoveSlot& slot = moveSlots[i];
+    if (!slot.moves || slot.key == key) {
+      victim = &slot;  // Prefer empty or same key slot
+      break;
+    }
+    if (slot.lastUse < victim->lastUse) {
+      victim = &slot;  // Otherwise least recently used
+    }
+  }
+  victim->key = key;
+  victim->moves = std::move(moves);
+  victim->lastUse = ++useTick;
+}
+
+// Probe evaluation
+std::optional<Evaluation> TranspositionTable::probe(uint64_t key) const {
+  size_t bucket = key & evalMask;
+  std::lock_guard<std::mutex> lock(stripeFor(bucket));
+  const EvalSlot& slot = evalSlots[bucket];
+  if (slot.used && slot.key == key) {
+    ++hitCount;
+    return slot.eval;
+  }
+  ++missCount;
+  return std::nullopt;
+}
+
+// Store evaluation
+void TranspositionTable::store(uint64_t key, const Evaluation& eval) {
+  size_t bucket = key & evalMask;
+  std::lock_guard<std::mutex> lock(stripeFor(bucket));
+  EvalSlot& slot = evalSlots[bucket];
+  uint32_t currentGeneration = generation.load();
+  bool replace = !slot.used || slot.key == key ||
+                 slot.generation != currentGeneration ||
+                 eval.depth >= slot.eval.depth;
+  if (replace) {
+    slot.key = key;
+    slot.eval = eval;
+    slot.generation = currentGeneration;
+    slot.used = true;
+  }
+}
+
+// New search generation
+void TranspositionTable::newGeneration() { ++generation; }
+
+// Clear all entries
+void TranspositionTable::clear() {
+  for (size_t s = 0; s < stripeCount; ++s) {
+    stripes[s].lock();
+  }
+  for (MoveSlot& slot : moveSlots) {
+    slot = MoveSlot();
+  }
+  for (EvalSlot& slot : evalSlots) {
+    slot = EvalSlot();
+  }
+  for (size_t s = stripeCount; s-- > 0;) {
+    stripes[s].unlock();
+  }
+  hitCount = 0;
+  missCount = 0;
+}
+
+// Capacities and statistics
+size_t TranspositionTable::moveCapacity() const { return moveSlots.size(); }
+
+size_t TranspositionTable::evalCapacity() const { return evalSlots.size(); }
+
+uint64_t TranspositionTable::hits() const { return hitCount.load(); }
+
+uint64_t TranspositionTable::misses() const { return missCount.load(); }
+
+// Stripe lookup
+std::mutex& TranspositionTable::stripeFor(size_t bucket) const {
+  return stripes[bucket % stripeCount];
+}
+
+}  // namespace BraendiDog
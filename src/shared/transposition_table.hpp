@@ -0,0 +1,188 @@
+/**
+ * @file transposition_table.hpp
+ * @brief Bounded, thread safe cache for legal moves and search evaluations.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "shared/game.hpp"
+#include "shared/game_types.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief Cached search evaluation of a position.
+ */
+struct Evaluation {
+  double value = 0.0;   ///< Score from the view of the player to move.
+  int depth = 0;        ///< Search depth (or effort) backing the value.
+  uint32_t visits = 0;  ///< Number of simulations backing the value.
+};
+
+/**
+ * @brief Transposition table keyed by GameState::moveHash() for legal moves
+ * and GameState::hash() for evaluations.
+ *
+ * Holds two fixed-size tables sharing a memory budget:
+ * - legal move lists in 2-way buckets with LRU replacement
+ * - search evaluations with depth-preferred replacement (entries of older
+ * generations are always replaced)
+ *
+ * Buckets are guarded by striped mutexes, so the table can be shared between
+ * search threads.
+ */
+class TranspositionTable {
+ public:
+  static constexpr size_t defaultMemory = 16 * 1024 * 1024;  ///< 16 MiB.
+
+  /**
+   * @brief Construct a table within the given memory budget.
+   * @param memoryBytes Approximate memory budget in bytes.
+   * @param numStripes Number of mutex stripes.
+   */
+  explicit TranspositionTable(size_t memoryBytes = defaultMemory,
+                              size_t numStripes = 64);
+
+  TranspositionTable(const TranspositionTable&) = delete;
+  TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+  /**
+   * @brief Build the cache key of a legal move computation.
+   * @param stateHash GameState::moveHash() of the position.
+   * @param Special Special argument passed to computeLegalMoves().
+   * @param sevenCall sevenCall argument passed to computeLegalMoves().
+   * @return 64-bit key.
+   */
+  static uint64_t legalMovesKey(
+      uint64_t stateHash,
+      const std::optional<std::array<size_t, 3>>& Special = std::nullopt,
+      bool sevenCall = false);
+
+  /**
+   * @brief Get the legal moves of a position, computing them on a miss.
+   * @param state Position to compute the moves for.
+   * @param Special Special argument passed to computeLegalMoves().
+   * @param sevenCall sevenCall argument passed to computeLegalMoves().
+   * @return Shared immutable list of legal moves.
+   */
+  std::shared_ptr<const std::vector<Move>> legalMoves(
+      const GameState& state,
+      std::optional<std::array<size_t, 3>> Special = std::nullopt,
+      bool sevenCall = false);
+
+  /**
+   * @brief Get all legal plays of a position, computing them on a miss.
+   * @param state Position to compute the moves for.
+   * @return Shared immutable result of GameState::computeAllLegalMoves().
+   */
+  std::shared_ptr<const std::vector<Move>> allLegalMoves(
+      const GameState& state);
+
+  /**
+   * @brief Look up cached legal moves.
+   * @param key Key built with legalMovesKey().
+   * @return Cached moves or nullptr on a miss.
+   */
+  std::shared_ptr<const std::vector<Move>> findLegalMoves(uint64_t key);
+
+  /**
+   * @brief Store legal moves, evicting the least recently used bucket entry.
+   * @param key Key built with legalMovesKey().
+   * @param moves Moves to cache.
+   */
+  void storeLegalMoves(uint64_t key,
+                       std::shared_ptr<const std::vector<Move>> moves);
+
+  /**
+   * @brief Look up a cached evaluation.
+   * @param key Position key (usually GameState::hash()).
+   * @return Cached evaluation, nullopt on a miss.
+   */
+  std::optional<Evaluation> probe(uint64_t key) const;
+
+  /**
+   * @brief Store an evaluation (depth-preferred replacement).
+   * @param key Position key (usually GameState::hash()).
+   * @param eval Evaluation to store.
+   */
+  void store(uint64_t key, const Evaluation& eval);
+
+  /**
+   * @brief Start a new search generation, older evaluations become
+   * replaceable regardless of depth.
+   */
+  void newGeneration();
+
+  /**
+   * @brief Remove all entries.
+   */
+  void clear();
+
+  /**
+   * @brief Get the number of legal move slots.
+   */
+  size_t moveCapacity() const;
+  /**
+   * @brief Get the number of evaluation slots.
+   */
+  size_t evalCapacity() const;
+  /**
+   * @brief Get the number of cache hits (moves and evaluations).
+   */
+  uint64_t hits() const;
+  /**
+   * @brief Get the number of cache misses (moves and evaluations).
+   */
+  uint64_t misses() const;
+
+ private:
+  /// Approximate heap size of a cached move list, used for the budget.
+  static constexpr size_t approxMoveListBytes = 2048;
+
+  /**
+   * @brief Slot holding cached legal moves.
+   */
+  struct MoveSlot {
+    uint64_t key = 0;
+    std::shared_ptr<const std::vector<Move>> moves;
+    uint64_t lastUse = 0;
+  };
+
+  /**
+   * @brief Slot holding a cached evaluation.
+   */
+  struct EvalSlot {
+    uint64_t key = 0;
+    Evaluation eval;
+    uint32_t generation = 0;
+    bool used = false;
+  };
+
+  /**
+   * @brief Get the mutex guarding a bucket.
+   */
+  std::mutex& stripeFor(size_t bucket) const;
+
+  std::vector<MoveSlot> moveSlots;  ///< 2 slots per bucket.
+  std::vector<EvalSlot> evalSlots;  ///< 1 slot per bucket.
+  size_t moveBucketMask;            ///< moveSlots.size() / 2 - 1.
+  size_t evalMask;                  ///< evalSlots.size() - 1.
+  std::unique_ptr<std::mutex[]> stripes;  ///< Striped bucket locks.
+  size_t stripeCount;                     ///< Number of stripes.
+
+  std::atomic<uint64_t> useTick{0};   ///< LRU clock.
+  std::atomic<uint32_t> generation{0};  ///< Current search generation.
+  mutable std::atomic<uint64_t> hitCount{0};   ///< Cache hits.
+  mutable std::atomic<uint64_t> missCount{0};  ///< Cache misses.
+};
+
+}  // namespace BraendiDog
@@ -0,0 +1,645 @@
+#include "shared/wire_format.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "shared/framing.hpp"
+
+namespace BraendiDog {
+
+namespace {
+// First byte of a binary payload (followed by the version)
+constexpr uint8_t binaryMarker = 0xB0;
+
+// Longest strings accepted (names, error messages)
+constexpr size_t maxStringSize = 4096;
+
+// Largest element count accepted for lists
+constexpr size_t maxListSize = 1024;
+
+uint8_t binaryHeader(WireFormat format) {
+  return binaryMarker + static_cast<uint8_t>(format);
+}
+
+// Optional values are sent as value + 1, 0 meaning none
+void writeOptional(BinaryWriter& writer, const std::optional<size_t>& value) {
+  writer.varint(value ? *value + 1 : 0);
+}
+
+std::optional<size_t> readOptional(BinaryReader& reader, size_t max) {
+  size_t value = reader.bounded(max + 1);
+  return value == 0 ? std::nullopt : std::optional<size_t>(value - 1);
+}
+
+void writeRankings(BinaryWriter& writer,
+                   const std::array<std::optional<int>, 4>& rankings) {
+  for (const auto& rank : rankings) {
+    writer.boolean(rank.has_value());
+    if (rank) {
+      writer.svarint(*rank);
+    }
+  }
+}
+
+std::array<std::optional<int>, 4> readRankings(BinaryReader& reader) {
+  std::array<std::optional<int>, 4> rankings;
+  for (auto& rank : rankings) {
+    if (reader.boolean()) {
+      rank = static_cast<int>(reader.svarint());
+    }
+  }
+  return rankings;
+}
+
+void writeMove(BinaryWriter& writer, const Move& move) {
+  writer.varint(move.cardID);
+  writer.varint(move.handIndex);
+  writer.varint(move.movements.size());
+  for (const auto& [marble, target] : move.movements) {
+    writer.u8(static_cast<uint8_t>(marble.playerID << 2 | marble.marbleIdx));
+    writer.position(target);
+  }
+}
+
+Move readMove(BinaryReader& reader) {
+  Move move;
+  move.cardID = reader.bounded(53);
+  move.handIndex = reader.bounded(5);
+  size_t count = reader.bounded(16);
+  move.movements.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    uint8_t marble = reader.u8();
+    MarbleIdentifier id(marble >> 2, marble & 3);  // Throws if out of range
+    move.movements.emplace_back(id, reader.position());
+  }
+  return move;
+}
+
+// Success flag and error message of a response
+void writeResult(BinaryWriter& writer, const ServerResponse& response) {
+  writer.boolean(response.getSuccess());
+  writer.string(response.getErrorMsg());
+}
+
+std::pair<bool, std::string> readResult(BinaryReader& reader) {
+  bool success = reader.boolean();
+  return {success, reader.string()};
+}
+
+void writeFields(BinaryWriter& writer, const Message& message) {
+  switch (message.getMessageType()) {
+    case MessageType::REQ_CONNECT: {
+      const auto& m = static_cast<const ConnectionRequestMessage&>(message);
+      writer.string(m.name);
+      writer.varint(m.wireFormat);
+      break;
+    }
+    case MessageType::REQ_READY:
+    case MessageType::REQ_START_GAME:
+    case MessageType::REQ_SKIP_TURN:
+      writer.varint(static_cast<const ClientRequest&>(message).getPlayerId());
+      break;
+    case MessageType::REQ_PLAY_CARD: {
+      const auto& m = static_cast<const PlayCardRequestMessage&>(message);
+      writer.varint(m.getPlayerId());
+      writeMove(writer, m.move);
+      break;
+    }
+
+    case MessageType::RESP_CONNECT: {
+      const auto& m = static_cast<const ConnectionResponseMessage&>(message);
+      writeResult(writer, m);
+      writer.varint(m.playerId);
+      writer.varint(m.wireFormat);
+      break;
+    }
+    case MessageType::RESP_READY:
+    case MessageType::RESP_START_GAME:
+    case MessageType::RESP_SKIP_TURN:
+      writeResult(writer, static_cast<const ServerResponse&>(message));
+      break;
+    case MessageType::RESP_PLAY_CARD: {
+      const auto& m = static_cast<const PlayCardResponseMessage&>(message);
+      writeResult(writer, m);
+      writer.varint(m.handIndex);
+      break;
+    }
+
+    case MessageType::BRDC_PLAYER_LIST: {
+      const auto& m = static_cast<const PlayerListUpdateMessage&>(message);
+      writer.varint(m.playersList.size());
+      for (const auto& player : m.playersList) {
+        writer.varint(player.id);
+        writer.string(player.name);
+        writer.boolean(player.ready);
+      }
+      break;
+    }
+    case MessageType::BRDC_GAME_START:
+      writer.varint(static_cast<const GameStartMessage&>(message).numPlayers);
+      break;
+    case MessageType::BRDC_GAMESTATE_UPDATE: {
+      const auto& m = static_cast<const GameStateUpdateMessage&>(message);
+      writeBinary(writer, m.gameState);
+      writer.varint(m.sequence);
+      break;
+    }
+    case MessageType::BRDC_PLAYER_DISCONNECTED:
+      writer.varint(
+          static_cast<const PlayerDisconnectedMessage&>(message).playerId);
+      break;
+    case MessageType::BRDC_PLAYER_FINISHED:
+      writer.varint(
+          static_cast<const PlayerFinishedMessage&>(message).playerId);
+      break;
+    case MessageType::BRDC_RESULTS:
+      writeRankings(writer,
+                    static_cast<const GameResultsMessage&>(message).rankings);
+      break;
+
+    case MessageType::PRIV_CARDS_DEALT: {
+      const auto& m = static_cast<const CardsDealtMessage&>(message);
+      writer.varint(m.getPlayerId());
+      writer.varint(m.cards.size());
+      for (size_t card : m.cards) {
+        writer.varint(card);
+      }
+      break;
+    }
+
+    case MessageType::REQ_LIST_ROOMS:
+      writer.boolean(
+          static_cast<const ListRoomsRequestMessage&>(message).openOnly);
+      break;
+    case MessageType::REQ_CREATE_ROOM: {
+      const auto& m = static_cast<const CreateRoomRequestMessage&>(message);
+      writer.string(m.name);
+      writer.string(m.roomName);
+      writer.varint(m.wireFormat);
+      break;
+    }
+    case MessageType::REQ_JOIN_ROOM: {
+      const auto& m = static_cast<const JoinRoomRequestMessage&>(message);
+      writer.string(m.name);
+      writer.varint(m.roomId);
+      writer.varint(m.wireFormat);
+      break;
+    }
+    case MessageType::RESP_LIST_ROOMS: {
+      const auto& m = static_cast<const ListRoomsResponseMessage&>(message);
+      writeResult(writer, m);
+      writer.varint(m.rooms.size());
+      for (const auto& room : m.rooms) {
+        writer.varint(room.id);
+        writer.string(room.name);
+        writer.varint(room.players);
+        writer.boolean(room.inGame);
+      }
+      break;
+    }
+    case MessageType::RESP_CREATE_ROOM: {
+      const auto& m = static_cast<const CreateRoomResponseMessage&>(message);
+      writeResult(writer, m);
+      writer.varint(m.roomId);
+      writer.varint(m.playerId);
+      writer.varint(m.wireFormat);
+      break;
+    }
+    case MessageType::RESP_JOIN_ROOM: {
+      const auto& m = static_cast<const JoinRoomResponseMessage&>(message);
+      writeResult(writer, m);
+      writer.varint(m.roomId);
+      writer.varint(m.playerId);
+      writer.varint(m.wireFormat);
+      break;
+    }
+
+    case MessageType::BRDC_GAMESTATE_DELTA: {
+      const auto& m = static_cast<const GameStateDeltaMessage&>(message);
+      writer.varint(m.sequence);
+      writeBinary(writer, m.delta);
+      break;
+    }
+    case MessageType::REQ_GAMESTATE:
+      writer.varint(static_cast<const ClientRequest&>(message).getPlayerId());
+      break;
+  }
+}
+
+std::unique_ptr<Message> readFields(BinaryReader& reader, MessageType type) {
+  switch (type) {
+    case MessageType::REQ_CONNECT: {
+      std::string name = reader.string();
+      return std::make_unique<ConnectionRequestMessage>(std::move(name),
+                                                        reader.varint());
+    }
+    case MessageType::REQ_READY:
+      return std::make_unique<ReadyMessage>(reader.varint());
+    case MessageType::REQ_START_GAME:
+      return std::make_unique<StartGameRequestMessage>(reader.varint());
+    case MessageType::REQ_SKIP_TURN:
+      return std::make_unique<SkipTurnRequestMessage>(reader.varint());
+    case MessageType::REQ_PLAY_CARD: {
+      size_t playerId = reader.varint();
+      Move move = readMove(reader);
+      return std::make_unique<PlayCardRequestMessage>(playerId, move);
+    }
+
+    case MessageType::RESP_CONNECT: {
+      auto [success, error] = readResult(reader);
+      size_t playerId = reader.varint();
+      return std::make_unique<ConnectionResponseMessage>(
+          success, std::move(error), playerId, reader.varint());
+    }
+    case MessageType::RESP_READY: {
+      auto [success, error] = readResult(reader);
+      return std::make_unique<ReadyResponseMessage>(success, std::move(error));
+    }
+    case MessageType::RESP_START_GAME: {
+      auto [success, error] = readResult(reader);
+      return std::make_unique<StartGameResponseMessage>(success,
+                                                        std::move(error));
+    }
+    case MessageType::RESP_SKIP_TURN: {
+      auto [success, error] = readResult(reader);
+      return std::make_unique<SkipTurnResponseMessage>(success,
+                                                       std::move(error));
+    }
+    case MessageType::RESP_PLAY_CARD: {
+      auto [success, error] = readResult(reader);
+      return std::make_unique<PlayCardResponseMessage>(reader.varint(), success,
+                                                       std::move(error));
+    }
+
+    case MessageType::BRDC_PLAYER_LIST: {
+      std::vector<PlayerInfo> players(reader.bounded(maxListSize));
+      for (auto& player : players) {
+        player.id = reader.varint();
+        player.name = reader.string();
+        player.ready = reader.boolean();
+      }
+      return std::make_unique<PlayerListUpdateMessage>(std::move(players));
+    }
+    case MessageType::BRDC_GAME_START:
+      return std::make_unique<GameStartMessage>(reader.bounded(4));
+    case MessageType::BRDC_GAMESTATE_UPDATE: {
+      auto message = std::make_unique<GameStateUpdateMessage>();
+      readBinary(reader, message->gameState);
+      message->sequence = reader.varint();
+      return message;
+    }
+    case MessageType::BRDC_PLAYER_DISCONNECTED:
+      return std::make_unique<PlayerDisconnectedMessage>(reader.varint());
+    case MessageType::BRDC_PLAYER_FINISHED:
+      return std::make_unique<PlayerFinishedMessage>(reader.varint());
+    case MessageType::BRDC_RESULTS:
+      return std::make_unique<GameResultsMessage>(readRankings(reader));
+
+    case MessageType::PRIV_CARDS_DEALT: {
+      size_t playerId = reader.varint();
+      std::vector<size_t> cards(reader.bounded(maxListSize));
+      for (auto& card : cards) {
+        card = reader.varint();
+      }
+      return std::make_unique<CardsDealtMessage>(playerId, std::move(cards));
+    }
+
+    case MessageType::REQ_LIST_ROOMS:
+      return std::make_unique<ListRoomsRequestMessage>(reader.boolean());
+    case MessageType::REQ_CREATE_ROOM: {
+      std::string name = reader.string();
+      std::string roomName = reader.string();
+      return std::make_unique<CreateRoomRequestMessage>(
+          std::move(name), std::move(roomName), reader.varint());
+    }
+    case MessageType::REQ_JOIN_ROOM: {
+      std::string name = reader.string();
+      size_t roomId = reader.varint();
+      return std::make_unique<JoinRoomRequestMessage>(std::move(name), roomId,
+                                                      reader.varint());
+    }
+    case MessageType::RESP_LIST_ROOMS: {
+      readResult(reader);  // Room lists always succeed
+      std::vector<RoomInfo> rooms(reader.bounded(maxListSize));
+      for (auto& room : rooms) {
+        room.id = reader.varint();
+        room.name = reader.string();
+        room.players = reader.varint();
+        room.inGame = reader.boolean();
+      }
+      return std::make_unique<ListRoomsResponseMessage>(std::move(rooms));
+    }
+    case MessageType::RESP_CREATE_ROOM: {
+      auto [success, error] = readResult(reader);
+      size_t roomId = reader.varint();
+      size_t playerId = reader.varint();
+      return std::make_unique<CreateRoomResponseMessage>(
+          success, std::move(error), roomId, playerId, reader.varint());
+    }
+    case MessageType::RESP_JOIN_ROOM: {
+      auto [success, error] = readResult(reader);
+      size_t roomId = reader.varint();
+      size_t playerId = reader.varint();
+      return std::make_unique<JoinRoomResponseMessage>(
+          success, std::move(error), roomId, playerId, reader.varint());
+    }
+
+    case MessageType::BRDC_GAMESTATE_DELTA: {
+      auto message = std::make_unique<GameStateDeltaMessage>();
+      message->sequence = reader.varint();
+      readBinary(reader, message->delta);
+      return message;
+    }
+    case MessageType::REQ_GAMESTATE:
+      return std::make_unique<GameStateRequestMessage>(reader.varint());
+  }
+  throw WireError("Unknown message type " +
+                  std::to_string(static_cast<int>(type)));
+}
+}  // namespace
+
+WireFormat negotiateWireFormat(size_t offered) {
+  return static_cast<WireFormat>(
+      std::min<size_t>(offered, static_cast<size_t>(latestWireFormat)));
+}
+
+// BinaryWriter
+
+void BinaryWriter::u8(uint8_t value) {
+  out_.push_back(static_cast<char>(value));
+}
+
+void BinaryWriter::u16(uint16_t value) {
+  u8(static_cast<uint8_t>(value >> 8));
+  u8(static_cast<uint8_t>(value));
+}
+
+void BinaryWriter::varint(uint64_t value) {
+  while (value >= 0x80) {
+    u8(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  u8(static_cast<uint8_t>(value));
+}
+
+void BinaryWriter::svarint(int64_t value) {
+  varint((static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63));
+}
+
+void BinaryWriter::boolean(bool value) { u8(value ? 1 : 0); }
+
+void BinaryWriter::string(std::string_view value) {
+  varint(value.size());
+  out_.append(value);
+}
+
+// Location in the top byte, owner and index in the bottom one
+void BinaryWriter::position(const Position& position) {
+  u16(static_cast<uint16_t>(static_cast<unsigned>(position.boardLocation) << 8 |
+                            position.playerID << 6 | position.index));
+}
+
+// BinaryReader
+
+uint8_t BinaryReader::u8() {
+  if (pos_ >= in_.size()) {
+    throw WireError("Message ends early");
+  }
+  return static_cast<uint8_t>(in_[pos_++]);
+}
+
+uint16_t BinaryReader::u16() {
+  uint16_t high = u8();
+  return static_cast<uint16_t>(high << 8 | u8());
+}
+
+uint64_t BinaryReader::varint() {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t byte = u8();
+    value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  throw WireError("Varint too long");
+}
+
+int64_t BinaryReader::svarint() {
+  uint64_t value = varint();
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+bool BinaryReader::boolean() { return u8() != 0; }
+
+std::string BinaryReader::string() {
+  size_t size = bounded(maxStringSize);
+  if (in_.size() - pos_ < size) {
+    throw WireError("Message ends early");
+  }
+  std::string value(in_.substr(pos_, size));
+  pos_ += size;
+  return value;
+}
+
+Position BinaryReader::position() {
+  uint16_t packed = u16();
+  size_t location = packed >> 8;
+  if (location > static_cast<size_t>(BoardLocation::FINISH)) {
+    throw WireError("Invalid board location");
+  }
+  // The constructor checks the index range
+  return Position(static_cast<BoardLocation>(location), packed & 0x3F,
+                  packed >> 6 & 3);
+}
+
+size_t BinaryReader::bounded(size_t max) {
+  uint64_t value = varint();
+  if (value > max) {
+    throw WireError("Value " + std::to_string(value) + " exceeds " +
+                    std::to_string(max));
+  }
+  return static_cast<size_t>(value);
+}
+
+// Game objects
+
+void writeBinary(BinaryWriter& writer, const Player& player) {
+  writer.u8(static_cast<uint8_t>(player.getId()));
+  writer.string(player.getName());
+  writer.u8(static_cast<uint8_t>(player.getStartField()));
+  writeOptional(writer, player.getStartBlocked());
+  writer.u8(static_cast<uint8_t>(player.isActiveInRound() |
+                                 player.isActiveInGame() << 1));
+  for (const Position& marble : player.getMarbles()) {
+    writer.position(marble);
+  }
+}
+
+void readBinary(BinaryReader& reader, Player& player) {
+  player.id = reader.u8();
+  player.name = reader.string();
+  player.startField = reader.u8();
+  player.startBlocked = readOptional(reader, 3);
+  uint8_t flags = reader.u8();
+  player.activeInRound = flags & 1;
+  player.activeInGame = flags & 2;
+  for (Position& marble : player.marbles) {
+    marble = reader.position();
+  }
+}
+
+void writeBinary(BinaryWriter& writer, const GameState& gs) {
+  // One byte per card, the rank in the high bits
+  for (const Card& card : gs.getDeck()) {
+    writer.u8(static_cast<uint8_t>(static_cast<unsigned>(card.getRank()) << 3 |
+                                   static_cast<unsigned>(card.getSuit())));
+  }
+  uint8_t present = 0;
+  for (size_t i = 0; i < 4; ++i) {
+    present |= gs.getPlayers()[i].has_value() << i;
+  }
+  writer.u8(present);
+  for (const auto& player : gs.getPlayers()) {
+    if (player) {
+      writeBinary(writer, *player);
+    }
+  }
+  writer.u8(static_cast<uint8_t>(gs.getCurrentPlayer()));
+  writer.u8(static_cast<uint8_t>(gs.getRoundStartPlayer()));
+  writer.u8(static_cast<uint8_t>(gs.getRoundCardCount()));
+  writeOptional(writer, gs.getLastPlayedCard());
+  writeRankings(writer, gs.getLeaderBoard());
+}
+
+void readBinary(BinaryReader& reader, GameState& gs) {
+  for (Card& card : gs.deck) {
+    uint8_t packed = reader.u8();
+    if ((packed >> 3) > static_cast<uint8_t>(Rank::JOKER) ||
+        (packed & 7) > static_cast<uint8_t>(Suit::JOKER)) {
+      throw WireError("Invalid card");
+    }
+    card = Card(static_cast<Rank>(packed >> 3), static_cast<Suit>(packed & 7));
+  }
+  uint8_t present = reader.u8();
+  for (size_t i = 0; i < 4; ++i) {
+    gs.players[i].reset();
+    if (present & (1 << i)) {
+      readBinary(reader, gs.players[i].emplace());
+    }
+  }
+  gs.currentPlayer = reader.u8();
+  gs.roundStartPlayer = reader.u8();
+  gs.roundCardCount = reader.u8();
+  gs.lastPlayedCard = readOptional(reader, 53);
+  gs.leaderBoard = readRankings(reader);
+  gs.derivedStale = true;
+}
+
+void writeBinary(BinaryWriter& writer, const GameStateDelta& delta) {
+  writer.varint(delta.marbles.size());
+  for (const auto& marble : delta.marbles) {
+    writer.u8(static_cast<uint8_t>(marble.playerID << 2 | marble.marbleIdx));
+    writer.position(marble.pos);
+  }
+  // Player ID in the low bits, the activity flags above
+  writer.varint(delta.players.size());
+  for (const auto& player : delta.players) {
+    writer.u8(static_cast<uint8_t>(player.playerID | player.activeInRound << 2 |
+                                   player.activeInGame << 3));
+    writeOptional(writer, player.startBlocked);
+  }
+  writer.u8(static_cast<uint8_t>(delta.currentPlayer));
+  writer.u8(static_cast<uint8_t>(delta.roundStartPlayer));
+  writer.u8(static_cast<uint8_t>(delta.roundCardCount));
+  writeOptional(writer, delta.lastPlayedCard);
+  writer.boolean(delta.leaderBoard.has_value());
+  if (delta.leaderBoard) {
+    writeRankings(writer, *delta.leaderBoard);
+  }
+}
+
+void readBinary(BinaryReader& reader, GameStateDelta& delta) {
+  delta.marbles.resize(reader.bounded(16));
+  for (auto& marble : delta.marbles) {
+    uint8_t packed = reader.u8();
+    marble.playerID = packed >> 2 & 3;
+    marble.marbleIdx = packed & 3;
+    marble.pos = reader.position();
+  }
+  delta.players.resize(reader.bounded(4));
+  for (auto& player : delta.players) {
+    uint8_t packed = reader.u8();
+    player.playerID = packed & 3;
+    player.activeInRound = packed & 4;
+    player.activeInGame = packed & 8;
+    player.startBlocked = readOptional(reader, 3);
+  }
+  delta.currentPlayer = reader.u8();
+  delta.roundStartPlayer = reader.u8();
+  delta.roundCardCount = reader.u8();
+  delta.lastPlayedCard = readOptional(reader, 53);
+  delta.leaderBoard.reset();
+  if (reader.boolean()) {
+    delta.leaderBoard = readRankings(reader);
+  }
+}
+
+// Messages
+
+void appendMessage(std::string& out, const Message& message,
+                   WireFormat format) {
+  if (format == WireFormat::JSON) {
+    out += message.toJson().dump();
+    return;
+  }
+  BinaryWriter writer(out);
+  writer.u8(binaryHeader(format));
+  writer.u8(static_cast<uint8_t>(message.getMessageType()));
+  writeFields(writer, message);
+}
+
+std::string encodeMessage(const Message& message, WireFormat format) {
+  std::string out;
+  appendMessage(out, message, format);
+  return out;
+}
+
+std::string encodeMessageFrame(const Message& message, WireFormat format) {
+  // Encode behind the header, no copy of the payload
+  std::string frame(frameHeaderSize, '\0');
+  appendMessage(frame, message, format);
+  finishFrame(frame);
+  return frame;
+}
+
+std::unique_ptr<Message> decodeMessage(std::string_view payload) {
+  if (payload.empty()) {
+    throw WireError("Empty message");
+  }
+  auto first = static_cast<uint8_t>(payload.front());
+  if (first == binaryHeader(WireFormat::BINARY_V1)) {
+    BinaryReader reader(payload.substr(1));
+    uint8_t type = reader.u8();
+    if (type > static_cast<uint8_t>(MessageType::REQ_GAMESTATE)) {
+      throw WireError("Unknown message type " + std::to_string(type));
+    }
+    auto message = readFields(reader, static_cast<MessageType>(type));
+    if (!reader.done()) {
+      throw WireError("Trailing bytes after " +
+                      messageTypeToString(message->getMessageType()));
+    }
+    return message;
+  }
+  if ((first & 0xF0) == binaryMarker) {
+    throw WireError("Unsupported binary version " +
+                    std::to_string(first - binaryMarker));
+  }
+  return Message::fromJson(nlohmann::json::parse(payload));
+}
+
+}  // namespace BraendiDog
@@ -0,0 +1,154 @@
+/**
+ * @file wire_format.hpp
+ * @brief Encodings of messages inside a frame: JSON text or compact binary.
+ *
+ * Clients offer the newest format they understand in REQ_CONNECT (or
+ * REQ_CREATE_ROOM / REQ_JOIN_ROOM) and the server answers with the format it
+ * picked; from that response on, both sides send in it. Decoding looks at the
+ * first byte of the payload, so JSON is always understood, e.g. when debugging
+ * with a hand-written request.
+ *
+ * Binary payloads start with 0xB0 + version, followed by the MessageType as
+ * one byte and the fields of the message in declaration order: integers as
+ * LEB128 varints (zigzag for signed), strings as length and bytes, positions
+ * packed into two bytes.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "shared/game.hpp"
+#include "shared/game_objects.hpp"
+#include "shared/game_types.hpp"
+#include "shared/messages.hpp"
+
+namespace BraendiDog {
+
+/**
+ * @brief Encodings of a message, numbered by protocol version.
+ */
+enum class WireFormat : uint8_t {
+  JSON = 0,       ///< JSON text, as produced by Message::toJson().
+  BINARY_V1 = 1,  ///< Compact binary encoding, version 1.
+};
+
+/// Newest format this build speaks.
+constexpr WireFormat latestWireFormat = WireFormat::BINARY_V1;
+
+/// Number of formats this build speaks.
+constexpr size_t wireFormatCount = static_cast<size_t>(latestWireFormat) + 1;
+
+/**
+ * @brief Picks the format to use with a peer.
+ * @param offered Newest version the peer offered, 0 for JSON only.
+ */
+WireFormat negotiateWireFormat(size_t offered);
+
+/**
+ * @brief Thrown for payloads that are no valid message.
+ */
+class WireError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Appends binary fields to a buffer.
+ */
+class BinaryWriter {
+ public:
+  explicit BinaryWriter(std::string& out) : out_(out) {}
+
+  void u8(uint8_t value);
+  void u16(uint16_t value);
+  void varint(uint64_t value);
+  void svarint(int64_t value);
+  void boolean(bool value);
+  void string(std::string_view value);
+  void position(const Position& position);
+
+ private:
+  std::string& out_;
+};
+
+/**
+ * @brief Reads binary fields from a payload.
+ *
+ * Every read throws WireError if the payload ends early or a value is out of
+ * range.
+ */
+class BinaryReader {
+ public:
+  explicit BinaryReader(std::string_view in) : in_(in) {}
+
+  uint8_t u8();
+  uint16_t u16();
+  uint64_t varint();
+  int64_t svarint();
+  bool boolean();
+  std::string string();
+  Position position();
+
+  /**
+   * @brief Reads a varint that has to be at most max.
+   */
+  size_t bounded(size_t max);
+
+  /**
+   * @brief Checks that the whole payload was read.
+   */
+  bool done() const { return pos_ == in_.size(); }
+
+ private:
+  std::string_view in_;
+  size_t pos_ = 0;
+};
+
+/**
+ * @brief Binary encoding of a player (hands are sent in PRIV_CARDS_DEALT).
+ */
+void writeBinary(BinaryWriter& writer, const Player& player);
+void readBinary(BinaryReader& reader, Player& player);
+
+/**
+ * @brief Binary encoding of a game state without its deal generator.
+ */
+void writeBinary(BinaryWriter& writer, const GameState& gs);
+void readBinary(BinaryReader& reader, GameState& gs);
+
+/**
+ * @brief Binary encoding of the changes between two game states.
+ */
+void writeBinary(BinaryWriter& writer, const GameStateDelta& delta);
+void readBinary(BinaryReader& reader, GameStateDelta& delta);
+
+/**
+ * @brief Appends the payload of a message in the given format.
+ */
+void appendMessage(std::string& out, const Message& message,
+                   WireFormat format);
+
+/**
+ * @brief Encodes the payload of a message in the given format.
+ */
+std::string encodeMessage(const Message& message, WireFormat format);
+
+/**
+ * @brief Encodes a message as a complete frame (header and payload).
+ * @throws FramingError if the payload exceeds maxFrameSize.
+ */
+std::string encodeMessageFrame(const Message& message, WireFormat format);
+
+/**
+ * @brief Decodes a payload in any known format.
+ * @throws WireError or nlohmann::json::exception for malformed payloads.
+ */
+std::unique_ptr<Message> decodeMessage(std::string_view payload);
+
+}  // namespace BraendiDog
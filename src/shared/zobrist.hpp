@@ -0,0 +1,110 @@
+/**
+ * @file zobrist.hpp
+ * @brief Zobrist keys for hashing BraendiDog game states.
+ *
+ * The keys are generated at compile time with splitmix64 from a fixed seed, so
+ * server, clients and tools all agree on the hash of a state.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "shared/game_types.hpp"
+
+namespace BraendiDog {
+namespace Zobrist {
+
+constexpr size_t positionSlots = 72;  ///< 4 home + 64 track + 4 finish.
+constexpr size_t handSlots = 6;       ///< Maximum cards in a hand.
+constexpr size_t cardCount = 54;      ///< Cards in the deck.
+
+/**
+ * @brief Table of all Zobrist keys.
+ */
+struct Keys {
+  std::array<uint64_t, 4 * 4 * positionSlots> marble{};    ///< [p][m][slot]
+  std::array<uint64_t, 4 * 4> startBlocked{};              ///< [p][marble]
+  std::array<uint64_t, 4> currentPlayer{};                 ///< [p]
+  std::array<uint64_t, 7> roundCardCount{};                ///< [count]
+  std::array<uint64_t, 4 * handSlots * cardCount> hand{};  ///< [p][slot][card]
+};
+
+/**
+ * @brief splitmix64 step used to fill the key table.
+ * @param state Generator state, advanced by the call.
+ * @return Next pseudo random 64-bit value.
+ */
+constexpr uint64_t splitmix64(uint64_t& state) {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/**
+ * @brief Generate the key table.
+ */
+constexpr Keys makeKeys() {
+  Keys keys;
+  uint64_t state = 0xB4A3D1D09ull;
+  for (auto& key : keys.marble) key = splitmix64(state);
+  for (auto& key : keys.startBlocked) key = splitmix64(state);
+  for (auto& key : keys.currentPlayer) key = splitmix64(state);
+  for (auto& key : keys.roundCardCount) key = splitmix64(state);
+  for (auto& key : keys.hand) key = splitmix64(state);
+  return keys;
+}
+
+inline constexpr Keys keyTable = makeKeys();  ///< Compile time key table.
+
+/**
+ * @brief Key of a marble standing on a position.
+ * @param pID Player ID owning the marble.
+ * @param mIdx Index of the marble.
+ * @param pos Position of the marble (HOME/FINISH always belong to the owner).
+ */
+inline uint64_t marbleKey(size_t pID, size_t mIdx, const Position& pos) {
+  size_t slot = pos.index;
+  if (pos.boardLocation == BoardLocation::TRACK) {
+    slot += 4;
+  } else if (pos.boardLocation == BoardLocation::FINISH) {
+    slot += 68;
+  }
+  return keyTable.marble[(pID * 4 + mIdx) * positionSlots + slot];
+}
+
+/**
+ * @brief Key of a player's start being blocked by one of its marbles.
+ */
+inline uint64_t startBlockedKey(size_t pID, size_t mIdx) {
+  return keyTable.startBlocked[pID * 4 + mIdx];
+}
+
+/**
+ * @brief Key of the current player.
+ */
+inline uint64_t currentPlayerKey(size_t pID) {
+  return keyTable.currentPlayer[pID];
+}
+
+/**
+ * @brief Key of the round card count (2-6).
+ */
+inline uint64_t roundCardCountKey(size_t count) {
+  return keyTable.roundCardCount[count % 7];
+}
+
+/**
+ * @brief Key of a card at a given slot of a player's hand.
+ * @note Hand order is hashed since moves reference cards by hand index.
+ */
+inline uint64_t handKey(size_t pID, size_t slot, size_t cardID) {
+  return keyTable
+      .hand[(pID * handSlots + slot % handSlots) * cardCount + cardID];
+}
+
+}  // namespace Zobrist
+}  // namespace BraendiDog
@@ -0,0 +1,661 @@
+/**
+ * @file loadgen.cpp
+ * @brief Load generator driving many simulated clients against a Server.
+ *
+ * Every simulated client speaks the regular client protocol: it connects,
+ * gets ready in the lobby, requests the start once its table is full and
+ * plays random legal moves until the results arrive. Clients are spread over
+ * a few threads that each poll all of their non-blocking sockets, so
+ * thousands of connections need no thread per client and a slow server never
+ * stalls a whole worker on a connect or write.
+ *
+ * Usage: loadgen [--host ADDRESS] [--port PORT] [--clients N] [--players N]
+ *                [--rate R] [--threads N] [--think-ms MS] [--duration S]
+ *                [--seed S] [--json]
+ */
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sockpp/inet_address.h>
+#include <sockpp/tcp_socket.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "shared/framing.hpp"
+#include "shared/logging.hpp"
+#include "shared/messages.hpp"
+#include "shared/player_view.hpp"
+#include "shared/rng.hpp"
+#include "shared/wire_format.hpp"
+#include "shared/zobrist.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// A server that went away must not kill the load generator with SIGPIPE
+#if defined(MSG_NOSIGNAL)
+constexpr int sendFlags = MSG_NOSIGNAL;
+#else
+constexpr int sendFlags = 0;
+#endif
+
+struct Options {
+  std::string host = "127.0.0.1";
+  int port = 12345;
+  size_t clients = 4;
+  size_t players = 4;  // Clients per table before the start is requested
+  double rate = 100.0;  // Connects per second, 0 = all at once
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  std::chrono::milliseconds think{0};
+  std::chrono::seconds duration{60};
+  uint64_t seed = 1;
+  bool json = false;  // Offer only JSON instead of the binary format
+  sockpp::inet_address address;  // Resolved host and port
+};
+
+// Counters and latency samples of one worker
+struct Stats {
+  size_t connected = 0;
+  size_t connectFailures = 0;  // TCP connect failed
+  size_t rejected = 0;         // Closed or refused before RESP_CONNECT
+  size_t disconnects = 0;      // Closed by the server before the results
+  size_t parseErrors = 0;
+  size_t sendErrors = 0;
+  size_t turns = 0;
+  size_t rejectedTurns = 0;
+  size_t games = 0;  // Results received (per client)
+  size_t unfinished = 0;  // Still in the lobby or a game at the deadline
+  size_t resyncs = 0;     // Full game states requested after a bad delta
+  size_t messagesIn = 0;
+  size_t messagesOut = 0;
+  size_t bytesIn = 0;
+  size_t bytesOut = 0;
+  std::vector<double> connectMs;  // Connect until RESP_CONNECT
+  std::vector<double> turnMs;     // Turn request until its response
+
+  size_t errors() const {
+    return connectFailures + disconnects + parseErrors + sendErrors;
+  }
+
+  void merge(const Stats& other) {
+    connected += other.connected;
+    connectFailures += other.connectFailures;
+    rejected += other.rejected;
+    disconnects += other.disconnects;
+    parseErrors += other.parseErrors;
+    sendErrors += other.sendErrors;
+    turns += other.turns;
+    rejectedTurns += other.rejectedTurns;
+    games += other.games;
+    unfinished += other.unfinished;
+    resyncs += other.resyncs;
+    messagesIn += other.messagesIn;
+    messagesOut += other.messagesOut;
+    bytesIn += other.bytesIn;
+    bytesOut += other.bytesOut;
+    connectMs.insert(connectMs.end(), other.connectMs.begin(),
+                     other.connectMs.end());
+    turnMs.insert(turnMs.end(), other.turnMs.begin(), other.turnMs.end());
+  }
+};
+
+enum class Phase { WAITING, CONNECTING, LOBBY, GAME, DONE };
+
+// One simulated client
+struct SimClient {
+  size_t index = 0;
+  Phase phase = Phase::WAITING;
+  sockpp::tcp_socket connection;      // Non-blocking
+  bool handshaking = false;           // TCP connect still in progress
+  std::string outbox;                 // Encoded frames not yet written
+  BraendiDog::FrameBuffer inbox;      // Bytes of an incomplete frame
+  BraendiDog::WireFormat format = BraendiDog::WireFormat::JSON;
+  Clock::time_point connectAt;        // Scheduled connect
+  Clock::time_point sentAt;           // Connect or turn request
+  std::optional<Clock::time_point> actAt;  // Scheduled turn
+  std::optional<BraendiDog::PlayerView> view;
+  BraendiDog::Xoshiro256 rng;
+  bool readySent = false;
+  bool startSent = false;
+  bool awaitingUpdate = false;  // Turn sent, waiting for the new state
+  bool resyncing = false;       // Full game state requested
+  size_t rejections = 0;        // Rejected turns in a row
+};
+
+double elapsedMs(Clock::time_point since) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - since)
+      .count();
+}
+
+/**
+ * @brief Drives the clients of one thread with a single poll loop.
+ */
+class Worker {
+ public:
+  Worker(const Options& options, Clock::time_point deadline)
+      : options(options), deadline(deadline) {}
+
+  void add(std::unique_ptr<SimClient> client) {
+    clients.push_back(std::move(client));
+  }
+
+  void run() {
+    std::vector<pollfd> fds;
+    std::vector<SimClient*> polled;
+    while (true) {
+      Clock::time_point now = Clock::now();
+      if (options.duration.count() > 0 && now >= deadline) {
+        for (auto& client : clients) {
+          if (client->phase == Phase::LOBBY || client->phase == Phase::GAME) {
+            ++stats.unfinished;
+          }
+          close(*client);
+        }
+        return;
+      }
+
+      // Due connects and turns, and the next time something is due
+      Clock::time_point wake = now + std::chrono::milliseconds(50);
+      fds.clear();
+      polled.clear();
+      bool pending = false;
+      for (auto& client : clients) {
+        if (client->phase == Phase::WAITING) {
+          if (client->connectAt <= now) {
+            connect(*client);
+          } else {
+            wake = std::min(wake, client->connectAt);
+          }
+        }
+        if (client->actAt.has_value()) {
+          if (client->actAt.value() <= now) {
+            act(*client);
+          } else {
+            wake = std::min(wake, client->actAt.value());
+          }
+        }
+        if (client->phase == Phase::WAITING) {
+          pending = true;
+        } else if (client->phase != Phase::DONE) {
+          pending = true;
+          // Writable once connected, or once the outbox can move on
+          short events = client->handshaking ? POLLOUT : POLLIN;
+          if (!client->outbox.empty()) {
+            events |= POLLOUT;
+          }
+          fds.push_back({client->connection.handle(), events, 0});
+          polled.push_back(client.get());
+        }
+      }
+      if (!pending) {
+        return;
+      }
+
+      auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+          wake - Clock::now());
+      int ready =
+          ::poll(fds.data(), fds.size(),
+                 static_cast<int>(std::max<int64_t>(0, timeout.count())));
+      if (ready <= 0) {
+        continue;
+      }
+      for (size_t i = 0; i < fds.size(); ++i) {
+        SimClient& client = *polled[i];
+        if (fds[i].revents == 0 || client.phase == Phase::DONE) {
+          continue;
+        }
+        if (client.handshaking) {
+          connected(client);
+        } else if (fds[i].revents & POLLOUT) {
+          flush(client);
+        }
+        if (client.phase != Phase::DONE && !client.handshaking &&
+            (fds[i].revents & ~POLLOUT) != 0) {
+          receive(client);
+        }
+      }
+    }
+  }
+
+  const Stats& getStats() const { return stats; }
+
+ private:
+  const Options& options;
+  Clock::time_point deadline;
+  std::vector<std::unique_ptr<SimClient>> clients;
+  Stats stats;
+
+  // Start a non-blocking connect, the request waits in the outbox
+  void connect(SimClient& client) {
+    client.sentAt = Clock::now();
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      ++stats.connectFailures;
+      client.phase = Phase::DONE;
+      return;
+    }
+    client.connection = sockpp::tcp_socket(fd);
+    client.connection.set_non_blocking(true);
+    // Requests are single small frames, do not hold them back
+    int noDelay = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    const sockpp::inet_address& address = options.address;
+    if (::connect(fd, address.sockaddr_ptr(), address.size()) < 0 &&
+        errno != EINPROGRESS) {
+      ++stats.connectFailures;
+      return close(client);
+    }
+    client.phase = Phase::CONNECTING;
+    client.handshaking = true;
+    ConnectionRequestMessage request(
+        "Load" + std::to_string(client.index),
+        options.json ? 0 : static_cast<size_t>(BraendiDog::latestWireFormat));
+    send(client, request);
+  }
+
+  // The socket became writable (or failed) while connecting
+  void connected(SimClient& client) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    if (::getsockopt(client.connection.handle(), SOL_SOCKET, SO_ERROR, &error,
+                     &length) < 0 ||
+        error != 0) {
+      ++stats.connectFailures;
+      return close(client);
+    }
+    client.handshaking = false;
+    flush(client);
+  }
+
+  void close(SimClient& client) {
+    client.phase = Phase::DONE;
+    client.handshaking = false;
+    client.actAt.reset();
+    client.outbox.clear();
+    client.connection.close();
+  }
+
+  // Queue a message, written right away unless the socket is busy
+  void send(SimClient& client, const Message& message) {
+    client.outbox += BraendiDog::encodeMessageFrame(message, client.format);
+    ++stats.messagesOut;
+    if (!client.handshaking) {
+      flush(client);
+    }
+  }
+
+  // Write as much of the outbox as the socket takes, the rest on POLLOUT
+  void flush(SimClient& client) {
+    while (!client.outbox.empty()) {
+      ssize_t n = ::send(client.connection.handle(), client.outbox.data(),
+                         client.outbox.size(), sendFlags);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          ++stats.sendErrors;
+          close(client);
+        }
+        return;
+      }
+      stats.bytesOut += n;
+      client.outbox.erase(0, n);
+    }
+  }
+
+  void receive(SimClient& client) {
+    auto space = client.inbox.prepare(16384);
+    ssize_t n = client.connection.read(space.data(), space.size());
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    if (n <= 0) {
+      // The server closes surplus connections before answering them
+      if (client.phase == Phase::CONNECTING) {
+        ++stats.rejected;
+      } else {
+        ++stats.disconnects;
+      }
+      return close(client);
+    }
+    stats.bytesIn += n;
+    client.inbox.commit(n);
+
+    // Process complete frames in place
+    try {
+      while (client.phase != Phase::DONE) {
+        auto frame = client.inbox.next();
+        if (!frame) {
+          break;
+        }
+        ++stats.messagesIn;
+        handle(client, *frame);
+      }
+    } catch (const BraendiDog::FramingError& e) {
+      BD_LOG_WARN("Loadgen", "Client " << client.index << ": " << e.what());
+      ++stats.parseErrors;
+      close(client);
+    }
+  }
+
+  void handle(SimClient& client, std::string_view frame) {
+    std::unique_ptr<Message> parsed;
+    try {
+      parsed = BraendiDog::decodeMessage(frame);
+    } catch (const std::exception& e) {
+      BD_LOG_WARN("Loadgen", "Client " << client.index
+                                       << " could not parse: " << e.what());
+    }
+    if (!parsed) {
+      ++stats.parseErrors;
+      return;
+    }
+
+    switch (parsed->getMessageType()) {
+      case MessageType::RESP_CONNECT: {
+        auto* response = static_cast<ConnectionResponseMessage*>(parsed.get());
+        if (!response->getSuccess()) {
+          ++stats.rejected;
+          return close(client);
+        }
+        ++stats.connected;
+        stats.connectMs.push_back(elapsedMs(client.sentAt));
+        client.view.emplace(response->playerId);
+        client.format = BraendiDog::negotiateWireFormat(response->wireFormat);
+        client.phase = Phase::LOBBY;
+        break;
+      }
+      case MessageType::BRDC_PLAYER_LIST: {
+        auto* list = static_cast<PlayerListUpdateMessage*>(parsed.get());
+        // Get ready once listed, like a user in the lobby
+        if (!client.readySent) {
+          client.readySent = true;
+          send(client, ReadyMessage(client.view->getSelf()));
+          break;
+        }
+        bool allReady = std::all_of(
+            list->playersList.begin(), list->playersList.end(),
+            [](const PlayerInfo& player) { return player.ready; });
+        // One player per table asks: the one with the highest ID
+        bool starter = std::none_of(
+            list->playersList.begin(), list->playersList.end(),
+            [&client](const PlayerInfo& player) {
+              return player.id > client.view->getSelf();
+            });
+        if (starter && !client.startSent &&
+            client.phase == Phase::LOBBY &&
+            list->playersList.size() >= options.players && allReady) {
+          client.startSent = true;
+          send(client, StartGameRequestMessage(client.view->getSelf()));
+        }
+        break;
+      }
+      case MessageType::BRDC_GAME_START:
+        client.phase = Phase::GAME;
+        break;
+      case MessageType::BRDC_GAMESTATE_UPDATE: {
+        auto* update = static_cast<GameStateUpdateMessage*>(parsed.get());
+        client.view->applyGameState(update->gameState, update->sequence);
+        client.resyncing = false;
+        client.awaitingUpdate = false;
+        schedule(client);
+        break;
+      }
+      case MessageType::BRDC_GAMESTATE_DELTA: {
+        auto* delta = static_cast<GameStateDeltaMessage*>(parsed.get());
+        if (!client.view->applyGameStateDelta(delta->delta, delta->sequence)) {
+          // Skip deltas until the full state arrives
+          if (!client.resyncing) {
+            client.resyncing = true;
+            ++stats.resyncs;
+            send(client, GameStateRequestMessage(client.view->getSelf()));
+          }
+          break;
+        }
+        client.awaitingUpdate = false;
+        schedule(client);
+        break;
+      }
+      case MessageType::PRIV_CARDS_DEALT:
+        client.view->applyCardsDealt(
+            static_cast<CardsDealtMessage*>(parsed.get())->cards);
+        schedule(client);
+        break;
+      case MessageType::RESP_PLAY_CARD:
+      case MessageType::RESP_SKIP_TURN: {
+        stats.turnMs.push_back(elapsedMs(client.sentAt));
+        auto* response = static_cast<ServerResponse*>(parsed.get());
+        if (response->getSuccess()) {
+          client.view->turnAccepted(parsed->getMessageType() ==
+                                    MessageType::RESP_SKIP_TURN);
+          client.rejections = 0;
+          ++stats.turns;
+          break;  // Wait for the new game state
+        }
+        ++stats.rejectedTurns;
+        BD_LOG_WARN("Loadgen", "Client " << client.index << " turn rejected: "
+                                         << response->getErrorMsg());
+        client.awaitingUpdate = false;
+        if (++client.rejections > 2) {
+          ++stats.disconnects;
+          return close(client);
+        }
+        schedule(client);
+        break;
+      }
+      case MessageType::BRDC_RESULTS:
+        ++stats.games;
+        return close(client);
+      default:
+        break;
+    }
+  }
+
+  // Plan the next turn after the think time
+  void schedule(SimClient& client) {
+    if (!client.awaitingUpdate && !client.actAt.has_value() &&
+        client.view->isOwnTurn()) {
+      client.actAt = Clock::now() + options.think;
+    }
+  }
+
+  void act(SimClient& client) {
+    client.actAt.reset();
+    if (client.awaitingUpdate || !client.view->isOwnTurn()) {
+      return;
+    }
+
+    // After a rejection fall back to the engine's first legal move
+    std::vector<BraendiDog::Move> moves =
+        client.view->getState()->computeAllLegalMoves();
+    BraendiDog::Move move;
+    if (!moves.empty()) {
+      move = client.rejections > 0 ? moves.front()
+                                   : moves[client.rng.below(moves.size())];
+    }
+
+    client.view->moveSent(move);
+    client.awaitingUpdate = true;
+    client.sentAt = Clock::now();
+    size_t self = client.view->getSelf();
+    if (move.getMovements().empty()) {
+      send(client, SkipTurnRequestMessage(self));
+    } else {
+      send(client, PlayCardRequestMessage(self, move));
+    }
+  }
+};
+
+// Nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+  return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void printLatency(const std::string& label, std::vector<double>& samples) {
+  std::sort(samples.begin(), samples.end());
+  std::cout << label << " ms  n " << samples.size() << "  p50 "
+            << percentile(samples, 0.5) << "  p90 " << percentile(samples, 0.9)
+            << "  p99 " << percentile(samples, 0.99) << "  max "
+            << (samples.empty() ? 0.0 : samples.back()) << "\n";
+}
+
+void printUsage(const char* programName) {
+  std::cout << "Usage: " << programName
+            << " [--host ADDRESS] [--port PORT] [--clients N] [--players N]"
+               " [--rate R] [--threads N] [--think-ms MS] [--duration S]"
+               " [--seed S] [--json]\n"
+            << "  --clients   Simulated connections (default 4)\n"
+            << "  --players   Players per table before the start is requested "
+               "(default 4)\n"
+            << "  --rate      New connections per second, 0 = all at once "
+               "(default 100)\n"
+            << "  --think-ms  Delay before answering a turn (default 0)\n"
+            << "  --duration  Stop after S seconds, 0 = until all clients are "
+               "done (default 60)\n"
+            << "  --json      Speak JSON instead of the binary format\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("Missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--host") {
+        options.host = value();
+      } else if (arg == "--port") {
+        options.port = std::stoi(value());
+      } else if (arg == "--clients") {
+        options.clients = std::stoul(value());
+      } else if (arg == "--players") {
+        options.players = std::stoul(value());
+      } else if (arg == "--rate") {
+        options.rate = std::stod(value());
+      } else if (arg == "--threads") {
+        options.threads = std::max<size_t>(1, std::stoul(value()));
+      } else if (arg == "--think-ms") {
+        options.think = std::chrono::milliseconds(std::stoul(value()));
+      } else if (arg == "--duration") {
+        options.duration = std::chrono::seconds(std::stoul(value()));
+      } else if (arg == "--seed") {
+        options.seed = std::stoull(value());
+      } else if (arg == "--json") {
+        options.json = true;
+      } else {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+    if (options.port < 1024 || options.port > 65535) {
+      throw std::invalid_argument(
+          "Invalid port number. Must be between 1024 and 65535.");
+    }
+    if (options.players < 2 || options.players > 4) {
+      throw std::invalid_argument("Player count must be between 2 and 4");
+    }
+    options.address = sockpp::inet_address(
+        options.host, static_cast<in_port_t>(options.port));
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    printUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // Per message diagnostics would dominate the run time
+  if (BraendiDog::Log::getLevel() < BraendiDog::Log::Level::WARN) {
+    BraendiDog::Log::setLevel(BraendiDog::Log::Level::WARN);
+  }
+
+  // Spread the clients over the workers, connects paced by the rate
+  auto start = Clock::now();
+  options.threads =
+      std::min(options.threads, std::max<size_t>(1, options.clients));
+  std::vector<std::unique_ptr<Worker>> workers;
+  for (size_t t = 0; t < options.threads; ++t) {
+    workers.push_back(
+        std::make_unique<Worker>(options, start + options.duration));
+  }
+  uint64_t seedState = options.seed;
+  for (size_t index = 0; index < options.clients; ++index) {
+    auto client = std::make_unique<SimClient>();
+    client->index = index;
+    client->rng =
+        BraendiDog::Xoshiro256(BraendiDog::Zobrist::splitmix64(seedState));
+    if (options.rate > 0) {
+      client->connectAt =
+          start + std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<double>(index / options.rate));
+    } else {
+      client->connectAt = start;
+    }
+    workers[index % options.threads]->add(std::move(client));
+  }
+
+  std::vector<std::thread> threads;
+  for (auto& worker : workers) {
+    threads.emplace_back(&Worker::run, worker.get());
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double seconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+  seconds = std::max(seconds, 1e-9);
+
+  Stats totals;
+  for (const auto& worker : workers) {
+    totals.merge(worker->getStats());
+  }
+
+  // Report
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "clients " << options.clients << " on " << options.threads
+            << " threads in " << seconds << "s\n";
+  std::cout << "connected " << totals.connected << "  rejected "
+            << totals.rejected << "  connect failures "
+            << totals.connectFailures << "\n";
+  printLatency("connect", totals.connectMs);
+  printLatency("turn rtt", totals.turnMs);
+  std::cout << "turns " << totals.turns << " (" << totals.rejectedTurns
+            << " rejected)  turns/s " << totals.turns / seconds
+            << "  results " << totals.games << "  unfinished "
+            << totals.unfinished << "  resyncs " << totals.resyncs << "\n";
+  std::cout << "messages in " << totals.messagesIn << " ("
+            << totals.messagesIn / seconds << "/s, "
+            << totals.bytesIn / seconds / 1024 << " KiB/s)  out "
+            << totals.messagesOut << " (" << totals.messagesOut / seconds
+            << "/s, " << totals.bytesOut / seconds / 1024 << " KiB/s)\n";
+  std::cout << "errors " << totals.errors() << "  (disconnects "
+            << totals.disconnects << ", parse " << totals.parseErrors
+            << ", send " << totals.sendErrors << ")\n";
+  return totals.errors() > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file perft.cpp
+ * @brief Perft benchmark: counts game tree nodes and reports nodes/second.
+ *
+ * Usage: perft [--depth N] [--players N] [--seed S] [--warmup K]
+ *              [--json FILE] [--breakdown] [--verify]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string>
+
+#include "shared/game.hpp"
+#include "shared/perft.hpp"
+
+namespace {
+
+struct Options {
+  size_t depth = 3;
+  size_t players = 4;
+  uint64_t seed = 1;
+  size_t warmup = 0;
+  std::string json;
+  bool breakdown = false;
+  bool verify = false;
+};
+
+void printUsage(const char* programName) {
+  std::cout << "Usage: " << programName
+            << " [--depth N] [--players N] [--seed S] [--warmup K]"
+               " [--json FILE] [--breakdown] [--verify]\n"
+            << "  --depth N    Plies to search (default 3)\n"
+            << "  --players N  Players of a generated position, 2-4 "
+               "(default 4)\n"
+            << "  --seed S     Seed for dealing and warmup (default 1)\n"
+            << "  --warmup K   Random plies played before counting\n"
+            << "  --json FILE  Load the start position from a GameState JSON\n"
+            << "  --breakdown  Print last ply moves by kind\n"
+            << "  --verify     Check incremental hashes against rebuilds\n";
+}
+
+// Deal a deterministic first round
+BraendiDog::GameState seededState(size_t playerCount, uint64_t seed) {
+  std::array<std::optional<std::string>, 4> names;
+  for (size_t i = 0; i < playerCount; ++i) {
+    names[i] = "P" + std::to_string(i);
+  }
+  BraendiDog::GameState state(names, seed);
+  for (const auto& [id, hand] : state.dealCards()) {
+    state.setHand(id, hand);
+  }
+  return state;
+}
+
+// Play random plies (stops before a round end)
+void warmup(BraendiDog::GameState& state, size_t plies,
+            BraendiDog::Xoshiro256& rng) {
+  for (size_t ply = 0; ply < plies; ++ply) {
+    std::vector<BraendiDog::Move> moves = state.computeAllLegalMoves();
+    BraendiDog::GameState next = state;
+    if (moves.empty()) {
+      next.executeFold();
+    } else {
+      next.executeMove(moves[rng.below(moves.size())]);
+    }
+    auto [gameEnded, roundEnded] = next.endTurn();
+    if (gameEnded || roundEnded) {
+      return;
+    }
+    state = next;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("Missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--depth") {
+        options.depth = std::stoul(value());
+      } else if (arg == "--players") {
+        options.players = std::stoul(value());
+      } else if (arg == "--seed") {
+        options.seed = std::stoull(value());
+      } else if (arg == "--warmup") {
+        options.warmup = std::stoul(value());
+      } else if (arg == "--json") {
+        options.json = value();
+      } else if (arg == "--breakdown") {
+        options.breakdown = true;
+      } else if (arg == "--verify") {
+        options.verify = true;
+      } else {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+    if (options.players < 2 || options.players > 4) {
+      throw std::invalid_argument("Player count must be between 2 and 4");
+    }
+
+    // Start position
+    BraendiDog::Xoshiro256 rng(~options.seed);
+    BraendiDog::GameState state =
+        options.json.empty()
+            ? seededState(options.players, options.seed)
+            : nlohmann::json::parse(std::ifstream(options.json))
+                  .get<BraendiDog::GameState>();
+    warmup(state, options.warmup, rng);
+    std::cout << "Position hash: " << std::hex << state.hash() << std::dec
+              << "\n";
+
+    // Iterative deepening
+    for (size_t depth = 1; depth <= options.depth; ++depth) {
+      auto start = std::chrono::steady_clock::now();
+      BraendiDog::PerftResult result =
+          BraendiDog::perft(state, depth, options.verify);
+      double seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+      std::cout << "depth " << depth << "  nodes " << result.nodes
+                << "  terminal " << result.terminal << "  time " << seconds
+                << "s  nps "
+                << static_cast<uint64_t>(result.nodes /
+                                         std::max(seconds, 1e-9));
+      if (options.verify) {
+        std::cout << "  hash mismatches " << result.hashMismatches;
+      }
+      std::cout << "\n";
+
+      if (options.breakdown) {
+        for (size_t kind = 0; kind < BraendiDog::moveKindCount; ++kind) {
+          std::cout << "  "
+                    << BraendiDog::moveKindName(
+                           static_cast<BraendiDog::MoveKind>(kind))
+                    << " " << result.kinds[kind] << "\n";
+        }
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file simulate.cpp
+ * @brief Headless multi-threaded self-play of complete games.
+ *
+ * Usage: simulate [--games N] [--players N] [--threads N] [--seed S]
+ *                 [--max-turns N]
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shared/logging.hpp"
+#include "shared/simulation.hpp"
+
+namespace {
+
+struct Options {
+  size_t games = 1000;
+  size_t players = 4;
+  size_t threads = std::max(1u, std::thread::hardware_concurrency());
+  uint64_t seed = 1;
+  size_t maxTurns = 100000;
+};
+
+// Aggregated outcome statistics
+struct Totals {
+  size_t games = 0;
+  size_t finished = 0;
+  size_t turns = 0;
+  size_t folds = 0;
+  size_t rounds = 0;
+  std::array<size_t, 4> wins{};      // Rank 1 per seat
+  std::array<size_t, 4> rankSum{};   // Sum of ranks per seat (finished only)
+  std::array<size_t, 4> rankCount{};
+
+  void add(const BraendiDog::GameSummary& game) {
+    ++games;
+    finished += game.finished ? 1 : 0;
+    turns += game.turns;
+    folds += game.folds;
+    rounds += game.rounds;
+    for (size_t seat = 0; seat < 4; ++seat) {
+      const auto& rank = game.leaderBoard[seat];
+      if (rank.has_value() && rank.value() > 0) {
+        wins[seat] += rank.value() == 1 ? 1 : 0;
+        rankSum[seat] += rank.value();
+        ++rankCount[seat];
+      }
+    }
+  }
+
+  void merge(const Totals& other) {
+    games += other.games;
+    finished += other.finished;
+    turns += other.turns;
+    folds += other.folds;
+    rounds += other.rounds;
+    for (size_t seat = 0; seat < 4; ++seat) {
+      wins[seat] += other.wins[seat];
+      rankSum[seat] += other.rankSum[seat];
+      rankCount[seat] += other.rankCount[seat];
+    }
+  }
+};
+
+void printUsage(const char* programName) {
+  std::cout << "Usage: " << programName
+            << " [--games N] [--players N] [--threads N] [--seed S]"
+               " [--max-turns N]\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      auto value = [&]() -> std::string {
+        if (i + 1 >= argc) {
+          throw std::invalid_argument("Missing value for " + arg);
+        }
+        return argv[++i];
+      };
+      if (arg == "--games") {
+        options.games = std::stoul(value());
+      } else if (arg == "--players") {
+        options.players = std::stoul(value());
+      } else if (arg == "--threads") {
+        options.threads = std::max<size_t>(1, std::stoul(value()));
+      } else if (arg == "--seed") {
+        options.seed = std::stoull(value());
+      } else if (arg == "--max-turns") {
+        options.maxTurns = std::stoul(value());
+      } else {
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+    }
+    if (options.players < 2 || options.players > 4) {
+      throw std::invalid_argument("Player count must be between 2 and 4");
+    }
+  } catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Engine diagnostics would dominate the run time
+  if (BraendiDog::Log::getLevel() < BraendiDog::Log::Level::WARN) {
+    BraendiDog::Log::setLevel(BraendiDog::Log::Level::WARN);
+  }
+
+  // Workers pull game indices from a shared counter
+  std::atomic<size_t> nextGame{0};
+  std::atomic<bool> failed{false};
+  Totals totals;
+  std::mutex totalsMutex;
+  auto worker = [&]() {
+    Totals local;
+    size_t game;
+    while (!failed && (game = nextGame++) < options.games) {
+      try {
+        local.add(BraendiDog::playGame(options.players, options.seed + game,
+                                       {}, options.maxTurns));
+      } catch (const std::exception& e) {
+        std::cerr << "Game " << game << " (seed " << options.seed + game
+                  << ") failed: " << e.what() << std::endl;
+        failed = true;
+      }
+    }
+    std::lock_guard<std::mutex> lock(totalsMutex);
+    totals.merge(local);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < options.threads; ++t) {
+    threads.emplace_back(worker);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  seconds = std::max(seconds, 1e-9);
+
+  // Report
+  std::cout << std::fixed << std::setprecision(2);
+  std::cout << "games " << totals.games << " (" << totals.finished
+            << " finished) on " << options.threads << " threads in "
+            << seconds << "s\n";
+  std::cout << "games/s " << totals.games / seconds << "  turns/s "
+            << totals.turns / seconds << "\n";
+  if (totals.games > 0) {
+    double games = static_cast<double>(totals.games);
+    std::cout << "avg turns " << totals.turns / games << "  avg rounds "
+              << totals.rounds / games << "  fold rate "
+              << (totals.turns ? 100.0 * totals.folds / totals.turns : 0.0)
+              << "%\n";
+  }
+  for (size_t seat = 0; seat < options.players; ++seat) {
+    std::cout << "seat " << seat << "  wins " << totals.wins[seat]
+              << "  avg rank "
+              << (totals.rankCount[seat]
+                      ? static_cast<double>(totals.rankSum[seat]) /
+                            totals.rankCount[seat]
+                      : 0.0)
+              << "\n";
+  }
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
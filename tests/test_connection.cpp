@@ -0,0 +1,324 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "server/connection.hpp"
+#include "server/reactor.hpp"
+#include "server/room.hpp"
+#include "server/worker_pool.hpp"
+#include "shared/framing.hpp"
+#include "shared/messages.hpp"
+#include "shared/wire_format.hpp"
+
+using namespace BraendiDog;
+
+namespace {
+// Raw frame of the given size, the peer only counts its bytes
+Connection::Frame makeFrame(size_t size) {
+  return std::make_shared<const std::string>(size, 'x');
+}
+}  // namespace
+
+// Connections to socketpair peers, served by a loop that never runs: sent
+// frames stay queued until a test flushes them
+class ConnectionTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    for (int fd : peers_) {
+      ::close(fd);
+    }
+  }
+
+  std::shared_ptr<Connection> connect(SendQueueLimits limits = {}) {
+    int fds[2];
+    EXPECT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    peers_.push_back(fds[1]);
+    inboxes_.emplace_back();
+    return std::make_shared<Connection>(peers_.size(),
+                                        sockpp::tcp_socket(fds[0]), loop_,
+                                        limits);
+  }
+
+  // Reads what the peer of a connection received, -1 on end of stream
+  ssize_t readPeer(const Connection& connection) {
+    ssize_t total = 0;
+    char buffer[65536];
+    for (;;) {
+      ssize_t n = ::recv(peers_[connection.getId() - 1], buffer,
+                         sizeof(buffer), MSG_DONTWAIT);
+      if (n == 0) {
+        return total > 0 ? total : -1;
+      }
+      if (n < 0) {
+        return total;
+      }
+      inboxes_[connection.getId() - 1].append(std::string_view(buffer, n));
+      total += n;
+    }
+  }
+
+  // Flushes a connection and decodes what its peer received until a message
+  // of the given type arrived (room events run on worker threads)
+  std::vector<std::unique_ptr<Message>> receiveUntil(Connection& connection,
+                                                     MessageType type) {
+    std::vector<std::unique_ptr<Message>> messages;
+    auto& inbox = inboxes_[connection.getId() - 1];
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    bool found = false;
+    while (!found && std::chrono::steady_clock::now() < deadline) {
+      connection.flush();
+      readPeer(connection);
+      while (auto payload = inbox.next()) {
+        messages.push_back(decodeMessage(*payload));
+        found = found || messages.back()->getMessageType() == type;
+      }
+      if (!found) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+    EXPECT_TRUE(found);
+    return messages;
+  }
+
+  EventLoop loop_;
+  std::vector<int> peers_;
+  std::vector<FrameBuffer> inboxes_;
+};
+
+// Test that events fetched in the same wait are not delivered once another
+// thread unwatched their descriptor
+TEST(EventLoopTest, UnwatchSkipsFetchedEvents) {
+  EventLoop loop;
+  int fds[2][2];
+  for (auto& pair : fds) {
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    ASSERT_EQ(::write(pair[1], "x", 1), 1);
+  }
+
+  // Whichever handler runs first unwatches the other from another thread
+  int calls = 0;
+  for (int i = 0; i < 2; ++i) {
+    int other = fds[1 - i][0];
+    loop.watch(fds[i][0], [&loop, &calls, other](uint32_t) {
+      ++calls;
+      std::thread([&loop, other]() { loop.unwatch(other); }).join();
+      loop.stop();
+    });
+  }
+  loop.run();
+  EXPECT_EQ(calls, 1);
+
+  for (auto& pair : fds) {
+    loop.unwatch(pair[0]);
+    ::close(pair[0]);
+    ::close(pair[1]);
+  }
+}
+
+// Test that one receive() reads a bounded amount, the rest on later calls
+TEST_F(ConnectionTest, ReceiveReadsBoundedAmount) {
+  auto connection = connect();
+  std::string stream;
+  for (int i = 0; i < 100; ++i) {
+    appendFrame(stream, std::string(1020, 'x'));
+  }
+  ASSERT_EQ(::write(peers_[0], stream.data(), stream.size()),
+            static_cast<ssize_t>(stream.size()));
+
+  auto drain = [&connection]() {
+    size_t count = 0;
+    while (connection->nextMessage()) {
+      ++count;
+    }
+    return count;
+  };
+  ASSERT_TRUE(connection->receive());
+  size_t first = drain();
+  EXPECT_GT(first, 0u);
+  EXPECT_LT(first, 100u);
+
+  size_t total = first;
+  for (int calls = 0; calls < 100 && total < 100; ++calls) {
+    ASSERT_TRUE(connection->receive());
+    total += drain();
+  }
+  EXPECT_EQ(total, 100u);
+}
+
+// Test that DROP refuses frames beyond the limit and keeps the connection
+TEST_F(ConnectionTest, DropRefusesFramesBeyondLimit) {
+  auto connection = connect({1000, Backpressure::DROP});
+
+  EXPECT_TRUE(connection->sendFrame(makeFrame(600)));
+  EXPECT_FALSE(connection->sendFrame(makeFrame(600)));
+  EXPECT_EQ(connection->lastError(), "Send queue full");
+  EXPECT_EQ(connection->getDroppedFrames(), 1u);
+
+  // A frame that fits is queued again
+  EXPECT_TRUE(connection->sendFrame(makeFrame(300)));
+  EXPECT_EQ(connection->getDroppedFrames(), 1u);
+  connection->flush();
+  EXPECT_EQ(readPeer(*connection), 900);
+}
+
+// Test that DISCONNECT closes a client that does not keep up
+TEST_F(ConnectionTest, DisconnectClosesSlowClient) {
+  auto connection = connect({1000, Backpressure::DISCONNECT});
+
+  EXPECT_TRUE(connection->sendFrame(makeFrame(600)));
+  EXPECT_FALSE(connection->sendFrame(makeFrame(600)));
+  EXPECT_EQ(connection->lastError(), std::strerror(ENOBUFS));
+  EXPECT_FALSE(connection->sendFrame(makeFrame(10)));
+
+  // Queued output is dropped, the peer sees the end of stream
+  connection->flush();
+  EXPECT_EQ(readPeer(*connection), -1);
+}
+
+// Test that COALESCE discards queued game states but keeps other messages
+TEST_F(ConnectionTest, CoalesceReplacesQueuedStates) {
+  using Kind = Connection::FrameKind;
+  auto connection = connect({1000, Backpressure::COALESCE});
+
+  EXPECT_TRUE(connection->sendFrame(makeFrame(300), Kind::MESSAGE));
+  EXPECT_TRUE(connection->sendFrame(makeFrame(400), Kind::STATE));
+  EXPECT_TRUE(connection->sendFrame(makeFrame(400), Kind::STATE));
+  EXPECT_EQ(connection->getDroppedFrames(), 1u);
+
+  // The newer state replaced the discarded one
+  EXPECT_FALSE(connection->needsSnapshot());
+  connection->flush();
+  EXPECT_EQ(readPeer(*connection), 700);
+}
+
+// Test that COALESCE drops deltas until the next full state
+TEST_F(ConnectionTest, CoalesceDropsDeltasUntilSnapshot) {
+  using Kind = Connection::FrameKind;
+  auto connection = connect({1000, Backpressure::COALESCE});
+
+  EXPECT_TRUE(connection->sendFrame(makeFrame(300), Kind::MESSAGE));
+  EXPECT_TRUE(connection->sendFrame(makeFrame(400), Kind::STATE));
+
+  // The delta that overflows discards its base and is dropped itself
+  EXPECT_TRUE(connection->sendFrame(makeFrame(400), Kind::STATE_DELTA));
+  EXPECT_TRUE(connection->needsSnapshot());
+  EXPECT_EQ(connection->getDroppedFrames(), 2u);
+
+  // Later deltas are dropped even though they fit
+  EXPECT_TRUE(connection->sendFrame(makeFrame(10), Kind::STATE_DELTA));
+  EXPECT_EQ(connection->getDroppedFrames(), 3u);
+
+  // A full state is the new base
+  EXPECT_TRUE(connection->sendFrame(makeFrame(400), Kind::STATE));
+  EXPECT_FALSE(connection->needsSnapshot());
+  EXPECT_TRUE(connection->sendFrame(makeFrame(10), Kind::STATE_DELTA));
+  EXPECT_EQ(connection->getDroppedFrames(), 3u);
+
+  connection->flush();
+  EXPECT_EQ(readPeer(*connection), 710);
+}
+
+// Test that COALESCE disconnects if other messages still do not fit
+TEST_F(ConnectionTest, CoalesceDisconnectsIfMessagesDoNotFit) {
+  using Kind = Connection::FrameKind;
+  auto connection = connect({1000, Backpressure::COALESCE});
+
+  EXPECT_TRUE(connection->sendFrame(makeFrame(400), Kind::STATE));
+  EXPECT_TRUE(connection->sendFrame(makeFrame(600), Kind::MESSAGE));
+  EXPECT_FALSE(connection->sendFrame(makeFrame(600), Kind::MESSAGE));
+  EXPECT_EQ(connection->lastError(), std::strerror(ENOBUFS));
+
+  connection->flush();
+  EXPECT_EQ(readPeer(*connection), -1);
+}
+
+// Test that a room sends the full state instead of the delta to a client
+// whose queue discarded game states, and the delta to everyone else
+TEST_F(ConnectionTest, RoomSendsSnapshotToLaggingClient) {
+  WorkerPool workers(2);
+  auto room = std::make_shared<Room>(1, "Room 1", workers);
+  auto welcome = [](int) {
+    return std::make_unique<ReadyResponseMessage>(true);
+  };
+  std::vector<std::shared_ptr<Connection>> connections = {connect(),
+                                                          connect()};
+  std::vector<int> seats;
+  for (auto& connection : connections) {
+    seats.push_back(room->join(connection, "", welcome));
+    ASSERT_GE(seats.back(), 0);
+  }
+  for (size_t i = 0; i < connections.size(); ++i) {
+    room->handleMessage(connections[i]->getId(),
+                        std::make_shared<ReadyMessage>(seats[i]));
+  }
+  room->handleMessage(connections[0]->getId(),
+                      std::make_shared<StartGameRequestMessage>(seats[0]));
+
+  // Rebuild the current player's view from the initial state and its hand
+  std::optional<GameState> state;
+  std::vector<std::vector<size_t>> hands(connections.size());
+  for (size_t i = 0; i < connections.size(); ++i) {
+    for (const auto& message :
+         receiveUntil(*connections[i], MessageType::PRIV_CARDS_DEALT)) {
+      if (auto* update =
+              dynamic_cast<GameStateUpdateMessage*>(message.get())) {
+        state = update->gameState;
+      } else if (auto* dealt =
+                     dynamic_cast<CardsDealtMessage*>(message.get())) {
+        hands[i] = dealt->cards;
+      }
+    }
+  }
+  ASSERT_TRUE(state.has_value());
+  size_t current = 0;
+  while (seats[current] != static_cast<int>(state->getCurrentPlayer())) {
+    ++current;
+  }
+  state->getPlayerByIndex(seats[current])->setHand(hands[current]);
+  auto& lagging = connections[1 - current];
+
+  // Two deltas overflow the lagging queue, which then waits for a snapshot
+  auto delta = makeFrame(SendQueueLimits{}.maxBytes / 2 + 1);
+  lagging->sendFrame(delta, Connection::FrameKind::STATE_DELTA);
+  lagging->sendFrame(delta, Connection::FrameKind::STATE_DELTA);
+  ASSERT_TRUE(lagging->needsSnapshot());
+
+  // Any turn broadcasts a delta
+  auto moves = state->computeAllLegalMoves();
+  if (moves.empty()) {
+    room->handleMessage(
+        connections[current]->getId(),
+        std::make_shared<SkipTurnRequestMessage>(seats[current]));
+  } else {
+    room->handleMessage(connections[current]->getId(),
+                        std::make_shared<PlayCardRequestMessage>(
+                            seats[current], moves.front()));
+  }
+
+  size_t deltas = 0;
+  for (const auto& message : receiveUntil(
+           *connections[current], MessageType::BRDC_GAMESTATE_DELTA)) {
+    deltas += message->getMessageType() == MessageType::BRDC_GAMESTATE_DELTA;
+  }
+  EXPECT_EQ(deltas, 1u);
+
+  std::vector<size_t> snapshots;
+  for (const auto& message :
+       receiveUntil(*lagging, MessageType::BRDC_GAMESTATE_UPDATE)) {
+    EXPECT_NE(message->getMessageType(), MessageType::BRDC_GAMESTATE_DELTA);
+    if (auto* update = dynamic_cast<GameStateUpdateMessage*>(message.get())) {
+      snapshots.push_back(update->sequence);
+    }
+  }
+  EXPECT_EQ(snapshots, std::vector<size_t>{2});
+  EXPECT_FALSE(lagging->needsSnapshot());
+  workers.stop();
+}
@@ -1,10 +1,15 @@
 #include <gtest/gtest.h>
 
 #include <nlohmann/json.hpp>
+#include <set>
 
 #include "shared/game.hpp"
 #include "shared/game_objects.hpp"
 #include "shared/game_types.hpp"
+#include "shared/ismcts.hpp"
+#include "shared/perft.hpp"
+#include "shared/player_view.hpp"
+#include "shared/simulation.hpp"
 
 using namespace BraendiDog;
 
@@ -61,6 +66,26 @@ TEST(GameStateTest, DealCards) {
   }
 }
 
+TEST(GameStateTest, SeededDealsAreReproducible) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           std::nullopt};
+  BraendiDog::GameState first(playerNames, 42);
+  BraendiDog::GameState second(playerNames, 42);
+  EXPECT_EQ(first.dealCards(), second.dealCards());
+
+  // The generator state survives serialization
+  BraendiDog::GameState restored =
+      nlohmann::json(first).get<BraendiDog::GameState>();
+  EXPECT_EQ(restored.getRng(), first.getRng());
+  EXPECT_EQ(restored.dealCards(), first.dealCards());
+
+  // Reseeding replays the deal
+  BraendiDog::GameState replay(playerNames, 7);
+  auto firstDeal = replay.dealCards();
+  replay.reseed(7);
+  EXPECT_EQ(replay.dealCards(), firstDeal);
+}
+
 TEST(GameStateTest, DeckComposition) {
   std::array<std::optional<std::string>, 4> playerNames = {
       "ID0", std::nullopt, std::nullopt, std::nullopt};
@@ -148,6 +173,66 @@ TEST(MoveComputation, isFieldOccupied) {
   EXPECT_FALSE(occupiedMarbleOpt.has_value());
 }
 
+TEST(MoveComputation, OccupancyMasks) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+
+  EXPECT_EQ(gameState.getTrackMask(), 0u);
+  EXPECT_EQ(gameState.getFinishMask(0), 0u);
+
+  gameState.getPlayers()[0]->setMarblePosition(0,
+                                               Position(BoardLocation::TRACK,
+                                                        63, 0));
+  gameState.getPlayers()[0]->setMarblePosition(
+      1, Position(BoardLocation::FINISH, 2, 0));
+  gameState.getPlayers()[1]->setStartBlocked(0);
+
+  EXPECT_EQ(gameState.getTrackMask(), uint64_t{1} << 63);
+  EXPECT_EQ(gameState.getFinishMask(0), 0b0100);
+  EXPECT_EQ(gameState.getFinishMask(1), 0u);
+  EXPECT_EQ(gameState.getBlockedStartMask(), uint64_t{1} << 16);
+
+  auto occupant =
+      gameState.isFieldOccupied(Position(BoardLocation::FINISH, 2, 0));
+  ASSERT_TRUE(occupant.has_value());
+  EXPECT_EQ(occupant->marbleIdx, 1);
+  EXPECT_FALSE(gameState.isFieldOccupied(Position(BoardLocation::FINISH, 2, 1))
+                   .has_value());
+}
+
+TEST(MoveComputation, OccupancyFollowsExecutedMoves) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+
+  Position ownPos(BoardLocation::TRACK, 5, 0);
+  Position oppPos(BoardLocation::TRACK, 20, 1);
+  gameState.getPlayers()[0]->setMarblePosition(0, ownPos);
+  gameState.getPlayers()[1]->setMarblePosition(0, oppPos);
+  gameState.getPlayers()[0]->setHand({10, 11});  // JACK, QUEEN
+  ASSERT_TRUE(gameState.isFieldOccupied(ownPos).has_value());
+
+  // Swap with opponent marble
+  gameState.executeMove(Move(10, 0, {{{0, 0}, oppPos}, {{1, 0}, ownPos}}));
+  auto occupant = gameState.isFieldOccupied(oppPos);
+  ASSERT_TRUE(occupant.has_value());
+  EXPECT_EQ(occupant->playerID, 0);
+  occupant = gameState.isFieldOccupied(ownPos);
+  ASSERT_TRUE(occupant.has_value());
+  EXPECT_EQ(occupant->playerID, 1);
+
+  // Walk back onto opponent marble and send it home
+  gameState.executeMove(Move(
+      11, 0,
+      {{{0, 0}, ownPos}, {{1, 0}, Position(BoardLocation::HOME, 0, 1)}}));
+  occupant = gameState.isFieldOccupied(ownPos);
+  ASSERT_TRUE(occupant.has_value());
+  EXPECT_EQ(occupant->playerID, 0);
+  EXPECT_FALSE(gameState.isFieldOccupied(oppPos).has_value());
+  EXPECT_EQ(gameState.getTrackMask(), uint64_t{1} << 5);
+}
+
 TEST(MoveComputation, validateSimpleMove) {
   std::array<std::optional<std::string>, 4> playerNames = {
       "ID0", "ID1", std::nullopt, std::nullopt};
@@ -325,6 +410,78 @@ TEST(MoveComputation, computeLegalMoves) {
   EXPECT_GE(legalMoves.size(), 2);
 }
 
+TEST(MoveComputation, GenerateLegalMovesMatchesVectorApi) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           "ID3"};
+  BraendiDog::GameState gameState(playerNames);
+
+  gameState.getPlayers()[0]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 60, 0));
+  gameState.getPlayers()[0]->setMarblePosition(
+      1, Position(BoardLocation::TRACK, 30, 0));
+  gameState.getPlayers()[1]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 2, 1));
+  gameState.getPlayers()[2]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 33, 2));
+  gameState.getPlayers()[0]->setHand({0, 3, 10, 12, 23});  // A, 4, J, K, Q
+
+  MoveList moveList;
+  gameState.generateLegalMoves(moveList);
+  auto legalMoves = gameState.computeLegalMoves();
+
+  ASSERT_EQ(moveList.size(), legalMoves.size());
+  ASSERT_FALSE(moveList.empty());
+  for (size_t i = 0; i < moveList.size(); ++i) {
+    MoveView view = moveList[i];
+    EXPECT_EQ(view.getCardID(), legalMoves[i].getCardID());
+    EXPECT_EQ(view.getHandIndex(), legalMoves[i].getHandIndex());
+    ASSERT_EQ(view.getMovements().size(),
+              legalMoves[i].getMovements().size());
+    for (size_t j = 0; j < view.getMovements().size(); ++j) {
+      EXPECT_EQ(view.getMovements()[j].first.playerID,
+                legalMoves[i].getMovements()[j].first.playerID);
+      EXPECT_EQ(view.getMovements()[j].first.marbleIdx,
+                legalMoves[i].getMovements()[j].first.marbleIdx);
+      EXPECT_EQ(view.getMovements()[j].second,
+                legalMoves[i].getMovements()[j].second);
+    }
+  }
+
+  // Generation appends, clear() resets the list for reuse
+  gameState.generateLegalMoves(moveList);
+  EXPECT_EQ(moveList.size(), 2 * legalMoves.size());
+  moveList.clear();
+  EXPECT_TRUE(moveList.empty());
+}
+
+// Test the worst case bound of MoveList: all 16 marbles on the track and
+// the 4 Jacks in hand
+TEST(MoveComputation, LargestHandFitsMoveList) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           "ID3"};
+  BraendiDog::GameState gameState(playerNames);
+  for (size_t pID = 0; pID < 4; ++pID) {
+    for (size_t mIdx = 0; mIdx < 4; ++mIdx) {
+      gameState.setMarblePosition(
+          pID, mIdx,
+          Position(BoardLocation::TRACK, pID * 16 + 2 * mIdx + 1, pID));
+    }
+  }
+
+  // Every Jack swaps each own marble with each opponent marble, every Ace
+  // moves each marble 1 or 11 steps
+  gameState.setHand(0, {10, 23, 36, 49, 0, 13});  // J, J, J, J, A, A
+  MoveList moveList;
+  gameState.generateLegalMoves(moveList);
+  EXPECT_EQ(moveList.size(), 4 * 48 + 2 * 8);
+  EXPECT_LE(moveList.size(), MoveList::maxMoves);
+
+  // Joker ranks and Seven splits fill one list per card
+  gameState.setHand(0, {10, 23, 36, 49, 52, 6});  // J, J, J, J, Joker, 7
+  auto legalMoves = gameState.computeAllLegalMoves();
+  EXPECT_GT(legalMoves.size(), 4 * 48 + 48);
+}
+
 TEST(ServerValidation, ValidFold) {
   std::array<std::optional<std::string>, 4> playerNames = {
       "ID0", "ID1", std::nullopt, std::nullopt};
@@ -717,4 +874,611 @@ TEST(ExecuteMove, PlayerFinishDetection) {
   // Verify player is marked as finished
   EXPECT_FALSE(gameState.getPlayers()[0]->isActiveInGame());
   EXPECT_EQ(gameState.getLeaderBoard()[0], 1);  // First finisher
-}
\ No newline at end of file
+}
+
+TEST(MakeUnmake, RestoresCaptureAndEndTurn) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+
+  gameState.getPlayers()[0]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 5, 0));
+  gameState.getPlayers()[1]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 10, 1));
+  gameState.getPlayers()[1]->setStartBlocked(1);
+  gameState.getPlayers()[0]->setHand({4, 12});  // FIVE, KING
+  gameState.getPlayers()[1]->setHand({1});
+
+  nlohmann::json before = gameState;
+  auto handBefore = gameState.getPlayers()[0]->getHand();
+
+  Move move(4, 0,
+            {{{0, 0}, Position(BoardLocation::TRACK, 10, 0)},
+             {{1, 0}, Position(BoardLocation::HOME, 0, 1)}});
+  UndoRecord record = gameState.makeMove(move);
+  gameState.endTurn();
+  EXPECT_EQ(gameState.getCurrentPlayer(), 1);
+  EXPECT_EQ(gameState.getLastPlayedCard(), 4);
+
+  gameState.unmakeMove(record);
+  EXPECT_EQ(nlohmann::json(gameState), before);
+  EXPECT_EQ(gameState.getPlayers()[0]->getHand(), handBefore);
+  auto occupant =
+      gameState.isFieldOccupied(Position(BoardLocation::TRACK, 10, 1));
+  ASSERT_TRUE(occupant.has_value());
+  EXPECT_EQ(occupant->playerID, 1);
+  EXPECT_EQ(gameState.getTrackMask(),
+            (uint64_t{1} << 5) | (uint64_t{1} << 10));
+}
+
+TEST(MakeUnmake, RestoresFinishAndFold) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+
+  for (size_t mIdx = 0; mIdx < 3; ++mIdx) {
+    gameState.getPlayers()[0]->setMarblePosition(
+        mIdx, Position(BoardLocation::FINISH, mIdx + 1, 0));
+  }
+  gameState.getPlayers()[0]->setMarblePosition(
+      3, Position(BoardLocation::TRACK, 63, 0));
+  gameState.getPlayers()[0]->setHand({0, 7});  // ACE, EIGHT
+  gameState.getPlayers()[1]->setHand({2});
+
+  nlohmann::json before = gameState;
+
+  // Finishing move ends the game for player 0
+  UndoRecord record = gameState.makeMove(
+      Move(0, 0, {{{0, 3}, Position(BoardLocation::FINISH, 0, 0)}}));
+  EXPECT_TRUE(record.finished);
+  EXPECT_EQ(gameState.getLeaderBoard()[0], 1);
+  auto [gameEnded, roundEnded] = gameState.endTurn();
+  EXPECT_TRUE(gameEnded);
+
+  gameState.unmakeMove(record);
+  EXPECT_EQ(nlohmann::json(gameState), before);
+  EXPECT_EQ(gameState.getPlayers()[0]->getHand(),
+            std::vector<size_t>({0, 7}));
+
+  // Fold clears the hand and is reverted as well
+  UndoRecord foldRecord = gameState.makeFold();
+  EXPECT_TRUE(gameState.getPlayers()[0]->getHand().empty());
+  gameState.unmakeMove(foldRecord);
+  EXPECT_EQ(nlohmann::json(gameState), before);
+  EXPECT_EQ(gameState.getPlayers()[0]->getHand(),
+            std::vector<size_t>({0, 7}));
+}
+
+TEST(Hashing, IncrementalMatchesRebuild) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.setHand(0, {0, 12, 10, 4});  // A, K, J, 5
+  gameState.setHand(1, {13, 14, 15, 16});
+  gameState.setHand(2, {26, 27, 28, 29});
+  gameState.setMarblePosition(1, 0, Position(BoardLocation::TRACK, 20, 1));
+
+  // Rebuilding from scratch (in a loaded copy, hands are not serialized)
+  // must agree with the incrementally updated hash
+  auto rebuilt = [&gameState]() {
+    auto copy = nlohmann::json(gameState).get<BraendiDog::GameState>();
+    for (size_t pID = 0; pID < 4; ++pID) {
+      if (gameState.getPlayerByIndex(pID).has_value()) {
+        copy.setHand(pID, gameState.getPlayerByIndex(pID)->getHand());
+      }
+    }
+    return copy;
+  };
+  auto rebuiltHash = [&rebuilt]() { return rebuilt().hash(); };
+
+  uint64_t initialHash = gameState.hash();
+  EXPECT_EQ(initialHash, rebuiltHash());
+
+  // Start move blocks the start field
+  gameState.executeMove(
+      Move(0, 0, {{{0, 0}, Position(BoardLocation::TRACK, 0, 0)}}));
+  gameState.endTurn();
+  uint64_t afterStart = gameState.hash();
+  EXPECT_NE(afterStart, initialHash);
+  EXPECT_EQ(afterStart, rebuiltHash());
+
+  // Player 1 folds, player 2 disconnects
+  gameState.executeFold();
+  gameState.endTurn();
+  EXPECT_EQ(gameState.hash(), rebuiltHash());
+  gameState.disconnectPlayer(2);
+  EXPECT_EQ(gameState.hash(), rebuiltHash());
+
+  // Unmake restores the previous hash
+  uint64_t beforeMove = gameState.hash();
+  UndoRecord record = gameState.makeMove(
+      Move(10, 1,
+           {{{0, 0}, Position(BoardLocation::TRACK, 20, 0)},
+            {{1, 0}, Position(BoardLocation::TRACK, 0, 1)}}));
+  gameState.endTurn();
+  EXPECT_EQ(gameState.hash(), rebuiltHash());
+  gameState.unmakeMove(record);
+  EXPECT_EQ(gameState.hash(), beforeMove);
+  EXPECT_EQ(gameState.hash(), rebuiltHash());
+
+  // Setters keep the hash and occupancy index in sync
+  gameState.setHand(1, {5, 6});
+  gameState.popCardFromHand(0, 0);
+  gameState.setMarblePosition(1, 0, Position(BoardLocation::TRACK, 40, 1));
+  gameState.setStartBlocked(1, std::nullopt);
+  EXPECT_EQ(gameState.hash(), rebuiltHash());
+  EXPECT_EQ(gameState.getTrackMask(), rebuilt().getTrackMask());
+
+  // Placing onto an occupied field rebuilds once the field is freed again
+  gameState.setMarblePosition(1, 1, Position(BoardLocation::TRACK, 40, 1));
+  gameState.setMarblePosition(1, 0, Position(BoardLocation::FINISH, 0, 1));
+  EXPECT_EQ(gameState.hash(), rebuiltHash());
+  EXPECT_EQ(gameState.getTrackMask(), rebuilt().getTrackMask());
+  EXPECT_EQ(gameState.getFinishMask(1), 0b0001);
+}
+
+TEST(Hashing, HandOrderMatters) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState stateA(playerNames);
+  BraendiDog::GameState stateB(playerNames);
+  stateA.getPlayers()[0]->setHand({1, 2});
+  stateB.getPlayers()[0]->setHand({2, 1});
+  EXPECT_NE(stateA.hash(), stateB.hash());
+  stateB.getPlayers()[0]->setHand({1, 2});
+  EXPECT_EQ(stateA.hash(), stateB.hash());
+}
+
+TEST(SevenSplits, TwoFreeMarbles) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.getPlayers()[0]->setHand({6});  // Seven
+  gameState.getPlayers()[0]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 20, 0));
+  gameState.getPlayers()[0]->setMarblePosition(
+      1, Position(BoardLocation::TRACK, 40, 0));
+
+  // 0-7 steps for the first marble, the rest for the second
+  std::vector<Move> splits = gameState.computeSevenSplits(0);
+  ASSERT_EQ(splits.size(), 8u);
+
+  std::set<std::pair<size_t, size_t>> outcomes;
+  for (const Move& split : splits) {
+    EXPECT_EQ(split.getCardID(), 6u);
+    BraendiDog::GameState after = gameState;
+    after.executeMove(split);
+    const Player& player = after.getPlayerByIndex(0).value();
+    size_t first = player.getMarblePosition(0).index;
+    size_t second = player.getMarblePosition(1).index;
+    EXPECT_EQ(first - 20 + second - 40, 7u);
+    outcomes.insert({first, second});
+  }
+  EXPECT_EQ(outcomes.size(), 8u);
+  EXPECT_THROW(gameState.computeSevenSplits(1), std::out_of_range);
+}
+
+TEST(SevenSplits, CapturesAndFinishEntry) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.getPlayers()[0]->setHand({6});
+  gameState.getPlayers()[0]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 61, 0));
+  gameState.getPlayers()[1]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 62, 1));
+
+  std::vector<Move> splits = gameState.computeSevenSplits(0);
+  bool finishEntry = false;
+  bool trackCapture = false;
+  for (const Move& split : splits) {
+    BraendiDog::GameState after = gameState;
+    after.executeMove(split);
+    const Position& own = after.getPlayerByIndex(0)->getMarblePosition(0);
+    const Position& opp = after.getPlayerByIndex(1)->getMarblePosition(0);
+    EXPECT_EQ(opp.boardLocation, BoardLocation::HOME);  // Always passed
+    finishEntry |= own == Position(BoardLocation::FINISH, 3, 0);
+    trackCapture |= own == Position(BoardLocation::TRACK, 4, 0);
+  }
+  EXPECT_TRUE(finishEntry);
+  EXPECT_TRUE(trackCapture);
+  EXPECT_EQ(splits.size(), 2u);
+}
+
+TEST(SevenSplits, BlockedSevenHasNoSplit) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.getPlayers()[0]->setHand({6});
+  gameState.getPlayers()[0]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 12, 0));
+  gameState.getPlayers()[1]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 16, 1));
+  gameState.getPlayers()[1]->setStartBlocked(0);
+
+  EXPECT_TRUE(gameState.computeSevenSplits(0).empty());
+  EXPECT_TRUE(gameState.validSevenFold());
+}
+
+TEST(ServerValidation, TrackOwnerIsIgnored) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.setHand(0, {4});  // Five
+  gameState.setMarblePosition(0, 0, Position(BoardLocation::TRACK, 5, 0));
+
+  // Track fields are shared, the destination may carry any player ID
+  EXPECT_TRUE(gameState.isValidTurn(
+      Move(4, 0, {{{0, 0}, Position(BoardLocation::TRACK, 10, 1)}})));
+  EXPECT_TRUE(gameState.isValidTurn(
+      Move(4, 0, {{{0, 0}, Position(BoardLocation::TRACK, 10, 0)}})));
+}
+
+TEST(ServerValidation, ValidFoldWithIncompleteSeven) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.setHand(0, {6});  // Seven
+  gameState.setMarblePosition(0, 0, Position(BoardLocation::TRACK, 9, 0));
+  gameState.setMarblePosition(0, 1, Position(BoardLocation::FINISH, 2, 0));
+  gameState.setMarblePosition(0, 2, Position(BoardLocation::FINISH, 3, 0));
+  gameState.setMarblePosition(1, 0, Position(BoardLocation::TRACK, 16, 1));
+  gameState.setStartBlocked(1, 0);
+
+  // Six steps to the blocked start, the finish marbles cannot move
+  EXPECT_TRUE(gameState.computeAllLegalMoves().empty());
+  EXPECT_TRUE(gameState.isValidTurn());
+}
+
+TEST(ServerValidation, SevenMovesAreChecked) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.getPlayers()[0]->setHand({6});  // Seven
+  gameState.getPlayers()[0]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 20, 0));
+  gameState.getPlayers()[0]->setMarblePosition(
+      1, Position(BoardLocation::TRACK, 40, 0));
+  LegalMoveSet legalMoves = gameState.buildLegalMoveSet();
+
+  // Parts in either order
+  Move split(6, 0,
+             {{{0, 0}, Position(BoardLocation::TRACK, 23, 0)},
+              {{0, 1}, Position(BoardLocation::TRACK, 44, 0)}});
+  Move reversed(6, 0,
+                {{{0, 1}, Position(BoardLocation::TRACK, 44, 0)},
+                 {{0, 0}, Position(BoardLocation::TRACK, 23, 0)}});
+  EXPECT_TRUE(gameState.isValidTurn(split, legalMoves));
+  EXPECT_TRUE(gameState.isValidTurn(reversed, legalMoves));
+
+  // Only 6 steps used
+  Move shortSplit(6, 0,
+                  {{{0, 0}, Position(BoardLocation::TRACK, 23, 0)},
+                   {{0, 1}, Position(BoardLocation::TRACK, 43, 0)}});
+  EXPECT_FALSE(gameState.isValidTurn(shortSplit, legalMoves));
+
+  // Extra movement of an opponent marble
+  Move extra(6, 0,
+             {{{0, 0}, Position(BoardLocation::TRACK, 27, 0)},
+              {{1, 0}, Position(BoardLocation::TRACK, 30, 1)}});
+  EXPECT_FALSE(gameState.isValidTurn(extra, legalMoves));
+
+  // Set is tied to the state it was built for
+  gameState.executeMove(split);
+  EXPECT_FALSE(gameState.isValidTurn(split, legalMoves));
+}
+
+TEST(ServerValidation, JokerMovesAreChecked) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.getPlayers()[0]->setHand({4, 52});  // Five, Joker
+  gameState.getPlayers()[0]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 5, 0));
+
+  // Joker as Queen, as Seven and as Ace (start)
+  EXPECT_TRUE(gameState.isValidTurn(
+      Move(52, 1, {{{0, 0}, Position(BoardLocation::TRACK, 17, 0)}})));
+  EXPECT_TRUE(gameState.isValidTurn(
+      Move(52, 1, {{{0, 0}, Position(BoardLocation::TRACK, 12, 0)}})));
+  EXPECT_TRUE(gameState.isValidTurn(
+      Move(52, 1, {{{0, 1}, Position(BoardLocation::TRACK, 0, 0)}})));
+
+  // No card walks 14 steps, Joker is not at hand index 0
+  EXPECT_FALSE(gameState.isValidTurn(
+      Move(52, 1, {{{0, 0}, Position(BoardLocation::TRACK, 19, 0)}})));
+  EXPECT_FALSE(gameState.isValidTurn(
+      Move(52, 0, {{{0, 0}, Position(BoardLocation::TRACK, 17, 0)}})));
+
+  // Malformed marble references are rejected
+  EXPECT_FALSE(gameState.isValidTurn(
+      Move(4, 0,
+           {{{0, 0}, Position(BoardLocation::TRACK, 10, 0)},
+            {{2, 0}, Position(BoardLocation::HOME, 0, 2)}})));
+}
+
+TEST(Perft, MatchesCopyMakeWalk) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.getPlayers()[0]->setHand({0, 6, 10, 52});  // A, 7, J, Joker
+  gameState.getPlayers()[1]->setHand({13, 16, 25});      // A, 4, K
+  gameState.getPlayers()[2]->setHand({27, 30});          // 2, 5
+  gameState.getPlayers()[0]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 60, 0));
+  gameState.getPlayers()[1]->setMarblePosition(
+      0, Position(BoardLocation::TRACK, 2, 1));
+  gameState.getPlayers()[2]->setMarblePosition(
+      1, Position(BoardLocation::TRACK, 34, 2));
+
+  // Reference count with state copies and executeMove
+  auto children = [](const BraendiDog::GameState& state) {
+    std::vector<BraendiDog::GameState> result;
+    std::vector<Move> moves = state.computeAllLegalMoves();
+    if (moves.empty()) {
+      moves.emplace_back();
+    }
+    for (const Move& move : moves) {
+      BraendiDog::GameState child = state;
+      if (move.getMovements().empty()) {
+        child.executeFold();
+      } else {
+        child.executeMove(move);
+      }
+      child.endTurn();
+      result.push_back(child);
+    }
+    return result;
+  };
+  uint64_t expected = 0;
+  for (const auto& child : children(gameState)) {
+    expected += children(child).size();
+  }
+
+  uint64_t hashBefore = gameState.hash();
+  PerftResult result = perft(gameState, 2, true);
+  EXPECT_EQ(result.nodes, expected);
+  EXPECT_EQ(result.hashMismatches, 0u);
+  EXPECT_EQ(gameState.hash(), hashBefore);
+  EXPECT_EQ(perft(gameState, 1).nodes,
+            gameState.computeAllLegalMoves().size());
+
+  uint64_t kindTotal = 0;
+  for (uint64_t count : result.kinds) {
+    kindTotal += count;
+  }
+  EXPECT_EQ(kindTotal, result.nodes);
+}
+
+TEST(Perft, VerifyDetectsWrongHash) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  BraendiDog::GameState gameState(playerNames);
+  gameState.setHand(0, {0, 4});   // A, 5
+  gameState.setHand(1, {13, 17});  // A, 5
+  gameState.setMarblePosition(0, 0, Position(BoardLocation::TRACK, 10, 0));
+  EXPECT_EQ(perft(gameState, 2, true).hashMismatches, 0u);
+
+  // Non-const access marks the hash stale, the next query rebuilds it. A
+  // marble moved through the kept reference afterwards bypasses moveMarble
+  auto& player = gameState.getPlayerByIndex(1);
+  EXPECT_EQ(gameState.hash(), gameState.rebuildHash());
+  player->setMarblePosition(0, Position(BoardLocation::TRACK, 40, 1));
+  EXPECT_NE(gameState.hash(), gameState.rebuildHash());
+  EXPECT_GT(perft(gameState, 2, true).hashMismatches, 0u);
+}
+
+TEST(Simulation, PlaysCompleteGames) {
+  BraendiDog::GameSummary summary = BraendiDog::playGame(2, 7);
+  EXPECT_TRUE(summary.finished);
+  EXPECT_GT(summary.rounds, 0u);
+  EXPECT_GE(summary.turns, summary.folds);
+
+  // Exactly one winner among the seated players
+  size_t winners = 0;
+  for (size_t seat = 0; seat < 2; ++seat) {
+    ASSERT_TRUE(summary.leaderBoard[seat].has_value());
+    winners += summary.leaderBoard[seat].value() == 1 ? 1 : 0;
+  }
+  EXPECT_EQ(winners, 1u);
+}
+
+TEST(Simulation, SeededGamesAreReproducible) {
+  BraendiDog::GameSummary first = BraendiDog::playGame(2, 7);
+  BraendiDog::GameSummary second = BraendiDog::playGame(2, 7);
+  EXPECT_EQ(first.turns, second.turns);
+  EXPECT_EQ(first.folds, second.folds);
+  EXPECT_EQ(first.rounds, second.rounds);
+  EXPECT_EQ(first.leaderBoard, second.leaderBoard);
+}
+
+TEST(Ismcts, DeterminizeKeepsHandSizesAndKnownCards) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           "ID3"};
+  BraendiDog::GameState gameState(playerNames, 3);
+  for (const auto& [id, hand] : gameState.dealCards()) {
+    gameState.getPlayerByIndex(id)->setHand(hand);
+  }
+  gameState.getPlayerByIndex(3)->setHand({});  // Folded
+  std::vector<size_t> seen = {52, 53};
+
+  BraendiDog::Xoshiro256 rng(9);
+  for (int sample = 0; sample < 20; ++sample) {
+    BraendiDog::GameState world =
+        BraendiDog::determinize(gameState, 0, seen, rng);
+    EXPECT_EQ(world.getPlayerByIndex(0)->getHand(),
+              gameState.getPlayerByIndex(0)->getHand());
+    EXPECT_TRUE(world.getPlayerByIndex(3)->getHand().empty());
+
+    std::set<size_t> dealt;
+    for (size_t pID = 0; pID < 3; ++pID) {
+      const auto& hand = world.getPlayerByIndex(pID)->getHand();
+      EXPECT_EQ(hand.size(), 6u);
+      dealt.insert(hand.begin(), hand.end());
+    }
+    EXPECT_EQ(dealt.size(), 18u);  // No card twice
+    EXPECT_EQ(dealt.count(52) + dealt.count(53), 0u);
+  }
+}
+
+TEST(Ismcts, SearchPicksLegalMove) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           std::nullopt};
+  BraendiDog::GameState gameState(playerNames, 11);
+  for (const auto& [id, hand] : gameState.dealCards()) {
+    gameState.getPlayerByIndex(id)->setHand(hand);
+  }
+
+  BraendiDog::IsmctsConfig config;
+  config.iterations = 300;
+  config.timeBudget = std::chrono::milliseconds(0);
+  config.threads = 2;
+  config.seed = 5;
+  BraendiDog::Ismcts searcher(config);
+  BraendiDog::IsmctsResult result = searcher.search(gameState);
+
+  EXPECT_EQ(result.iterations, 300u);
+  EXPECT_TRUE(gameState.isValidTurn(result.move));
+  EXPECT_GT(result.visits, 0u);
+  EXPECT_GE(result.value, 0.0);
+  EXPECT_LE(result.value, 1.0);
+
+  // A finished player ranks above the rest
+  gameState.addLeaderBoardFinished(1);
+  std::array<double, 4> rewards = BraendiDog::evaluateState(gameState);
+  EXPECT_DOUBLE_EQ(rewards[1], 1.0);
+  EXPECT_LT(rewards[0], rewards[1]);
+  EXPECT_DOUBLE_EQ(rewards[3], 0.0);  // Empty seat
+
+  EXPECT_THROW(BraendiDog::Ismcts(BraendiDog::IsmctsConfig{
+                   0, std::chrono::milliseconds(0)}),
+               std::invalid_argument);
+}
+
+TEST(PlayerView, TracksHandsFromBroadcasts) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           std::nullopt};
+  BraendiDog::GameState server(playerNames, 13);
+  for (const auto& [id, hand] : server.dealCards()) {
+    server.getPlayerByIndex(id)->setHand(hand);
+  }
+
+  // Broadcasts go over the wire without hands
+  auto broadcast = [&server]() {
+    return nlohmann::json(server).get<BraendiDog::GameState>();
+  };
+  BraendiDog::PlayerView view(0);
+  EXPECT_FALSE(view.applyCardsDealt(server.getPlayerByIndex(0)->getHand()));
+  view.applyGameState(broadcast());
+  EXPECT_TRUE(view.applyCardsDealt(server.getPlayerByIndex(0)->getHand()));
+  EXPECT_TRUE(view.isOwnTurn());
+
+  for (int turn = 0; turn < 3; ++turn) {
+    size_t mover = server.getCurrentPlayer();
+    std::vector<BraendiDog::Move> moves = server.computeAllLegalMoves();
+    BraendiDog::Move move = moves.empty() ? BraendiDog::Move() : moves.front();
+    if (mover == 0) {
+      view.moveSent(move);
+    }
+    if (moves.empty()) {
+      server.executeFold();
+    } else {
+      server.executeMove(move);
+    }
+    server.endTurn();
+    if (mover == 0) {
+      view.turnAccepted(moves.empty());
+    }
+    view.applyGameState(broadcast());
+
+    for (size_t pID = 0; pID < 3; ++pID) {
+      EXPECT_EQ(view.getState()->getPlayerByIndex(pID)->getHand().size(),
+                server.getPlayerByIndex(pID)->getHand().size());
+    }
+  }
+  EXPECT_EQ(view.getState()->getPlayerByIndex(0)->getHand(),
+            server.getPlayerByIndex(0)->getHand());
+  EXPECT_LE(view.getSeenCards().size(), 3u);
+  EXPECT_EQ(view.isOwnTurn(), server.getCurrentPlayer() == 0 &&
+                                 !server.getPlayerByIndex(0)->isHandEmpty());
+}
+
+TEST(DeltaUpdates, ReplayGameFromDeltas) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1", "ID2",
+                                                           "ID3"};
+  BraendiDog::GameState server(playerNames, 21);
+  for (const auto& [id, hand] : server.dealCards()) {
+    server.getPlayerByIndex(id)->setHand(hand);
+  }
+
+  // Everything a client sees of a state (hands and deals stay on the server)
+  auto broadcast = [](const BraendiDog::GameState& state) {
+    nlohmann::json j = state;
+    j.erase("rng");
+    return j;
+  };
+  BraendiDog::GameState client = server;
+  BraendiDog::GameState sent = server;
+  size_t changes = 0;
+
+  for (int turn = 0; turn < 300 && !server.checkGameEnd(); ++turn) {
+    std::vector<BraendiDog::Move> moves = server.computeAllLegalMoves();
+    if (moves.empty()) {
+      server.executeFold();
+    } else {
+      server.executeMove(moves[turn % moves.size()]);
+    }
+    auto [gameEnded, roundEnded] = server.endTurn();
+    if (roundEnded && !gameEnded) {
+      for (const auto& [id, hand] : server.dealCards()) {
+        server.getPlayerByIndex(id)->setHand(hand);
+      }
+    }
+
+    BraendiDog::GameStateDelta delta = server.diff(sent);
+    changes += delta.marbles.size() + delta.players.size();
+    client.applyDelta(delta);
+    sent = server;
+    ASSERT_EQ(broadcast(client), broadcast(server)) << "turn " << turn;
+  }
+  EXPECT_GT(changes, 0u);
+
+  // Nothing changed, nothing but the turn attributes to send
+  BraendiDog::GameStateDelta empty = server.diff(server);
+  EXPECT_TRUE(empty.marbles.empty());
+  EXPECT_TRUE(empty.players.empty());
+  EXPECT_FALSE(empty.leaderBoard.has_value());
+
+  // Invalid deltas are refused without touching the state
+  BraendiDog::GameStateDelta invalid = empty;
+  invalid.marbles.push_back(
+      {0, 4, BraendiDog::Position(BraendiDog::BoardLocation::HOME, 0, 0)});
+  EXPECT_THROW(client.applyDelta(invalid), std::invalid_argument);
+  EXPECT_EQ(broadcast(client), broadcast(server));
+
+  std::array<std::optional<std::string>, 4> twoPlayers = {"ID0", std::nullopt,
+                                                          "ID2", std::nullopt};
+  EXPECT_THROW(server.diff(BraendiDog::GameState(twoPlayers, 21)),
+               std::invalid_argument);
+}
+
+TEST(PlayerView, AppliesDeltasInSequence) {
+  std::array<std::optional<std::string>, 4> playerNames = {"ID0", "ID1",
+                                                           std::nullopt,
+                                                           std::nullopt};
+  BraendiDog::GameState server(playerNames, 8);
+  BraendiDog::GameState sent = server;
+  BraendiDog::PlayerView view(1);
+
+  // Deltas need a full state first
+  EXPECT_FALSE(view.applyGameStateDelta(server.diff(sent), 1));
+  view.applyGameState(server, 1);
+
+  server.setCurrentPlayer(1);
+  BraendiDog::GameStateDelta delta = server.diff(sent);
+  EXPECT_FALSE(view.applyGameStateDelta(delta, 3));  // Missed update 2
+  EXPECT_EQ(view.getState()->getCurrentPlayer(), 0u);
+  EXPECT_TRUE(view.applyGameStateDelta(delta, 2));
+  EXPECT_EQ(view.getState()->getCurrentPlayer(), 1u);
+  EXPECT_FALSE(view.applyGameStateDelta(delta, 2));  // Already applied
+}
@@ -503,11 +503,18 @@
 // }
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
 #include <nlohmann/json.hpp>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #include "shared/game.hpp"
 #include "shared/game_objects.hpp"
 #include "shared/game_types.hpp"
+#include "shared/logging.hpp"
+#include "shared/transposition_table.hpp"
 
 using namespace BraendiDog;
 
@@ -678,6 +685,29 @@ TEST(CardTest, JsonSerialization) {
   }
 }
 
+// Test Card rule table and legacy JSON
+TEST(CardTest, StaticRuleTable) {
+  // Rules live in static storage shared by all cards of a rank
+  Card king(Rank::KING, Suit::CLUBS);
+  Card otherKing(Rank::KING, Suit::HEARTS);
+  EXPECT_EQ(king.getMoveRules().data(), otherKing.getMoveRules().data());
+  ASSERT_EQ(king.getMoveRules().size(), 2);
+  EXPECT_EQ(king.getMoveRules()[1].first, MoveType::START);
+
+  static_assert(CardRules::forRank(Rank::FOUR)[1].second == -4);
+  EXPECT_EQ(Card(Rank::JOKER, Suit::JOKER).getMoveRules()[0].first,
+            MoveType::JOKER);
+  EXPECT_THROW(Card(static_cast<Rank>(14), Suit::CLUBS), std::invalid_argument);
+
+  // Rules are no longer serialized, old payloads still parse
+  nlohmann::json json = king;
+  EXPECT_FALSE(json.contains("moveRules"));
+  json["moveRules"] = nlohmann::json::array({{{"type", 0}, {"value", 99}}});
+  Card restored = json.get<Card>();
+  EXPECT_EQ(restored, king);
+  EXPECT_EQ(restored.getMoveRules()[0].second, 13);
+}
+
 // Test Player creation, getters and setters
 TEST(PlayerTest, CreateAndGettersSetters) {
   size_t playerID = 1;
@@ -992,3 +1022,237 @@ TEST(PlayerTest, JsonSerializationWithStartUnblocked) {
   EXPECT_FALSE(restoredPlayer.isStartBlocked());
   EXPECT_FALSE(restoredPlayer.getStartBlocked().has_value());
 }
+
+// Test TranspositionTable legal move caching
+TEST(TranspositionTableTest, CachesLegalMoves) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  GameState gameState(playerNames);
+  gameState.getPlayers()[0]->setHand({0, 12, 52});  // A, K, Joker
+
+  TranspositionTable table(1 << 16);
+  auto first = table.legalMoves(gameState);
+  EXPECT_EQ(table.misses(), 1u);
+  auto second = table.legalMoves(gameState);
+  EXPECT_EQ(table.hits(), 1u);
+  EXPECT_EQ(first, second);  // Same cached list
+
+  // Cached result matches a fresh computation
+  std::vector<Move> expected = gameState.computeLegalMoves();
+  ASSERT_EQ(first->size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ((*first)[i].getCardID(), expected[i].getCardID());
+    EXPECT_EQ((*first)[i].getHandIndex(), expected[i].getHandIndex());
+  }
+
+  // Joker rank expansion is cached under its own key
+  auto joker = table.legalMoves(gameState, std::array<size_t, 3>{0, 2, 52});
+  EXPECT_NE(joker, first);
+  EXPECT_EQ(table.misses(), 2u);
+
+  // A different hand misses
+  gameState.getPlayers()[0]->setHand({0, 12});
+  table.legalMoves(gameState);
+  EXPECT_EQ(table.misses(), 3u);
+}
+
+// Test that all legal plays are cached regardless of the hidden hands
+TEST(TranspositionTableTest, AllLegalMovesIgnoreHiddenHands) {
+  std::array<std::optional<std::string>, 4> playerNames = {
+      "ID0", "ID1", std::nullopt, std::nullopt};
+  GameState gameState(playerNames);
+  gameState.setHand(0, {0, 6, 52});  // A, 7, Joker
+  gameState.setHand(1, {1, 2});
+
+  TranspositionTable table(1 << 16);
+  auto first = table.allLegalMoves(gameState);
+  EXPECT_EQ(first->size(), gameState.computeAllLegalMoves().size());
+  EXPECT_NE(first, table.legalMoves(gameState));  // Separate keys
+  EXPECT_EQ(table.misses(), 2u);
+
+  // Another determinization of the opponent's hand hits
+  uint64_t moveHash = gameState.moveHash();
+  gameState.setHand(1, {3, 4});
+  EXPECT_EQ(gameState.moveHash(), moveHash);
+  EXPECT_EQ(table.allLegalMoves(gameState), first);
+  EXPECT_EQ(table.hits(), 1u);
+
+  // The current player's hand does not
+  gameState.setHand(0, {0, 6});
+  EXPECT_NE(table.allLegalMoves(gameState), first);
+  EXPECT_EQ(table.misses(), 3u);
+}
+
+// Test TranspositionTable evaluation replacement
+TEST(TranspositionTableTest, DepthPreferredEvaluations) {
+  TranspositionTable table(1 << 12);
+  EXPECT_FALSE(table.probe(42).has_value());
+
+  table.store(42, {0.5, 4, 100});
+  table.store(42 + table.evalCapacity(), {0.1, 2, 10});  // Same bucket
+  auto eval = table.probe(42);
+  ASSERT_TRUE(eval.has_value());
+  EXPECT_EQ(eval->depth, 4);
+
+  // Older generations are replaced regardless of depth
+  table.newGeneration();
+  table.store(42 + table.evalCapacity(), {0.1, 2, 10});
+  EXPECT_FALSE(table.probe(42).has_value());
+  EXPECT_EQ(table.probe(42 + table.evalCapacity())->visits, 10u);
+
+  table.clear();
+  EXPECT_FALSE(table.probe(42 + table.evalCapacity()).has_value());
+}
+
+// Test TranspositionTable LRU eviction of legal move lists
+TEST(TranspositionTableTest, LruEviction) {
+  TranspositionTable table(0);  // Minimum size: one bucket of two slots
+  ASSERT_EQ(table.moveCapacity(), 2u);
+  auto moves = std::make_shared<const std::vector<Move>>();
+
+  table.storeLegalMoves(1, moves);
+  table.storeLegalMoves(2, moves);
+  EXPECT_NE(table.findLegalMoves(1), nullptr);  // 2 is now least recent
+  table.storeLegalMoves(3, moves);
+  EXPECT_NE(table.findLegalMoves(1), nullptr);
+  EXPECT_EQ(table.findLegalMoves(2), nullptr);
+  EXPECT_NE(table.findLegalMoves(3), nullptr);
+}
+
+// Test log level parsing and lazy argument formatting
+TEST(LoggingTest, LevelsAndLazyFormatting) {
+  EXPECT_EQ(Log::parseLevel("debug"), Log::Level::DEBUG);
+  EXPECT_EQ(Log::parseLevel("WARN"), Log::Level::WARN);
+  EXPECT_FALSE(Log::parseLevel("verbose").has_value());
+
+  Log::Level previous = Log::getLevel();
+  Log::setLevel(Log::Level::WARN);
+  int formatted = 0;
+  auto expensive = [&formatted]() {
+    ++formatted;
+    return "value";
+  };
+  BD_LOG_DEBUG("Test", "Disabled " << expensive());
+  EXPECT_EQ(formatted, 0);
+  EXPECT_FALSE(Log::enabled(Log::Level::INFO));
+  EXPECT_TRUE(Log::enabled(Log::Level::ERR));
+
+  Log::setLevel(Log::Level::OFF);
+  BD_LOG_ERROR("Test", "Disabled " << expensive());
+  EXPECT_EQ(formatted, 0);
+  Log::setLevel(previous);
+}
+
+// Test that asynchronous lines reach a binary sink tagged and in order, and
+// that a tag drops the lines over its rate limit but never errors
+TEST(LoggingTest, AsyncBinarySinkWithTagsAndRateLimit) {
+  const auto path =
+      std::filesystem::temp_directory_path() / "braendi_log_test.bin";
+  std::filesystem::remove(path);
+  Log::Level previous = Log::getLevel();
+  Log::setLevel(Log::Level::INFO);
+
+  Log::AsyncOptions options;
+  options.path = path.string();
+  options.format = Log::Format::BINARY;
+  Log::startAsync(options);
+  const size_t droppedBefore = Log::droppedLines();
+  BD_LOG_WARN("Test", "Untagged");
+  {
+    Log::Tag room("room 7", 2);
+    Log::ScopedTag scope(room);
+    for (int i = 0; i < 5; ++i) {
+      BD_LOG_INFO("Test", "Line " << i);
+    }
+    BD_LOG_ERROR("Test", "Failure");
+  }
+  Log::stopAsync();
+  Log::setLevel(previous);
+
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream data;
+  data << file.rdbuf();
+  file.close();
+  std::filesystem::remove(path);
+  const std::vector<Log::Record> records = Log::readBinary(data.str());
+
+  // The tag's budget may straddle a second, at most both budgets are used
+  ASSERT_GE(records.size(), 4u);
+  ASSERT_LE(records.size(), 6u);
+  EXPECT_EQ(records.front().level, Log::Level::WARN);
+  EXPECT_EQ(records.front().component, "Test");
+  EXPECT_TRUE(records.front().tag.empty());
+  EXPECT_EQ(records.front().message, "Untagged");
+  EXPECT_EQ(records[1].tag, "room 7");
+  EXPECT_EQ(records[1].message, "Line 0");
+  EXPECT_EQ(records.back().level, Log::Level::ERR);
+  EXPECT_EQ(records.back().tag, "room 7");
+  EXPECT_EQ(records.back().message, "Failure");
+  EXPECT_EQ(Log::droppedLines() - droppedBefore, 7 - records.size());
+
+  EXPECT_THROW(Log::readBinary(data.str().substr(0, data.str().size() - 1)),
+               std::runtime_error);
+}
+
+// Test that lines logged while the asynchronous log stops are written to the
+// file, written synchronously afterwards or counted as dropped
+TEST(LoggingTest, AsyncStopLosesNoLinesSilently) {
+  const auto path =
+      std::filesystem::temp_directory_path() / "braendi_log_stop_test.bin";
+  std::filesystem::remove(path);
+  Log::Level previous = Log::getLevel();
+  Log::setLevel(Log::Level::INFO);
+  std::stringstream synchronous;
+  std::streambuf* clogBuffer = std::clog.rdbuf(synchronous.rdbuf());
+
+  Log::AsyncOptions options;
+  options.path = path.string();
+  options.format = Log::Format::BINARY;
+  Log::startAsync(options);
+  const size_t droppedBefore = Log::droppedLines();
+  constexpr size_t threadCount = 4;
+  constexpr size_t linesPerThread = 2000;
+  std::vector<std::thread> producers;
+  for (size_t t = 0; t < threadCount; ++t) {
+    producers.emplace_back([]() {
+      for (size_t i = 0; i < linesPerThread; ++i) {
+        BD_LOG_WARN("Test", "Line " << i);
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  Log::stopAsync();
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  std::clog.rdbuf(clogBuffer);
+  Log::setLevel(previous);
+
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream data;
+  data << file.rdbuf();
+  file.close();
+  std::filesystem::remove(path);
+  size_t written = 0;
+  for (const Log::Record& record : Log::readBinary(data.str())) {
+    written += record.component == "Test";
+  }
+  std::string line;
+  while (std::getline(synchronous, line)) {
+    written += line.find("[Test]") != std::string::npos;
+  }
+  EXPECT_EQ(written + Log::droppedLines() - droppedBefore,
+            threadCount * linesPerThread);
+}
+
+// Test the text sink line format
+TEST(LoggingTest, TextFormat) {
+  Log::Record record{std::chrono::system_clock::time_point(
+                         std::chrono::milliseconds(1500)),
+                     Log::Level::INFO, "Server", "room 3", "Player 1 joined"};
+  EXPECT_EQ(Log::formatText(record),
+            "1970-01-01T00:00:01.500Z [INFO][Server][room 3] Player 1 joined");
+  record.tag.clear();
+  EXPECT_EQ(Log::formatText(record),
+            "1970-01-01T00:00:01.500Z [INFO][Server] Player 1 joined");
+}
@@ -308,7 +308,9 @@
 
 #include <nlohmann/json.hpp>
 
+#include "shared/framing.hpp"
 #include "shared/messages.hpp"
+#include "shared/wire_format.hpp"
 
 class MessageTest : public ::testing::Test {};
 
@@ -480,6 +482,17 @@ TEST_F(MessageTest, GameStartMessage) {
 //   EXPECT_NE(dynamic_cast<GameStateUpdateMessage*>(parsed.get()), nullptr);
 // }
 
+TEST_F(MessageTest, GameStateUpdateOmitsDealGenerator) {
+  BraendiDog::GameState state({"A", "B", std::nullopt, std::nullopt}, 5);
+  GameStateUpdateMessage msg(state);
+  nlohmann::json j = msg.toJson();
+  EXPECT_EQ(j["msgType"], "BRDC_GAMESTATE_UPDATE");
+  EXPECT_FALSE(j["gameState"].contains("rng"));
+
+  auto parsed = Message::fromJson(j);
+  ASSERT_NE(dynamic_cast<GameStateUpdateMessage*>(parsed.get()), nullptr);
+}
+
 TEST_F(MessageTest, PlayerDisconnectedMessage) {
   PlayerDisconnectedMessage msg(1);
   nlohmann::json j = msg.toJson();
@@ -538,3 +551,254 @@ TEST_F(MessageTest, PlayerDisconnectedMessage) {
 //   ASSERT_NE(m, nullptr);
 //   EXPECT_EQ(m->cards.size(), 3);
 // }
+
+// -----------------------------------------------------------------------------
+// ROOM MANAGEMENT MESSAGES
+// -----------------------------------------------------------------------------
+
+TEST_F(MessageTest, JoinRoomRequestMessage) {
+  JoinRoomRequestMessage msg("Sophie", 7);
+  nlohmann::json j = msg.toJson();
+  EXPECT_EQ(j["msgType"], "REQ_JOIN_ROOM");
+  EXPECT_EQ(j["roomId"], 7);
+
+  auto parsed = Message::fromJson(j);
+  EXPECT_EQ(parsed->getMessageType(), MessageType::REQ_JOIN_ROOM);
+  auto* m = dynamic_cast<JoinRoomRequestMessage*>(parsed.get());
+  ASSERT_NE(m, nullptr);
+  EXPECT_EQ(m->name, "Sophie");
+  EXPECT_EQ(m->roomId, 7);
+}
+
+TEST_F(MessageTest, ListRoomsResponseMessage) {
+  ListRoomsResponseMessage msg({{3, "Room 3", 2, false}, {5, "Fast", 4, true}});
+  nlohmann::json j = msg.toJson();
+  EXPECT_EQ(j["msgType"], "RESP_LIST_ROOMS");
+  EXPECT_EQ(j["rooms"].size(), 2);
+
+  auto parsed = Message::fromJson(j);
+  EXPECT_EQ(parsed->getMessageType(), MessageType::RESP_LIST_ROOMS);
+  auto* m = dynamic_cast<ListRoomsResponseMessage*>(parsed.get());
+  ASSERT_NE(m, nullptr);
+  ASSERT_EQ(m->rooms.size(), 2);
+  EXPECT_EQ(m->rooms[1].name, "Fast");
+  EXPECT_TRUE(m->rooms[1].inGame);
+}
+
+TEST_F(MessageTest, CreateRoomResponseMessage) {
+  CreateRoomResponseMessage msg(true, "", 4, 0);
+  nlohmann::json j = msg.toJson();
+  EXPECT_EQ(j["msgType"], "RESP_CREATE_ROOM");
+  EXPECT_TRUE(j["success_"]);
+
+  auto parsed = Message::fromJson(j);
+  EXPECT_EQ(parsed->getMessageType(), MessageType::RESP_CREATE_ROOM);
+  auto* m = dynamic_cast<CreateRoomResponseMessage*>(parsed.get());
+  ASSERT_NE(m, nullptr);
+  EXPECT_EQ(m->roomId, 4);
+  EXPECT_EQ(m->playerId, 0);
+}
+
+// -----------------------------------------------------------------------------
+// FRAMING
+// -----------------------------------------------------------------------------
+
+TEST_F(MessageTest, FramesSplitAndCoalesced) {
+  std::string big(5000, 'x');  // Larger than one read
+  std::string stream = BraendiDog::encodeFrame("{\"a\":1}") +
+                       BraendiDog::encodeFrame(big) +
+                       BraendiDog::encodeFrame("");
+  EXPECT_EQ(stream.substr(0, 4), std::string("\0\0\0\x07", 4));
+
+  // Feed the stream in uneven pieces
+  BraendiDog::FrameBuffer buffer(16);
+  std::vector<std::string> frames;
+  for (size_t pos = 0; pos < stream.size(); pos += 7) {
+    buffer.append(std::string_view(stream).substr(pos, 7));
+    while (auto frame = buffer.next()) {
+      frames.emplace_back(*frame);
+    }
+  }
+  ASSERT_EQ(frames.size(), 3);
+  EXPECT_EQ(frames[0], "{\"a\":1}");
+  EXPECT_EQ(frames[1], big);
+  EXPECT_EQ(frames[2], "");
+  EXPECT_EQ(buffer.size(), 0);
+}
+
+TEST_F(MessageTest, FrameBufferIsReused) {
+  BraendiDog::FrameBuffer buffer(64);
+  std::string frame = BraendiDog::encodeFrame(std::string(40, 'y'));
+  for (int i = 0; i < 100; ++i) {
+    auto space = buffer.prepare(frame.size());
+    std::copy(frame.begin(), frame.end(), space.begin());
+    buffer.commit(frame.size());
+    auto payload = buffer.next();
+    ASSERT_TRUE(payload.has_value());
+    EXPECT_EQ(payload->size(), 40);
+  }
+  EXPECT_EQ(buffer.capacity(), 64);  // Consumed frames free their space
+}
+
+TEST_F(MessageTest, OversizedFrameRejected) {
+  BraendiDog::FrameBuffer buffer;
+  buffer.append(std::string("\x7f\0\0\0", 4));
+  EXPECT_THROW(buffer.next(), BraendiDog::FramingError);
+  EXPECT_THROW(BraendiDog::encodeFrame(
+                   std::string(BraendiDog::maxFrameSize + 1, 'z')),
+               BraendiDog::FramingError);
+}
+
+// -----------------------------------------------------------------------------
+// WIRE FORMATS
+// -----------------------------------------------------------------------------
+
+namespace {
+std::unique_ptr<Message> binaryRoundTrip(const Message& msg) {
+  return BraendiDog::decodeMessage(
+      BraendiDog::encodeMessage(msg, BraendiDog::WireFormat::BINARY_V1));
+}
+}  // namespace
+
+TEST_F(MessageTest, BinaryGameStateRoundTrip) {
+  // Play into the game, so marbles are spread over the board
+  BraendiDog::GameState state({"A", "B", "C", std::nullopt}, 11);
+  for (const auto& [id, hand] : state.dealCards()) {
+    state.getPlayerByIndex(id)->setHand(hand);
+  }
+  for (int turn = 0; turn < 12; ++turn) {
+    auto moves = state.computeAllLegalMoves();
+    if (moves.empty()) {
+      state.executeFold();
+    } else {
+      state.executeMove(moves.back());
+    }
+    state.endTurn();
+  }
+  GameStateUpdateMessage msg(state);
+
+  std::string binary =
+      BraendiDog::encodeMessage(msg, BraendiDog::WireFormat::BINARY_V1);
+  std::string json =
+      BraendiDog::encodeMessage(msg, BraendiDog::WireFormat::JSON);
+  EXPECT_LT(binary.size() * 10, json.size());
+
+  auto parsed = BraendiDog::decodeMessage(binary);
+  ASSERT_EQ(parsed->getMessageType(), MessageType::BRDC_GAMESTATE_UPDATE);
+  EXPECT_EQ(parsed->toJson(), msg.toJson());
+}
+
+TEST_F(MessageTest, BinaryMessagesRoundTrip) {
+  BraendiDog::Move move(
+      7, 2,
+      {{BraendiDog::MarbleIdentifier(1, 3),
+        BraendiDog::Position(BraendiDog::BoardLocation::TRACK, 63, 1)},
+       {BraendiDog::MarbleIdentifier(2, 0),
+        BraendiDog::Position(BraendiDog::BoardLocation::HOME, 0, 2)}});
+  std::vector<std::unique_ptr<Message>> messages;
+  messages.push_back(std::make_unique<ConnectionRequestMessage>("Zoë", 1));
+  messages.push_back(std::make_unique<PlayCardRequestMessage>(1, move));
+  messages.push_back(std::make_unique<ConnectionResponseMessage>(
+      false, "Room is full", 0, 1));
+  messages.push_back(std::make_unique<PlayerListUpdateMessage>(
+      std::vector<PlayerInfo>{{0, "A", true}, {3, "D", false}}));
+  messages.push_back(std::make_unique<GameResultsMessage>(
+      std::array<std::optional<int>, 4>{2, std::nullopt, 0, -1}));
+  messages.push_back(std::make_unique<CardsDealtMessage>(
+      2, std::vector<size_t>{0, 53, 200}));
+  messages.push_back(std::make_unique<ListRoomsResponseMessage>(
+      std::vector<RoomInfo>{{3, "Room 3", 2, false}}));
+  messages.push_back(
+      std::make_unique<JoinRoomResponseMessage>(true, "", 9, 2, 1));
+
+  for (const auto& msg : messages) {
+    auto parsed = binaryRoundTrip(*msg);
+    EXPECT_EQ(parsed->toJson(), msg->toJson());
+  }
+}
+
+TEST_F(MessageTest, GameStateDeltaRoundTrip) {
+  BraendiDog::GameState state({"A", "B", std::nullopt, "D"}, 4);
+  BraendiDog::GameState previous = state;
+  state.getPlayerByIndex(3)->setMarblePosition(
+      1, BraendiDog::Position(BraendiDog::BoardLocation::TRACK, 48, 3));
+  state.getPlayerByIndex(3)->setStartBlocked(1);
+  state.getPlayerByIndex(1)->setActiveInRound(false);
+  state.setLastPlayedCard(17);
+  state.addLeaderBoardFinished(0);
+
+  GameStateDeltaMessage delta(42, state.diff(previous));
+  ASSERT_EQ(delta.delta.marbles.size(), 1u);
+  ASSERT_EQ(delta.delta.players.size(), 2u);
+  ASSERT_TRUE(delta.delta.leaderBoard.has_value());
+
+  // Both encodings carry the same delta
+  for (auto format :
+       {BraendiDog::WireFormat::JSON, BraendiDog::WireFormat::BINARY_V1}) {
+    auto parsed =
+        BraendiDog::decodeMessage(BraendiDog::encodeMessage(delta, format));
+    ASSERT_EQ(parsed->getMessageType(), MessageType::BRDC_GAMESTATE_DELTA);
+    EXPECT_EQ(parsed->toJson(), delta.toJson());
+  }
+
+  // A turn costs a few bytes instead of the full state
+  std::string binary =
+      BraendiDog::encodeMessage(delta, BraendiDog::WireFormat::BINARY_V1);
+  std::string full = BraendiDog::encodeMessage(
+      GameStateUpdateMessage(state, 42), BraendiDog::WireFormat::BINARY_V1);
+  EXPECT_LT(binary.size() * 4, full.size());
+
+  auto request = binaryRoundTrip(GameStateRequestMessage(3));
+  ASSERT_EQ(request->getMessageType(), MessageType::REQ_GAMESTATE);
+  EXPECT_EQ(static_cast<ClientRequest&>(*request).getPlayerId(), 3u);
+  auto update = binaryRoundTrip(GameStateUpdateMessage(state, 42));
+  EXPECT_EQ(static_cast<GameStateUpdateMessage&>(*update).sequence, 42u);
+}
+
+TEST_F(MessageTest, WireFormatNegotiation) {
+  // Clients that predate the binary format send no wireFormat
+  auto parsed = BraendiDog::decodeMessage(
+      R"({"msgType":"REQ_CONNECT","name":"Old"})");
+  auto* request = dynamic_cast<ConnectionRequestMessage*>(parsed.get());
+  ASSERT_NE(request, nullptr);
+  EXPECT_EQ(request->wireFormat, 0);
+
+  EXPECT_EQ(BraendiDog::negotiateWireFormat(0), BraendiDog::WireFormat::JSON);
+  EXPECT_EQ(BraendiDog::negotiateWireFormat(1),
+            BraendiDog::WireFormat::BINARY_V1);
+  EXPECT_EQ(BraendiDog::negotiateWireFormat(7),
+            BraendiDog::latestWireFormat);
+}
+
+TEST_F(MessageTest, MalformedBinaryRejected) {
+  std::string binary = BraendiDog::encodeMessage(
+      ReadyMessage(2), BraendiDog::WireFormat::BINARY_V1);
+  EXPECT_THROW(BraendiDog::decodeMessage(binary + "x"),
+               BraendiDog::WireError);
+  EXPECT_THROW(BraendiDog::decodeMessage(binary.substr(0, 2)),
+               BraendiDog::WireError);
+  EXPECT_THROW(BraendiDog::decodeMessage(std::string("\xB1\x7F", 2)),
+               BraendiDog::WireError);
+  EXPECT_THROW(BraendiDog::decodeMessage(std::string("\xB9\x00", 2)),
+               BraendiDog::WireError);
+}
+
+TEST_F(MessageTest, MessageFrameEncodedInPlace) {
+  PlayerDisconnectedMessage msg(3);
+  for (auto format :
+       {BraendiDog::WireFormat::JSON, BraendiDog::WireFormat::BINARY_V1}) {
+    std::string frame = BraendiDog::encodeMessageFrame(msg, format);
+    EXPECT_EQ(frame, BraendiDog::encodeFrame(
+                         BraendiDog::encodeMessage(msg, format)));
+
+    BraendiDog::FrameBuffer buffer;
+    buffer.append(frame);
+    auto payload = buffer.next();
+    ASSERT_TRUE(payload.has_value());
+    auto parsed = BraendiDog::decodeMessage(*payload);
+    auto* disconnected =
+        dynamic_cast<PlayerDisconnectedMessage*>(parsed.get());
+    ASSERT_NE(disconnected, nullptr);
+    EXPECT_EQ(disconnected->playerId, 3);
+  }
+}
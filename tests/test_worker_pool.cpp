@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "server/worker_pool.hpp"
+#include "shared/logging.hpp"
+
+using namespace BraendiDog;
+
+namespace {
+constexpr auto timeout = std::chrono::seconds(10);
+
+// Posts a task behind everything queued on the strand and waits for it
+bool waitForStrand(Strand& strand) {
+  auto done = std::make_shared<std::promise<void>>();
+  auto future = done->get_future();
+  strand.post([done]() { done->set_value(); });
+  return future.wait_for(timeout) == std::future_status::ready;
+}
+}  // namespace
+
+// Test that tasks posted from several threads run one at a time, in the
+// order each thread posted them
+TEST(StrandTest, RunsTasksSeriallyInOrder) {
+  constexpr int producers = 4;
+  constexpr int tasksPerProducer = 2000;
+  WorkerPool pool(4);
+  auto strand = std::make_shared<Strand>(pool);
+
+  std::atomic<bool> running{false};
+  std::atomic<int> overlaps{0};
+  std::vector<int> order;  // Only touched by strand tasks
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      for (int i = 0; i < tasksPerProducer; ++i) {
+        strand->post([&, p, i]() {
+          if (running.exchange(true)) {
+            ++overlaps;
+          }
+          order.push_back(p * tasksPerProducer + i);
+          running = false;
+        });
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(waitForStrand(*strand));
+
+  EXPECT_EQ(overlaps, 0);
+  ASSERT_EQ(order.size(), static_cast<size_t>(producers * tasksPerProducer));
+  std::vector<int> last(producers, -1);
+  for (int task : order) {
+    const int producer = task / tasksPerProducer;
+    EXPECT_GT(task % tasksPerProducer, last[producer]);
+    last[producer] = task % tasksPerProducer;
+  }
+}
+
+// Test that a failing task is logged and the strand goes on with the next
+TEST(StrandTest, FailingTaskDoesNotStall) {
+  Log::Level level = Log::getLevel();
+  Log::setLevel(Log::Level::ERR);
+  std::ostringstream captured;
+  std::streambuf* previous = std::clog.rdbuf(captured.rdbuf());
+  {
+    WorkerPool pool(2);
+    auto strand = std::make_shared<Strand>(pool);
+    int ran = 0;
+    strand->post([]() { throw std::runtime_error("broken task"); });
+    strand->post([&ran]() { ++ran; });
+    EXPECT_TRUE(waitForStrand(*strand));
+    EXPECT_EQ(ran, 1);
+  }
+  std::clog.rdbuf(previous);
+  Log::setLevel(level);
+  EXPECT_NE(captured.str().find("Task failed: broken task"), std::string::npos);
+}
+
+// Test the percentile bound read from the wait histogram
+TEST(WorkerPoolTest, WaitPercentile) {
+  WorkerPool::Stats stats;
+  EXPECT_EQ(stats.waitPercentile(0.99), std::chrono::microseconds(0));
+
+  stats.waitBuckets[3] = 90;   // Below 8us
+  stats.waitBuckets[10] = 10;  // Below 1024us
+  EXPECT_EQ(stats.waitPercentile(0.5), std::chrono::microseconds(8));
+  EXPECT_EQ(stats.waitPercentile(0.9), std::chrono::microseconds(8));
+  EXPECT_EQ(stats.waitPercentile(0.99), std::chrono::microseconds(1024));
+}
+
+// Test that an idle strand is resubmitted to the worker that ran it last;
+// it only moves when another worker steals it
+TEST(WorkerPoolTest, StrandKeepsItsWorker) {
+  constexpr int rounds = 100;
+  WorkerPool pool(4);
+  auto strand = std::make_shared<Strand>(pool);
+
+  std::vector<size_t> workers;
+  for (int i = 0; i < rounds; ++i) {
+    auto done = std::make_shared<std::promise<size_t>>();
+    auto future = done->get_future();
+    strand->post([&pool, done]() { done->set_value(pool.currentWorker()); });
+    ASSERT_EQ(future.wait_for(timeout), std::future_status::ready);
+    workers.push_back(future.get());
+  }
+
+  size_t moves = 0;
+  for (size_t i = 1; i < workers.size(); ++i) {
+    ASSERT_LT(workers[i], pool.getNumThreads());
+    moves += workers[i] != workers[i - 1] ? 1 : 0;
+  }
+  pool.stop();  // Counters are updated after a task returns
+  size_t stolen = 0;
+  for (const auto& stats : pool.getStats()) {
+    stolen += stats.stolen;
+  }
+  EXPECT_LE(moves, stolen);
+  EXPECT_LT(moves, static_cast<size_t>(rounds / 2));
+}
+
+// Test that a task queued behind a blocked worker is stolen by an idle one
+TEST(WorkerPoolTest, IdleWorkerStealsFromBlockedOne) {
+  WorkerPool pool(2);
+  std::promise<size_t> started;
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  pool.submit([&pool, &started, released]() {
+    started.set_value(pool.currentWorker());
+    released.wait();
+  });
+  auto startedFuture = started.get_future();
+  ASSERT_EQ(startedFuture.wait_for(timeout), std::future_status::ready);
+  const size_t blocked = startedFuture.get();
+
+  std::promise<size_t> ran;
+  auto ranFuture = ran.get_future();
+  pool.submit([&pool, &ran]() { ran.set_value(pool.currentWorker()); },
+              blocked);
+  const bool stolen =
+      ranFuture.wait_for(timeout) == std::future_status::ready;
+  release.set_value();
+  ASSERT_TRUE(stolen);
+  EXPECT_NE(ranFuture.get(), blocked);
+
+  pool.stop();
+  const auto stats = pool.getStats();
+  EXPECT_GE(stats[1 - blocked].stolen, 1u);
+  EXPECT_EQ(stats[blocked].stolen, 0u);
+}